@@ -309,6 +309,36 @@ int msg_receive(msg_t *m);
  */
 int msg_try_receive(msg_t *m);
 
+/**
+ * @brief Receive all currently available messages at once.
+ *
+ * Moves up to @p max messages from the message queue and from blocked
+ * senders to @p out in a single critical section, in the order
+ * msg_receive() would have returned them. This function blocks until at
+ * least one message was received.
+ *
+ * @param[out] out  Pointer to preallocated array of @p max ``msg_t``
+ *                  structures, must not be NULL.
+ * @param[in] max   Maximum number of messages to receive, must be > 0.
+ *
+ * @return  Number of messages received (>= 1).
+ */
+int msg_receive_batch(msg_t *out, unsigned max);
+
+/**
+ * @brief Try to receive all currently available messages at once.
+ *
+ * Like msg_receive_batch(), but does not block if no message can be
+ * received.
+ *
+ * @param[out] out  Pointer to preallocated array of @p max ``msg_t``
+ *                  structures, must not be NULL.
+ * @param[in] max   Maximum number of messages to receive, must be > 0.
+ *
+ * @return  Number of messages received, 0 if there were none.
+ */
+int msg_try_receive_batch(msg_t *out, unsigned max);
+
 /**
  * @brief Send a message, block until reply received.
  *
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     core_sync
+ * @brief       Priority inheriting mutex for thread synchronization
+ *
+ * A thread blocking on a locked @ref mutex_pi_t lends its priority to the
+ * owner of the mutex until the owner has released all priority inheriting
+ * mutexes it holds. This bounds the time a high priority thread waits for a
+ * lower priority owner to the time the owner holds the mutex, independent of
+ * threads with priorities in between.
+ *
+ * Inheritance is not transitive: if the owner itself waits for another
+ * mutex, the owner of that mutex is not boosted.
+ *
+ * Requires module `core_mutex_pi`.
+ *
+ * @{
+ *
+ * @file
+ * @brief       RIOT priority inheriting synchronization API
+ */
+
+#ifndef MUTEX_PI_H
+#define MUTEX_PI_H
+
+#include <stdint.h>
+
+#include "mutex.h"
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @brief Priority inheriting mutex structure. Must never be modified by the
+ *        user.
+ */
+typedef struct {
+    /**
+     * @brief   The mutex used for locking. **Must never be changed by the
+     *          user.**
+     * @internal
+     */
+    mutex_t mutex;
+    /**
+     * @brief   Owner thread of the mutex.
+     * @internal
+     */
+    volatile kernel_pid_t owner;
+} mutex_pi_t;
+
+/**
+ * @brief Static initializer for mutex_pi_t.
+ */
+#define MUTEX_PI_INIT { MUTEX_INIT, KERNEL_PID_UNDEF }
+
+/**
+ * @brief Recursive priority inheriting mutex structure. Must never be
+ *        modified by the user.
+ */
+typedef struct {
+    /**
+     * @brief   The mutex used for locking. **Must never be changed by the
+     *          user.**
+     * @internal
+     */
+    mutex_pi_t mutex;
+    /**
+     * @brief   Number of locks owned by the thread owner
+     * @internal
+     */
+    uint16_t refcount;
+} rmutex_pi_t;
+
+/**
+ * @brief Static initializer for rmutex_pi_t.
+ */
+#define RMUTEX_PI_INIT { MUTEX_PI_INIT, 0 }
+
+/**
+ * @brief Initializes a priority inheriting mutex object.
+ *
+ * @param[out] mutex    pre-allocated mutex structure, must not be NULL.
+ */
+static inline void mutex_pi_init(mutex_pi_t *mutex)
+{
+    mutex_pi_t empty_mutex = MUTEX_PI_INIT;
+    *mutex = empty_mutex;
+}
+
+/**
+ * @brief Tries to get a priority inheriting mutex, non-blocking.
+ *
+ * @param[in] mutex Mutex object to lock. Has to be initialized first. Must
+ *                  not be NULL.
+ *
+ * @return 1 if mutex was unlocked, now it is locked.
+ * @return 0 if the mutex was locked.
+ */
+int mutex_pi_trylock(mutex_pi_t *mutex);
+
+/**
+ * @brief Locks a priority inheriting mutex, blocking.
+ *
+ * If the mutex is locked by a thread with a lower priority, that thread runs
+ * with the priority of the calling thread until it unlocks.
+ *
+ * @param[in] mutex Mutex object to lock. Has to be initialized first. Must
+ *                  not be NULL.
+ */
+void mutex_pi_lock(mutex_pi_t *mutex);
+
+/**
+ * @brief Unlocks a priority inheriting mutex.
+ *
+ * If the calling thread holds no other priority inheriting mutex, it returns
+ * to its own priority.
+ *
+ * @pre The calling thread owns @p mutex.
+ *
+ * @param[in] mutex Mutex object to unlock, must not be NULL.
+ */
+void mutex_pi_unlock(mutex_pi_t *mutex);
+
+/**
+ * @brief Initializes a recursive priority inheriting mutex object.
+ *
+ * @param[out] rmutex   pre-allocated mutex structure, must not be NULL.
+ */
+static inline void rmutex_pi_init(rmutex_pi_t *rmutex)
+{
+    rmutex_pi_t empty_rmutex = RMUTEX_PI_INIT;
+    *rmutex = empty_rmutex;
+}
+
+/**
+ * @brief Tries to get a recursive priority inheriting mutex, non-blocking.
+ *
+ * @param[in] rmutex    Recursive mutex object to lock. Has to be
+ *                      initialized first. Must not be NULL.
+ *
+ * @return 1 if mutex was unlocked or is held by the calling thread
+ * @return 0 if the mutex was locked by another thread
+ */
+int rmutex_pi_trylock(rmutex_pi_t *rmutex);
+
+/**
+ * @brief Locks a recursive priority inheriting mutex, blocking.
+ *
+ * @param[in] rmutex    Recursive mutex object to lock. Has to be
+ *                      initialized first. Must not be NULL.
+ */
+void rmutex_pi_lock(rmutex_pi_t *rmutex);
+
+/**
+ * @brief Unlocks a recursive priority inheriting mutex.
+ *
+ * @param[in] rmutex    Recursive mutex object to unlock, must not be NULL.
+ */
+void rmutex_pi_unlock(rmutex_pi_t *rmutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MUTEX_PI_H */
+/** @} */
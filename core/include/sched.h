@@ -119,6 +119,23 @@ int sched_run(void);
  */
 void sched_set_status(thread_t *process, unsigned int status);
 
+#if defined(MODULE_CORE_MUTEX_PI) || defined(DOXYGEN)
+/**
+ * @brief   Change the priority of a thread
+ *
+ * @details If the thread is on the run queue, it is moved to the run queue
+ *          of the new priority. This function does not yield; call
+ *          sched_switch() or thread_yield_higher() afterwards if needed.
+ *
+ * @note    Only available with module `core_mutex_pi`, which uses it to
+ *          lend the priority of waiters to the owner of a mutex.
+ *
+ * @param[in]   thread      The thread
+ * @param[in]   priority    The new priority of @p thread
+ */
+void sched_change_priority(thread_t *thread, uint8_t priority);
+#endif
+
 /**
  * @brief       Yield if approriate.
  *
@@ -174,7 +191,39 @@ extern clist_node_t sched_runqueues[SCHED_PRIO_LEVELS];
  */
 NORETURN void sched_task_exit(void);
 
+#if defined(MODULE_XTIMER_TICKLESS) || defined(DOXYGEN)
+/**
+ *  Number of times the idle thread woke up from the lowest power mode
+ */
+extern volatile uint32_t sched_idle_wakeups;
+#endif
+
 #ifdef MODULE_SCHEDSTATISTICS
+#if defined(MODULE_SCHEDPROF) || defined(DOXYGEN)
+/**
+ *  Number of buckets of the scheduler profiling histograms
+ *
+ *  Bucket 0 counts durations below 16 us, each following bucket covers four
+ *  times the range of the one before and the last one counts everything
+ *  above.
+ */
+#define SCHEDPROF_BUCKETS   (8U)
+
+/**
+ *  Scheduler profile of a thread
+ */
+typedef struct {
+    uint32_t wakeup;        /**< Time stamp of the last time this thread
+                                 became ready to run, 0 if it ran since */
+    uint32_t latency_max;   /**< Longest wakeup-to-run latency in us */
+    uint32_t slice_max;     /**< Longest uninterrupted run in us */
+    uint16_t latency[SCHEDPROF_BUCKETS];    /**< Histogram of the
+                                                 wakeup-to-run latencies */
+    uint16_t slice[SCHEDPROF_BUCKETS];      /**< Histogram of the
+                                                 uninterrupted runs */
+} schedprof_t;
+#endif
+
 /**
  *  Scheduler statistics
  */
@@ -183,6 +232,9 @@ typedef struct {
                                   scheduled to run */
     unsigned int schedules;  /**< How often the thread was scheduled to run */
     uint64_t runtime_ticks;  /**< The total runtime of this thread in ticks */
+#if defined(MODULE_SCHEDPROF) || defined(DOXYGEN)
+    schedprof_t prof;        /**< Latency and run time profile */
+#endif
 } schedstat;
 
 /**
@@ -178,6 +178,11 @@ struct _thread {
     char *sp;                       /**< thread's stack pointer         */
     uint8_t status;                 /**< thread's status                */
     uint8_t priority;               /**< thread's priority              */
+#if defined(MODULE_CORE_MUTEX_PI) || defined(DOXYGEN)
+    uint8_t base_priority;          /**< priority without inheritance   */
+    uint8_t pi_mutexes;             /**< number of held priority
+                                         inheriting mutexes             */
+#endif
 
     kernel_pid_t pid;               /**< thread's process id            */
 
@@ -52,6 +52,9 @@ static void *main_trampoline(void *arg)
 #ifdef MODULE_SCHEDSTATISTICS
     schedstat *stat = &sched_pidlist[thread_getpid()];
     stat->laststart = 0;
+#ifdef MODULE_SCHEDPROF
+    stat->prof.wakeup = 0;
+#endif
 #endif
 
     LOG_INFO("main(): This is RIOT! (Version: " RIOT_VERSION ")\n");
@@ -60,12 +63,19 @@ static void *main_trampoline(void *arg)
     return NULL;
 }
 
+#ifdef MODULE_XTIMER_TICKLESS
+volatile uint32_t sched_idle_wakeups = 0;
+#endif
+
 static void *idle_thread(void *arg)
 {
     (void) arg;
 
     while (1) {
         pm_set_lowest();
+#ifdef MODULE_XTIMER_TICKLESS
+        sched_idle_wakeups++;
+#endif
     }
 
     return NULL;
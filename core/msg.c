@@ -37,6 +37,7 @@
 #include "debug.h"
 
 static int _msg_receive(msg_t *m, int block);
+static int _msg_receive_batch(msg_t *out, unsigned max, int block);
 static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned state);
 
 static int queue_msg(thread_t *target, const msg_t *m)
@@ -286,6 +287,93 @@ int msg_receive(msg_t *m)
     return _msg_receive(m, 1);
 }
 
+int msg_try_receive_batch(msg_t *out, unsigned max)
+{
+    return _msg_receive_batch(out, max, 0);
+}
+
+int msg_receive_batch(msg_t *out, unsigned max)
+{
+    return _msg_receive_batch(out, max, 1);
+}
+
+static int _msg_receive_batch(msg_t *out, unsigned max, int block)
+{
+    assert(max > 0);
+
+    unsigned state = irq_disable();
+    thread_t *me = (thread_t*) sched_threads[sched_active_pid];
+    uint16_t sender_prio = THREAD_PRIORITY_IDLE;
+    unsigned n = 0;
+    list_node_t *next;
+
+    if (me->msg_array) {
+        unsigned avail = cib_avail(&(me->msg_queue));
+
+        if (avail > max) {
+            avail = max;
+        }
+        while (n < avail) {
+            out[n++] = me->msg_array[cib_get_unsafe(&(me->msg_queue))];
+        }
+    }
+    DEBUG("_msg_receive_batch: %" PRIkernel_pid ": got %u queued messages.\n",
+          sched_active_thread->pid, n);
+
+    /* Take the messages of waiting senders: directly if the queue is
+     * drained, into the just freed queue space otherwise to keep the order */
+    while ((next = me->msg_waiters.next) != NULL) {
+        thread_t *sender = container_of((clist_node_t*)next, thread_t, rq_entry);
+        msg_t *m;
+        int queue_index;
+
+        if ((n < max) && ((!me->msg_array) || !cib_avail(&(me->msg_queue)))) {
+            m = &out[n++];
+        }
+        else if (me->msg_array &&
+                 ((queue_index = cib_put(&(me->msg_queue))) >= 0)) {
+            m = &(me->msg_array[queue_index]);
+        }
+        else {
+            break;
+        }
+        list_remove_head(&me->msg_waiters);
+
+        /* copy msg */
+        *m = *((msg_t*) sender->wait_data);
+
+        /* remove sender from queue */
+        if (sender->status != STATUS_REPLY_BLOCKED) {
+            sender->wait_data = NULL;
+            sched_set_status(sender, STATUS_PENDING);
+            if (sender->priority < sender_prio) {
+                sender_prio = sender->priority;
+            }
+        }
+    }
+
+    if (n == 0) {
+        if (!block) {
+            irq_restore(state);
+            return 0;
+        }
+        DEBUG("_msg_receive_batch(): %" PRIkernel_pid ": No msg in queue. "
+              "Going blocked.\n", sched_active_thread->pid);
+        me->wait_data = (void *) out;
+        sched_set_status(me, STATUS_RECEIVE_BLOCKED);
+        irq_restore(state);
+        thread_yield_higher();
+        /* sender copied message */
+        return 1;
+    }
+
+    irq_restore(state);
+    if (sender_prio < THREAD_PRIORITY_IDLE) {
+        sched_switch(sender_prio);
+    }
+    return n;
+}
+
 static int _msg_receive(msg_t *m, int block)
 {
     unsigned state = irq_disable();
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     core_sync
+ * @{
+ *
+ * @file
+ * @brief       Priority inheriting mutex implementation
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+
+#include "assert.h"
+#include "irq.h"
+#include "list.h"
+#include "mutex_pi.h"
+#include "sched.h"
+#include "thread.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static int _lock(mutex_pi_t *mutex, int blocking)
+{
+    unsigned irqstate = irq_disable();
+    thread_t *me = (thread_t *)sched_active_thread;
+
+    if (mutex->mutex.queue.next == NULL) {
+        /* mutex is unlocked. */
+        mutex->mutex.queue.next = MUTEX_LOCKED;
+        mutex->owner = me->pid;
+        me->pi_mutexes++;
+        irq_restore(irqstate);
+        return 1;
+    }
+    else if (blocking) {
+        thread_t *owner = (thread_t *)thread_get(mutex->owner);
+
+        assert(mutex->owner != me->pid);
+        if ((owner != NULL) && (owner->priority > me->priority)) {
+            DEBUG("PID[%" PRIkernel_pid "]: lending priority %" PRIu8
+                  " to %" PRIkernel_pid "\n", me->pid, me->priority,
+                  owner->pid);
+            sched_change_priority(owner, me->priority);
+        }
+        sched_set_status(me, STATUS_MUTEX_BLOCKED);
+        if (mutex->mutex.queue.next == MUTEX_LOCKED) {
+            mutex->mutex.queue.next = (list_node_t *)&me->rq_entry;
+            mutex->mutex.queue.next->next = NULL;
+        }
+        else {
+            thread_add_to_list(&mutex->mutex.queue, me);
+        }
+        irq_restore(irqstate);
+        thread_yield_higher();
+        /* We were woken up by scheduler. Waker removed us from queue and
+         * made us the owner. */
+        return 1;
+    }
+    else {
+        irq_restore(irqstate);
+        return 0;
+    }
+}
+
+int mutex_pi_trylock(mutex_pi_t *mutex)
+{
+    return _lock(mutex, 0);
+}
+
+void mutex_pi_lock(mutex_pi_t *mutex)
+{
+    _lock(mutex, 1);
+}
+
+void mutex_pi_unlock(mutex_pi_t *mutex)
+{
+    unsigned irqstate = irq_disable();
+    thread_t *me = (thread_t *)sched_active_thread;
+    thread_t *process = NULL;
+    int restored = 0;
+
+    assert(!irq_is_in());
+    assert(mutex->owner == me->pid);
+    assert(me->pi_mutexes > 0);
+
+    if (mutex->mutex.queue.next == MUTEX_LOCKED) {
+        /* the mutex was locked and no thread was waiting for it */
+        mutex->mutex.queue.next = NULL;
+        mutex->owner = KERNEL_PID_UNDEF;
+    }
+    else {
+        list_node_t *next = list_remove_head(&mutex->mutex.queue);
+
+        process = container_of((clist_node_t *)next, thread_t, rq_entry);
+        DEBUG("mutex_pi_unlock: handing over to %" PRIkernel_pid "\n",
+              process->pid);
+        sched_set_status(process, STATUS_PENDING);
+        if (!mutex->mutex.queue.next) {
+            mutex->mutex.queue.next = MUTEX_LOCKED;
+        }
+        /* hand over ownership directly, so the new owner can be boosted
+         * before it had the chance to run */
+        mutex->owner = process->pid;
+        process->pi_mutexes++;
+    }
+    /* only drop the lent priority once no other priority inheriting mutex is
+     * held: one of them may still have waiters */
+    if ((--me->pi_mutexes == 0) && (me->priority != me->base_priority)) {
+        sched_change_priority(me, me->base_priority);
+        restored = 1;
+    }
+    irq_restore(irqstate);
+    if (restored) {
+        thread_yield_higher();
+    }
+    else if (process != NULL) {
+        sched_switch(process->priority);
+    }
+}
+
+int rmutex_pi_trylock(rmutex_pi_t *rmutex)
+{
+    if (rmutex->mutex.owner != thread_getpid()) {
+        if (!mutex_pi_trylock(&rmutex->mutex)) {
+            return 0;
+        }
+    }
+    rmutex->refcount++;
+    return 1;
+}
+
+void rmutex_pi_lock(rmutex_pi_t *rmutex)
+{
+    /* owner is only ever set to the pid of the calling thread by the calling
+     * thread itself or while it is blocked on the mutex, so this read can't
+     * be a false positive */
+    if (rmutex->mutex.owner != thread_getpid()) {
+        mutex_pi_lock(&rmutex->mutex);
+    }
+    rmutex->refcount++;
+}
+
+void rmutex_pi_unlock(rmutex_pi_t *rmutex)
+{
+    assert(rmutex->mutex.owner == thread_getpid());
+    assert(rmutex->refcount > 0);
+
+    if (--rmutex->refcount == 0) {
+        mutex_pi_unlock(&rmutex->mutex);
+    }
+}
@@ -79,6 +79,27 @@ static void (*sched_cb) (uint32_t timestamp, uint32_t value) = NULL;
 schedstat sched_pidlist[KERNEL_PID_LAST + 1];
 #endif
 
+#ifdef MODULE_SCHEDPROF
+static void _prof_record(uint16_t *hist, uint32_t *max, uint32_t ticks)
+{
+    uint32_t usec = _xtimer_usec_from_ticks(ticks);
+    unsigned bucket = 0;
+
+    if (usec > *max) {
+        *max = usec;
+    }
+    for (uint32_t bound = 16; usec >= bound; bound <<= 2) {
+        if (++bucket == (SCHEDPROF_BUCKETS - 1)) {
+            break;
+        }
+    }
+    /* saturate rather than wrap around */
+    if (hist[bucket] < UINT16_MAX) {
+        hist[bucket]++;
+    }
+}
+#endif
+
 int __attribute__((used)) sched_run(void)
 {
     sched_context_switch_request = 0;
@@ -119,6 +140,10 @@ int __attribute__((used)) sched_run(void)
         schedstat *active_stat = &sched_pidlist[active_thread->pid];
         if (active_stat->laststart) {
             active_stat->runtime_ticks += now - active_stat->laststart;
+#ifdef MODULE_SCHEDPROF
+            _prof_record(active_stat->prof.slice, &active_stat->prof.slice_max,
+                         now - active_stat->laststart);
+#endif
         }
 #endif
     }
@@ -127,6 +152,13 @@ int __attribute__((used)) sched_run(void)
     schedstat *next_stat = &sched_pidlist[next_thread->pid];
     next_stat->laststart = now;
     next_stat->schedules++;
+#ifdef MODULE_SCHEDPROF
+    if (next_stat->prof.wakeup) {
+        _prof_record(next_stat->prof.latency, &next_stat->prof.latency_max,
+                     now - next_stat->prof.wakeup);
+        next_stat->prof.wakeup = 0;
+    }
+#endif
     if (sched_cb) {
         sched_cb(now, next_thread->pid);
     }
@@ -166,6 +198,10 @@ void sched_set_status(thread_t *process, unsigned int status)
                   process->pid, process->priority);
             clist_rpush(&sched_runqueues[process->priority], &(process->rq_entry));
             runqueue_bitcache |= 1 << process->priority;
+#ifdef MODULE_SCHEDPROF
+            /* never 0, that marks a thread that is not waiting to run */
+            sched_pidlist[process->pid].prof.wakeup = xtimer_now().ticks32 | 1;
+#endif
         }
     }
     else {
@@ -183,6 +219,30 @@ void sched_set_status(thread_t *process, unsigned int status)
     process->status = status;
 }
 
+#ifdef MODULE_CORE_MUTEX_PI
+void sched_change_priority(thread_t *thread, uint8_t priority)
+{
+    unsigned irqstate = irq_disable();
+
+    if (thread->priority == priority) {
+        irq_restore(irqstate);
+        return;
+    }
+    DEBUG("sched_change_priority: thread %" PRIkernel_pid " from %" PRIu8
+          " to %" PRIu8 ".\n", thread->pid, thread->priority, priority);
+    if (thread->status >= STATUS_ON_RUNQUEUE) {
+        clist_remove(&sched_runqueues[thread->priority], &(thread->rq_entry));
+        if (!sched_runqueues[thread->priority].next) {
+            runqueue_bitcache &= ~(1 << thread->priority);
+        }
+        clist_rpush(&sched_runqueues[priority], &(thread->rq_entry));
+        runqueue_bitcache |= 1 << priority;
+    }
+    thread->priority = priority;
+    irq_restore(irqstate);
+}
+#endif
+
 void sched_switch(uint16_t other_prio)
 {
     thread_t *active_thread = (thread_t *) sched_active_thread;
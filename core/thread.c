@@ -225,6 +225,10 @@ kernel_pid_t thread_create(char *stack, int stacksize, char priority, int flags,
 
     cb->priority = priority;
     cb->status = 0;
+#ifdef MODULE_CORE_MUTEX_PI
+    cb->base_priority = priority;
+    cb->pi_mutexes = 0;
+#endif
 
     cb->rq_entry.next = NULL;
 
@@ -27,6 +27,15 @@
 #define NATIVE_TIMER_MIN_RES 200
 /** @} */
 
+/**
+ * @brief   Value the timer counts up from after timer_init()
+ *
+ * Lets tests reach a wrap of the 32 bit counter shortly after boot.
+ */
+#ifndef NATIVE_TIMER_START
+#define NATIVE_TIMER_START  (0U)
+#endif
+
 /**
  * @name Random Number Generator configuration
  * @{
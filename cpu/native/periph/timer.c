@@ -94,7 +94,7 @@ int timer_init(tim_t dev, unsigned long freq, timer_cb_t cb, void *arg)
 
     /* initialize time delta */
     time_null = 0;
-    time_null = timer_read(0);
+    time_null = timer_read(0) - NATIVE_TIMER_START;
 
     _callback = cb;
     _cb_arg = arg;
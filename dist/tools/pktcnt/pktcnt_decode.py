@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 HAW Hamburg
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Decodes the binary records of the pktcnt_bin module back into the text
+lines the plain pktcnt module prints. All other lines pass unchanged."""
+
+import argparse
+import struct
+import sys
+
+LINE_PREFIX = "PKTB "
+
+# pktcnt_bin_rec_t without data, little-endian like all supported targets
+REC_HDR = struct.Struct("<BBBBQHBBBHHBBB")
+
+PKT_TX, PKT_RX, FWD = range(3)
+(PROTO_UNKNOWN, PROTO_NFRAG, PROTO_UDP, PROTO_COAP, PROTO_MQTT,
+ PROTO_ICMPV6, PROTO_NDN, PROTO_HOPP) = range(8)
+FLAG_BCAST = 0x01
+FLAG_ID = 0x02
+
+COAP_PORT = 5683
+MQTT_PORT = 1883
+
+
+def l2addr(addr):
+    return ":".join("%02x" % b for b in addr)
+
+
+def timestamp(time):
+    # the device prints the sub-second part of the timestamp truncated to
+    # an unsigned long
+    return "%u.%06u" % (time // 1000000, (time & 0xffffffff) % 1000000)
+
+
+def tail(rec):
+    proto = rec["proto"]
+    if proto == PROTO_UNKNOWN:
+        return "UNKNOWN"
+    if proto == PROTO_NFRAG:
+        return "6Lo n-frag"
+    if proto == PROTO_UDP:
+        return "UDP %u:%u" % (rec["id"], rec["id2"])
+    if proto == PROTO_COAP:
+        return "CoAP %u.%02u %u" % (rec["code"] >> 5, rec["code"] & 0x1f,
+                                    rec["id"])
+    if proto == PROTO_MQTT:
+        if rec["flags"] & FLAG_ID:
+            return "MQTT %02x %u" % (rec["code"], rec["id"])
+        return "MQTT %02x" % rec["code"]
+    if proto == PROTO_ICMPV6:
+        return "ICMPv6 %u(%u)" % (rec["code"], rec["code2"])
+    if proto == PROTO_NDN:
+        return "NDN %02x %s" % (rec["code"], rec["name"])
+    if proto == PROTO_HOPP:
+        if rec["flags"] & FLAG_ID:
+            return "HOPP %02x RANK-%u" % (rec["code"], rec["id"])
+        return "HOPP %02x %s" % (rec["code"], rec["name"])
+    raise ValueError("unknown protocol %u" % proto)
+
+
+def fwd(rec):
+    iid = "".join("%02X" % b for b in rec["src"])
+    if rec["proto"] == PROTO_COAP:
+        return "FWD-%u.%02u;%u-%s" % (rec["code"] >> 5, rec["code"] & 0x1f,
+                                      rec["id"], iid)
+    if rec["flags"] & FLAG_ID:
+        return "FWD-%02x;%u-%s" % (rec["code"], rec["id"], iid)
+    return "FWD-%02x;%s" % (rec["code"], iid)
+
+
+def parse(data):
+    fields = REC_HDR.unpack_from(data)
+    rec = dict(zip(("len", "type", "proto", "flags", "time", "size", "seq",
+                    "code", "code2", "id", "id2", "src_len", "dst_len",
+                    "name_len"), fields))
+    if rec["len"] != len(data):
+        raise ValueError("record length mismatch")
+    offset = REC_HDR.size
+    rec["src"] = data[offset:offset + rec["src_len"]]
+    offset += rec["src_len"]
+    rec["dst"] = data[offset:offset + rec["dst_len"]]
+    offset += rec["dst_len"]
+    rec["name"] = data[offset:offset + rec["name_len"]].decode("ascii",
+                                                                "replace")
+    return rec
+
+
+def decode(rec, node_id):
+    if rec["type"] == FWD:
+        return fwd(rec)
+    if rec["type"] == PKT_RX:
+        head = "PKT %s PKT_RX %s %s %s seq=%u %u" % (
+            node_id, timestamp(rec["time"]), l2addr(rec["src"]),
+            l2addr(rec["dst"]), rec["seq"], rec["size"])
+    elif rec["type"] == PKT_TX:
+        dst = "BROADCAST" if rec["flags"] & FLAG_BCAST else l2addr(rec["dst"])
+        head = "PKT %s PKT_TX %s %s %s %u" % (
+            node_id, timestamp(rec["time"]), node_id, dst, rec["size"])
+    else:
+        raise ValueError("unknown record type %u" % rec["type"])
+    return "%s %s" % (head, tail(rec))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("infile", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin, help="log file (default: stdin)")
+    parser.add_argument("-i", "--node-id", default="",
+                        help="node ID if the log lacks the STARTUP line")
+    args = parser.parse_args()
+
+    node_id = args.node_id
+    for line in args.infile:
+        line = line.rstrip("\r\n")
+        # the STARTUP line carries the ID of the node
+        words = line.split()
+        if len(words) > 2 and words[0] == "PKT" and words[2] == "STARTUP":
+            node_id = words[1]
+        # logs of pyterm prefix each line with a timestamp
+        pos = line.find(LINE_PREFIX)
+        if pos < 0:
+            print(line)
+            continue
+        try:
+            rec = parse(bytes.fromhex(line[pos + len(LINE_PREFIX):]))
+            print(line[:pos] + decode(rec, node_id))
+        except ValueError as e:
+            print("%s (%s)" % (line, e), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -6,6 +6,7 @@
  * directory for more details.
  */
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "tlsf-malloc.h"
 #include "msg.h"
@@ -31,10 +32,31 @@ char hwaddr_str[GNRC_NETIF_L2ADDR_MAXLEN * 3];
 #define TLSF_BUFFER     ((40 * 1024) / sizeof(uint32_t))
 static uint32_t _tlsf_heap[TLSF_BUFFER];
 
+/* one HoPP instance per network interface */
+static hopp_t _hopp[GNRC_NETIF_NUMOF];
+static char _hopp_stacks[GNRC_NETIF_NUMOF][HOPP_STACKSZ];
+static unsigned _hopp_numof = 0;
+
+static hopp_t *_get_hopp(int argc, char **argv)
+{
+    unsigned idx = (argc > 2) ? (unsigned)atoi(argv[2]) : 0;
+
+    if (idx >= _hopp_numof) {
+        puts("error: unknown instance");
+        return NULL;
+    }
+    return &_hopp[idx];
+}
+
 static int _root(int argc, char **argv)
 {
-    if (argc == 2) {
-        hopp_root_start((const char *)argv[1], strlen(argv[1]));
+    hopp_t *hopp;
+
+    if ((argc == 2) || (argc == 3)) {
+        if ((hopp = _get_hopp(argc, argv)) == NULL) {
+            return -1;
+        }
+        hopp_root_start(hopp, (const char *)argv[1], strlen(argv[1]));
     }
     else {
         puts("error");
@@ -65,8 +87,13 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
 
 static int _publish(int argc, char **argv)
 {
-    if (argc == 2) {
-        hopp_publish_content((const char *)argv[1], strlen(argv[1]), NULL, 0);
+    hopp_t *hopp;
+
+    if ((argc == 2) || (argc == 3)) {
+        if ((hopp = _get_hopp(argc, argv)) == NULL) {
+            return -1;
+        }
+        hopp_publish_content(hopp, (const char *)argv[1], strlen(argv[1]), NULL, 0);
     }
     else {
         puts("error");
@@ -76,8 +103,8 @@ static int _publish(int argc, char **argv)
 }
 
 static const shell_command_t shell_commands[] = {
-    { "hr", "start HoPP root", _root },
-    { "hp", "publish data", _publish },
+    { "hr", "start HoPP root: hr <prefix> [<instance>]", _root },
+    { "hp", "publish data: hp <name> [<instance>]", _publish },
     { NULL, NULL, NULL }
 };
 
@@ -90,20 +117,26 @@ int main(void)
 
     ccnl_start();
 
-    if (((hopp_netif = gnrc_netif_iter(NULL)) == NULL) ||
-        (ccnl_open_netif(hopp_netif->pid, GNRC_NETTYPE_CCN) < 0)) {
-        return -1;
-    }
+    gnrc_netif_t *netif = NULL;
+    while ((netif = gnrc_netif_iter(netif))) {
+        if (ccnl_open_netif(netif->pid, GNRC_NETTYPE_CCN) < 0) {
+            return -1;
+        }
+
+        uint16_t chan = 11;
+        gnrc_netapi_set(netif->pid, NETOPT_CHANNEL, 0, &chan, sizeof(chan));
 
-    uint16_t chan = 11;
-    gnrc_netapi_set(hopp_netif->pid, NETOPT_CHANNEL, 0, &chan, sizeof(chan));
+        uint16_t src_len = 8U;
+        gnrc_netapi_set(netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
+    }
 
-    uint16_t src_len = 8U;
-    gnrc_netapi_set(hopp_netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
+    if ((netif = gnrc_netif_iter(NULL)) == NULL) {
+        return -1;
+    }
 #ifdef BOARD_NATIVE
-    gnrc_netapi_get(hopp_netif->pid, NETOPT_ADDRESS, 0, hwaddr, sizeof(hwaddr));
+    gnrc_netapi_get(netif->pid, NETOPT_ADDRESS, 0, hwaddr, sizeof(hwaddr));
 #else
-    gnrc_netapi_get(hopp_netif->pid, NETOPT_ADDRESS_LONG, 0, hwaddr, sizeof(hwaddr));
+    gnrc_netapi_get(netif->pid, NETOPT_ADDRESS_LONG, 0, hwaddr, sizeof(hwaddr));
 #endif
     gnrc_netif_addr_to_str(hwaddr, sizeof(hwaddr), hwaddr_str);
 
@@ -113,16 +146,20 @@ int main(void)
         return 1;
     }
 
-    hopp_pid = thread_create(hopp_stack, sizeof(hopp_stack), THREAD_PRIORITY_MAIN - 1,
-                             THREAD_CREATE_STACKTEST, hopp, &ccnl_relay,
-                             "hopp");
-
-    if (hopp_pid <= KERNEL_PID_UNDEF) {
-        return 1;
+    netif = NULL;
+    while ((netif = gnrc_netif_iter(netif)) && (_hopp_numof < GNRC_NETIF_NUMOF)) {
+        hopp_t *hopp = &_hopp[_hopp_numof];
+
+        if (hopp_create(hopp, _hopp_stacks[_hopp_numof],
+                        sizeof(_hopp_stacks[_hopp_numof]),
+                        THREAD_PRIORITY_MAIN - 1, "hopp", netif,
+                        &ccnl_relay) <= KERNEL_PID_UNDEF) {
+            return 1;
+        }
+        //hopp_set_cb_published(hopp, cb_published);
+        _hopp_numof++;
     }
 
-    //hopp_set_cb_published(cb_published);
-
     char line_buf[SHELL_DEFAULT_BUFSIZE];
     shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
     return 0;
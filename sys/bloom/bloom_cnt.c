@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup sys_bloom
+ * @{
+ *
+ * @file
+ * @brief   Counting Bloom filter implementation
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bloom.h"
+
+void bloom_cnt_init(bloom_cnt_t *bloom, size_t size, uint8_t *counters,
+                    hashfp_t *hashes, int hashes_numof)
+{
+    bloom->m = size;
+    bloom->c = counters;
+    bloom->hash = hashes;
+    bloom->k = hashes_numof;
+}
+
+void bloom_cnt_add(bloom_cnt_t *bloom, const uint8_t *buf, size_t len)
+{
+    for (size_t n = 0; n < bloom->k; n++) {
+        uint8_t *c = &bloom->c[bloom->hash[n](buf, len) % bloom->m];
+
+        if (*c < UINT8_MAX) {
+            (*c)++;
+        }
+    }
+}
+
+void bloom_cnt_remove(bloom_cnt_t *bloom, const uint8_t *buf, size_t len)
+{
+    for (size_t n = 0; n < bloom->k; n++) {
+        uint8_t *c = &bloom->c[bloom->hash[n](buf, len) % bloom->m];
+
+        /* a saturated counter lost track of its count */
+        if ((*c > 0) && (*c < UINT8_MAX)) {
+            (*c)--;
+        }
+    }
+}
+
+bool bloom_cnt_check(const bloom_cnt_t *bloom, const uint8_t *buf, size_t len)
+{
+    for (size_t n = 0; n < bloom->k; n++) {
+        if (bloom->c[bloom->hash[n](buf, len) % bloom->m] == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_defer
+ * @{
+ *
+ * @file
+ * @brief       Deferred work implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+
+#include "irq.h"
+
+#include "defer.h"
+
+void defer_init(defer_t *defer, defer_handler_t handler, void *arg,
+                thread_t *thread, thread_flags_t flag)
+{
+    assert(defer && handler);
+
+    defer->handler = handler;
+    defer->arg = arg;
+    defer->thread = thread;
+    defer->flag = flag;
+    defer->pending = 0;
+    defer->signals = 0;
+    defer->coalesced = 0;
+    defer->dropped = 0;
+}
+
+void defer_set_thread(defer_t *defer, thread_t *thread)
+{
+    unsigned state = irq_disable();
+
+    defer->thread = thread;
+    irq_restore(state);
+}
+
+void defer_signal(defer_t *defer)
+{
+    unsigned state = irq_disable();
+
+    if (defer->thread == NULL) {
+        defer->dropped++;
+        irq_restore(state);
+        return;
+    }
+    if (defer->pending) {
+        /* the pending run will handle this one as well */
+        if (defer->pending < UINT8_MAX) {
+            defer->pending++;
+        }
+        defer->coalesced++;
+        irq_restore(state);
+        return;
+    }
+    defer->pending = 1;
+    irq_restore(state);
+    thread_flags_set(defer->thread, defer->flag);
+}
+
+int defer_run(defer_t *defer)
+{
+    unsigned state = irq_disable();
+
+    if (!defer->pending) {
+        irq_restore(state);
+        return 0;
+    }
+    defer->signals = defer->pending;
+    defer->pending = 0;
+    irq_restore(state);
+    defer->handler(defer);
+    return 1;
+}
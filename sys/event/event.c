@@ -23,10 +23,15 @@ void event_queue_init(event_queue_t *queue)
 
 void event_post(event_queue_t *queue, event_t *event)
 {
-    assert(!event->list_node.next);
     assert(queue->waiter);
 
     unsigned state = irq_disable();
+    if (event->list_node.next) {
+        /* already queued, its handler will run anyway */
+        queue->coalesced++;
+        irq_restore(state);
+        return;
+    }
     clist_rpush(&queue->event_list, &event->list_node);
     irq_restore(state);
 
@@ -77,3 +82,65 @@ void event_loop(event_queue_t *queue)
         event->handler(event);
     }
 }
+
+/* get the next event of the highest priority queue with events, unless that
+ * queue used up its budget (cur and cnt track the queue served last) */
+static event_t *_get_multi(event_queue_t *queues, size_t n_queues,
+                           const unsigned *budgets, size_t *cur, unsigned *cnt)
+{
+    unsigned state = irq_disable();
+    size_t i = 0;
+    event_t *result;
+
+    while ((i < n_queues) && !clist_lpeek(&queues[i].event_list)) {
+        i++;
+    }
+    if (i == n_queues) {
+        irq_restore(state);
+        return NULL;
+    }
+    if (budgets && budgets[i] && (i == *cur) && (*cnt >= budgets[i])) {
+        size_t j = i + 1;
+
+        while ((j < n_queues) && !clist_lpeek(&queues[j].event_list)) {
+            j++;
+        }
+        if (j < n_queues) {
+            i = j;
+        }
+    }
+    if (i == *cur) {
+        (*cnt)++;
+    }
+    else {
+        *cur = i;
+        *cnt = 1;
+    }
+    result = (event_t *)clist_lpop(&queues[i].event_list);
+    irq_restore(state);
+    result->list_node.next = NULL;
+    return result;
+}
+
+void event_loop_multi(event_queue_t *queues, size_t n_queues,
+                      const unsigned *budgets)
+{
+    size_t cur = n_queues;
+    unsigned cnt = 0;
+
+    assert(queues && n_queues);
+    for (size_t i = 0; i < n_queues; i++) {
+        assert(queues[i].waiter == (thread_t *)sched_active_thread);
+    }
+
+    while (1) {
+        event_t *event = _get_multi(queues, n_queues, budgets, &cur, &cnt);
+
+        if (event) {
+            event->handler(event);
+        }
+        else {
+            thread_flags_wait_any(THREAD_FLAG_EVENT);
+        }
+    }
+}
@@ -156,6 +156,25 @@ void evtimer_del(evtimer_t *evtimer, evtimer_event_t *event)
     irq_restore(state);
 }
 
+uint32_t evtimer_get_remaining(evtimer_t *evtimer,
+                               const evtimer_event_t *event)
+{
+    unsigned state = irq_disable();
+    uint32_t offset = 0, res = UINT32_MAX;
+
+    for (evtimer_event_t *list = evtimer->events; list; list = list->next) {
+        /* the offset of the head is only updated on changes to the list */
+        offset += (list == evtimer->events) ? _get_offset(&evtimer->timer)
+                                            : list->offset;
+        if (list == event) {
+            res = offset;
+            break;
+        }
+    }
+    irq_restore(state);
+    return res;
+}
+
 static evtimer_event_t *_get_next(evtimer_t *evtimer)
 {
     evtimer_event_t *event = evtimer->events;
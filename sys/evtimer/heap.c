@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_evtimer
+ * @{
+ *
+ * @file
+ * @brief       event timer implementation based on a pairing heap
+ *
+ * Events are ordered by their absolute deadline in milliseconds since boot.
+ * evtimer_t::events is the root of the heap, evtimer_event_t::next links the
+ * children of an event.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "irq.h"
+#include "xtimer.h"
+
+#include "evtimer.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static inline uint64_t _deadline(const evtimer_event_t *event)
+{
+    return ((uint64_t)event->long_target << 32) | event->offset;
+}
+
+static inline uint64_t _now_ms(void)
+{
+    return xtimer_now_usec64() / US_PER_MS;
+}
+
+static inline int _is_queued(const evtimer_t *evtimer,
+                             const evtimer_event_t *event)
+{
+    return (event == evtimer->events) || (event->prev != NULL);
+}
+
+/**
+ * @brief   meld two heaps, both @p a and @p b must be roots
+ */
+static evtimer_event_t *_meld(evtimer_event_t *a, evtimer_event_t *b)
+{
+    if (_deadline(b) < _deadline(a)) {
+        evtimer_event_t *tmp = a;
+
+        a = b;
+        b = tmp;
+    }
+    b->prev = a;
+    b->next = a->child;
+    if (b->next) {
+        b->next->prev = b;
+    }
+    a->child = b;
+    return a;
+}
+
+/**
+ * @brief   meld a list of siblings into one heap
+ */
+static evtimer_event_t *_merge_pairs(evtimer_event_t *first)
+{
+    evtimer_event_t *pairs = NULL, *root = NULL;
+
+    /* meld pairs from left to right, collect them in reverse order */
+    while (first) {
+        evtimer_event_t *a = first, *b = first->next;
+
+        if (b) {
+            first = b->next;
+            b->next = b->prev = NULL;
+        }
+        else {
+            first = NULL;
+        }
+        a->next = a->prev = NULL;
+        if (b) {
+            a = _meld(a, b);
+        }
+        a->next = pairs;
+        pairs = a;
+    }
+    /* meld the pairs from right to left */
+    while (pairs) {
+        evtimer_event_t *next = pairs->next;
+
+        pairs->next = NULL;
+        root = (root) ? _meld(root, pairs) : pairs;
+        pairs = next;
+    }
+    return root;
+}
+
+static void _remove(evtimer_t *evtimer, evtimer_event_t *event)
+{
+    evtimer_event_t *children = event->child;
+
+    if (event == evtimer->events) {
+        evtimer->events = NULL;
+    }
+    else {
+        /* cut the event out of its parent's list of children */
+        if (event->prev->child == event) {
+            event->prev->child = event->next;
+        }
+        else {
+            event->prev->next = event->next;
+        }
+        if (event->next) {
+            event->next->prev = event->prev;
+        }
+    }
+    event->next = event->prev = event->child = NULL;
+    if (children) {
+        children = _merge_pairs(children);
+        evtimer->events = (evtimer->events) ? _meld(evtimer->events, children)
+                                            : children;
+    }
+}
+
+static void _update_timer(evtimer_t *evtimer)
+{
+    if (evtimer->events) {
+        uint64_t target_us = _deadline(evtimer->events) * US_PER_MS;
+        uint64_t now_us = xtimer_now_usec64();
+
+        DEBUG("evtimer: setting xtimer to %" PRIu32 " ms\n",
+              (uint32_t)((target_us - now_us) / US_PER_MS));
+        xtimer_set64(&evtimer->timer,
+                     (target_us > now_us) ? (target_us - now_us) : 0);
+    }
+    else {
+        xtimer_remove(&evtimer->timer);
+    }
+}
+
+void evtimer_add(evtimer_t *evtimer, evtimer_event_t *event)
+{
+    unsigned state = irq_disable();
+    /* round up, so the event is never due early */
+    uint64_t deadline = ((xtimer_now_usec64() + US_PER_MS - 1) / US_PER_MS) +
+                        event->offset;
+
+    DEBUG("evtimer_add(): adding event with offset %" PRIu32 "\n", event->offset);
+
+    event->offset = (uint32_t)deadline;
+    event->long_target = deadline >> 32;
+    event->next = event->prev = event->child = NULL;
+    evtimer->events = (evtimer->events) ? _meld(evtimer->events, event) : event;
+    if (evtimer->events == event) {
+        _update_timer(evtimer);
+    }
+    irq_restore(state);
+    if (sched_context_switch_request) {
+        thread_yield_higher();
+    }
+}
+
+void evtimer_del(evtimer_t *evtimer, evtimer_event_t *event)
+{
+    unsigned state = irq_disable();
+
+    if (_is_queued(evtimer, event)) {
+        int was_root = (event == evtimer->events);
+        uint64_t deadline = _deadline(event);
+        uint64_t now = _now_ms();
+
+        DEBUG("evtimer_del(): removing event\n");
+        _remove(evtimer, event);
+        /* keep the remaining time as offset */
+        event->offset = (deadline > now) ? (uint32_t)(deadline - now) : 0;
+        if (was_root) {
+            _update_timer(evtimer);
+        }
+    }
+    irq_restore(state);
+}
+
+uint32_t evtimer_get_remaining(evtimer_t *evtimer,
+                               const evtimer_event_t *event)
+{
+    unsigned state = irq_disable();
+    uint32_t res = UINT32_MAX;
+
+    if (_is_queued(evtimer, event)) {
+        uint64_t deadline = _deadline(event);
+        uint64_t now = _now_ms();
+
+        if (deadline <= now) {
+            res = 0;
+        }
+        else if ((deadline - now) < UINT32_MAX) {
+            res = deadline - now;
+        }
+        else {
+            res = UINT32_MAX - 1;
+        }
+    }
+    irq_restore(state);
+    return res;
+}
+
+static void _evtimer_handler(void *arg)
+{
+    evtimer_t *evtimer = (evtimer_t *)arg;
+    uint64_t now = _now_ms();
+    evtimer_event_t *event;
+
+    DEBUG("_evtimer_handler()\n");
+
+    while ((event = evtimer->events) && (_deadline(event) <= now)) {
+        _remove(evtimer, event);
+        event->offset = 0;
+        evtimer->callback(event);
+    }
+    _update_timer(evtimer);
+}
+
+void evtimer_init(evtimer_t *evtimer, evtimer_callback_t handler)
+{
+    evtimer->callback = handler;
+    evtimer->timer.callback = _evtimer_handler;
+    evtimer->timer.arg = (void *)evtimer;
+    evtimer->events = NULL;
+}
+
+static void _print(const evtimer_event_t *event, uint64_t now)
+{
+    for (; event; event = event->next) {
+        uint64_t deadline = _deadline(event);
+
+        printf("ev remaining=%" PRIu32 "\n",
+               (deadline > now) ? (uint32_t)(deadline - now) : 0);
+        _print(event->child, now);
+    }
+}
+
+void evtimer_print(const evtimer_t *evtimer)
+{
+    _print(evtimer->events, _now_ms());
+}
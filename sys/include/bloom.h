@@ -228,6 +228,77 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len);
  */
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len);
 
+/**
+ * @brief Counting Bloom filter object
+ *
+ * A counting Bloom filter keeps one counter per position instead of a bit,
+ * so strings can be removed again. Counters saturate at UINT8_MAX and are
+ * never decremented afterwards, which keeps the filter free of false
+ * negatives.
+ *
+ * Checking the filter only reads single bytes, so one writer and any number
+ * of readers can use the filter concurrently without locking.
+ */
+typedef struct {
+    /** number of counters in the filter */
+    size_t m;
+    /** number of hash functions */
+    size_t k;
+    /** the counter array */
+    uint8_t *c;
+    /** the hash functions */
+    hashfp_t *hash;
+} bloom_cnt_t;
+
+/**
+ * @brief Initialize a counting Bloom filter.
+ *
+ * @param bloom             bloom_cnt_t to initialize
+ * @param size              number of counters of the filter
+ * @param counters          underlying counter array of the filter, zeroed
+ * @param hashes            array of hashes
+ * @param hashes_numof      number of elements in hashes
+ *
+ * @pre     @p counters MUST hold @p size elements.
+ */
+void bloom_cnt_init(bloom_cnt_t *bloom, size_t size, uint8_t *counters,
+                    hashfp_t *hashes, int hashes_numof);
+
+/**
+ * @brief Add a string to a counting Bloom filter.
+ *
+ * @param bloom  counting Bloom filter
+ * @param buf    string to add
+ * @param len    the length of the string @p buf
+ */
+void bloom_cnt_add(bloom_cnt_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Remove a string from a counting Bloom filter.
+ *
+ * @pre  @p buf was added with bloom_cnt_add() before and was not removed
+ *       since. Removing other strings leads to false negatives.
+ *
+ * @param bloom  counting Bloom filter
+ * @param buf    string to remove
+ * @param len    the length of the string @p buf
+ */
+void bloom_cnt_remove(bloom_cnt_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Determine if a string is in a counting Bloom filter.
+ *
+ * @see bloom_check()
+ *
+ * @param bloom  counting Bloom filter
+ * @param buf    string to check
+ * @param len    the length of the string @p buf
+ *
+ * @return       false if string does not exist in the filter
+ * @return       true if string is may be in the filter
+ */
+bool bloom_cnt_check(const bloom_cnt_t *bloom, const uint8_t *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_defer Deferred work
+ * @ingroup     sys
+ * @brief       Defers work from interrupt context to a thread
+ *
+ * An interrupt handler marks the work of a source, e.g. a network device, as
+ * pending with defer_signal() and wakes the thread by a
+ * @ref core_thread_flags "thread flag". The thread then calls defer_run(),
+ * which runs the handler of the source if its work is pending.
+ *
+ * Unlike messages, signalling never fails because a queue is full: further
+ * signals of a source while its work is pending collapse into the one pending
+ * run of its handler. The handler finds the number of signals it handles in
+ * defer_t::signals, so it can do the work of every signal, e.g. call the
+ * interrupt handler of a device once per interrupt, with a single wakeup of
+ * the thread.
+ *
+ * Several sources can share one thread flag, defer_run() has to be called for
+ * each of them then.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static void _handler(defer_t *defer)
+ * {
+ *     dev_t *dev = defer->arg;
+ *     ...
+ * }
+ *
+ * static defer_t _defer = DEFER_INIT(_handler, &dev, THREAD_FLAG_DEV);
+ *
+ * static void _isr(void *arg)
+ * {
+ *     defer_signal(&_defer);
+ * }
+ *
+ * [...] in the thread
+ *
+ *     defer_set_thread(&_defer, (thread_t *)sched_active_thread);
+ *     while (1) {
+ *         thread_flags_wait_any(THREAD_FLAG_DEV);
+ *         defer_run(&_defer);
+ *     }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief       Deferred work interface
+ */
+
+#ifndef DEFER_H
+#define DEFER_H
+
+#include <stdint.h>
+
+#include "thread.h"
+#include "thread_flags.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Deferred work forward declaration
+ */
+typedef struct defer defer_t;
+
+/**
+ * @brief   Handler of deferred work, runs in the thread
+ */
+typedef void (*defer_handler_t)(defer_t *defer);
+
+/**
+ * @brief   Deferred work of one source
+ */
+struct defer {
+    defer_handler_t handler;    /**< handler of the work */
+    void *arg;                  /**< argument for the handler */
+    thread_t *thread;           /**< thread running the handler */
+    thread_flags_t flag;        /**< flag to wake the thread with */
+    volatile uint8_t pending;   /**< signals since the last run, saturates
+                                     at UINT8_MAX */
+    uint8_t signals;            /**< signals the running handler handles */
+    uint16_t coalesced;         /**< signals while the work was pending */
+    uint16_t dropped;           /**< signals while there was no thread */
+};
+
+/**
+ * @brief   Static initializer
+ *
+ * The thread has to be set with defer_set_thread().
+ *
+ * @param[in] HANDLER   handler of the work
+ * @param[in] ARG       argument for the handler
+ * @param[in] FLAG      thread flag to wake the thread with
+ */
+#define DEFER_INIT(HANDLER, ARG, FLAG)  { .handler = (HANDLER), .arg = (ARG), \
+                                          .flag = (FLAG) }
+
+/**
+ * @brief   Initialize deferred work
+ *
+ * @param[out] defer    deferred work to initialize
+ * @param[in] handler   handler of the work
+ * @param[in] arg       argument for the handler
+ * @param[in] thread    thread running the handler, may be NULL and set later
+ *                      with defer_set_thread()
+ * @param[in] flag      thread flag to wake @p thread with
+ */
+void defer_init(defer_t *defer, defer_handler_t handler, void *arg,
+                thread_t *thread, thread_flags_t flag);
+
+/**
+ * @brief   Set the thread running the handler
+ *
+ * Signals before the thread is set are dropped.
+ *
+ * @param[in] defer     deferred work
+ * @param[in] thread    thread running the handler
+ */
+void defer_set_thread(defer_t *defer, thread_t *thread);
+
+/**
+ * @brief   Mark the work as pending and wake the thread
+ *
+ * Can be called from interrupt context.
+ *
+ * @param[in] defer     deferred work
+ */
+void defer_signal(defer_t *defer);
+
+/**
+ * @brief   Run the handler if the work is pending
+ *
+ * Must be called by the thread after it was woken by defer_t::flag. The work
+ * is not pending anymore when the handler is called, so signals while the
+ * handler runs lead to another run. The number of signals collapsed into
+ * this run is in defer_t::signals while the handler runs.
+ *
+ * @param[in] defer     deferred work
+ *
+ * @return  1, if the handler ran
+ * @return  0, if no work was pending
+ */
+int defer_run(defer_t *defer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFER_H */
+/** @} */
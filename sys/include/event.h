@@ -35,12 +35,18 @@
  *    This is not (easily) possible using msg queues, as they might fill up.
  * 4. an event can only be queued in one event queue at the same time.
  *    Notifying many queues using only one event object is not possible with
- *    this imlementation.
+ *    this imlementation. Posting an event that is already queued does
+ *    nothing but count the post in event_queue_t::coalesced, so the event's
+ *    handler runs once for all of them.
  *
  * At the core, event_wait() uses thread flags to implement waiting for events
  * to be queued. Thus event queues can be used safely and efficiently in combination
  * with thread flags and msg queues.
  *
+ * One thread can serve several queues of different priority with
+ * event_loop_multi(), e.g. to keep urgent control events from waiting behind
+ * a flood of data events.
+ *
  * Examples:
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
@@ -89,6 +95,7 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "irq.h"
@@ -135,6 +142,7 @@ struct event {
 typedef struct {
     clist_node_t event_list;    /**< list of queued events              */
     thread_t *waiter;           /**< thread ownning event queue         */
+    unsigned coalesced;         /**< posts of already queued events     */
 } event_queue_t;
 
 /**
@@ -149,6 +157,9 @@ void event_queue_init(event_queue_t *queue);
 /**
  * @brief   Queue an event
  *
+ * If @p event is already queued, it is left where it is and
+ * event_queue_t::coalesced of @p queue is incremented.
+ *
  * @param[in]   queue   event queue to queue event in
  * @param[in]   event   event to queue in event queue
  */
@@ -211,6 +222,29 @@ event_t *event_wait(event_queue_t *queue);
  */
 void event_loop(event_queue_t *queue);
 
+/**
+ * @brief   Event loop serving multiple queues by priority
+ *
+ * @p queues are served in strict priority order, `queues[0]` first: the next
+ * event is always taken from the first queue that has events. To keep lower
+ * priority queues from starving, @p budgets can limit the number of events
+ * handled from a queue in a row. Once a queue used up its budget, one event
+ * of the next lower priority queue with events is handled before the queue
+ * gets a new budget.
+ *
+ * All @p queues must be owned by the calling thread.
+ *
+ * This function never returns.
+ *
+ * @param[in]   queues      event queues to process, highest priority first
+ * @param[in]   n_queues    number of queues in @p queues
+ * @param[in]   budgets     maximum number of events handled from each queue
+ *                          in a row, 0 for no limit. May be NULL to serve
+ *                          @p queues by strict priority only.
+ */
+void event_loop_multi(event_queue_t *queues, size_t n_queues,
+                      const unsigned *budgets);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,13 @@
  *   example.
  * - uses @ref sys_xtimer "xtimer" as backend
  *
+ * Events are kept in a list sorted by their offsets, so adding and removing
+ * an event is linear in the number of events queued. With the `evtimer_heap`
+ * module they are kept in a pairing heap by their absolute deadline instead,
+ * which takes logarithmic time (amortized) and makes
+ * @ref evtimer_get_remaining() constant time, at the cost of three more
+ * fields per event.
+ *
  * @{
  *
  * @file
@@ -57,6 +64,14 @@ extern "C" {
 typedef struct evtimer_event {
     struct evtimer_event *next; /**< the next event in the queue */
     uint32_t offset;            /**< offset in milliseconds from previous event */
+#if defined(MODULE_EVTIMER_HEAP) || defined(DOXYGEN)
+    struct evtimer_event *child;    /**< first child in the heap */
+    struct evtimer_event *prev;     /**< previous sibling in the heap, or the
+                                         parent for the first child */
+    uint32_t long_target;           /**< upper 32 bit of the deadline in
+                                         milliseconds while the event is
+                                         queued, offset holds the lower ones */
+#endif
 } evtimer_event_t;
 
 /**
@@ -98,6 +113,18 @@ void evtimer_add(evtimer_t *evtimer, evtimer_event_t *event);
  */
 void evtimer_del(evtimer_t *evtimer, evtimer_event_t *event);
 
+/**
+ * @brief   Get the time until an event is due
+ *
+ * @param[in] evtimer       An event timer
+ * @param[in] event         An event
+ *
+ * @return  Milliseconds until @p event is due, if it is queued in @p evtimer
+ * @return  UINT32_MAX, if @p event is not queued in @p evtimer
+ */
+uint32_t evtimer_get_remaining(evtimer_t *evtimer,
+                               const evtimer_event_t *event);
+
 /**
  * @brief   Print overview of current state of an event timer
  *
@@ -25,7 +25,7 @@
 #include <stdint.h>
 
 #include "mutex.h"
-#include "tsrb.h"
+#include "spscrb.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,13 +36,13 @@ extern "C" {
  */
 typedef struct {
     mutex_t mutex;      /**< isrpipe mutex */
-    tsrb_t tsrb;        /**< isrpipe thread safe ringbuffer */
+    spscrb_t rb;        /**< isrpipe ringbuffer */
 } isrpipe_t;
 
 /**
  * @brief   Static initializer for irspipe
  */
-#define ISRPIPE_INIT(tsrb_buf) { .mutex = MUTEX_INIT, .tsrb = TSRB_INIT(tsrb_buf) }
+#define ISRPIPE_INIT(rb_buf) { .mutex = MUTEX_INIT, .rb = SPSCRB_INIT(rb_buf) }
 
 /**
  * @brief   Initialisation function for isrpipe
@@ -64,6 +64,18 @@ void isrpipe_init(isrpipe_t *isrpipe, char *buf, size_t bufsize);
  */
 int isrpipe_write_one(isrpipe_t *isrpipe, char c);
 
+/**
+ * @brief   Put multiple characters into the isrpipe's buffer
+ *
+ * @param[in]   isrpipe     isrpipe object to operate on
+ * @param[in]   buf         characters to add to isrpipe buffer
+ * @param[in]   count       number of characters in @p buf
+ *
+ * @returns     number of characters added, less than @p count if the buffer
+ *              ran full
+ */
+int isrpipe_write(isrpipe_t *isrpipe, const char *buf, size_t count);
+
 /**
  * @brief   Read data from isrpipe (blocking)
  *
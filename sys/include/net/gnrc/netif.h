@@ -45,7 +45,14 @@
 #include "net/gnrc/netif/mac.h"
 #endif
 #include "net/netdev.h"
+#ifdef MODULE_DEFER
+#include "defer.h"
+#endif
+#ifdef MODULE_CORE_MUTEX_PI
+#include "mutex_pi.h"
+#else
 #include "rmutex.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,7 +69,13 @@ typedef struct gnrc_netif_ops gnrc_netif_ops_t;
 typedef struct {
     const gnrc_netif_ops_t *ops;            /**< Operations of the network interface */
     netdev_t *dev;                          /**< Network device of the network interface */
+#if defined(MODULE_CORE_MUTEX_PI) || defined(DOXYGEN)
+    rmutex_pi_t mutex;                      /**< Mutex of the interface, a
+                                             *   priority inheriting one
+                                             *   with module `core_mutex_pi` */
+#else
     rmutex_t mutex;                         /**< Mutex of the interface */
+#endif
 #if defined(MODULE_GNRC_IPV6) || DOXYGEN
     gnrc_netif_ipv6_t ipv6;                 /**< IPv6 component */
 #endif
@@ -97,6 +110,14 @@ typedef struct {
     uint8_t cur_hl;                         /**< Current hop-limit for out-going packets */
     uint8_t device_type;                    /**< Device type */
     kernel_pid_t pid;                       /**< PID of the network interface's thread */
+#if defined(MODULE_DEFER) || DOXYGEN
+    defer_t isr;                            /**< device interrupts deferred
+                                             *   to the interface's thread */
+#endif
+#if defined(MODULE_GNRC_PKTTRACE) || DOXYGEN
+    uint32_t isr_time;                      /**< time of the last device
+                                             *   interrupt in us */
+#endif
 } gnrc_netif_t;
 
 /**
@@ -44,6 +44,14 @@ extern "C" {
 #define GNRC_NETIF_PRIO            (THREAD_PRIORITY_MAIN - 5)
 #endif
 
+/**
+ * @brief   Thread flag a network interface's thread is woken with on a device
+ *          interrupt
+ */
+#ifndef GNRC_NETIF_THREAD_FLAG_ISR
+#define GNRC_NETIF_THREAD_FLAG_ISR (0x1 << 13)
+#endif
+
 /**
  * @brief   Number of multicast addresses needed for @ref net_gnrc_rpl "RPL".
  *
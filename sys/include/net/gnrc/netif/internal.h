@@ -31,11 +31,6 @@
 extern "C" {
 #endif
 
-/**
- * @brief   Message type for @ref netdev_event_t "netdev events"
- */
-#define NETDEV_MSG_TYPE_EVENT   (0x1234)
-
 /**
  * @brief   Acquires exclusive access to the interface
  *
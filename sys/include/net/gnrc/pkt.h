@@ -27,6 +27,9 @@
 
 #include "kernel_types.h"
 #include "net/gnrc/nettype.h"
+#ifdef MODULE_GNRC_PKTTRACE
+#include "net/gnrc/pkttrace.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -120,6 +123,9 @@ typedef struct gnrc_pktsnip {
     kernel_pid_t err_sub;           /**< subscriber to errors related to this
                                      *   packet snip */
 #endif
+#ifdef MODULE_GNRC_PKTTRACE
+    gnrc_pkttrace_t trace;          /**< latency trace of the packet */
+#endif
 } gnrc_pktsnip_t;
 
 /**
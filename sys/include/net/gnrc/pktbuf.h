@@ -58,6 +58,39 @@ extern "C" {
 #define GNRC_PKTBUF_SIZE    (6144)
 #endif  /* GNRC_PKTBUF_SIZE */
 
+/**
+ * @name    Size classes of the `gnrc_pktbuf_slab` implementation
+ *
+ * @details `gnrc_pktbuf_slab` splits the @ref GNRC_PKTBUF_SIZE bytes of the
+ *          packet buffer into a pool of packet snip descriptors, a pool of
+ *          fixed-size blocks for small headers (e.g. netif headers, UDP
+ *          headers, fragmentation headers), and a coalescing best-fit arena
+ *          for everything else. Allocations fall back to the arena when their
+ *          pool is exhausted.
+ * @{
+ */
+/**
+ * @brief   Number of packet snip descriptors in the snip pool
+ */
+#ifndef GNRC_PKTBUF_SLAB_SNIP_NUMOF
+#define GNRC_PKTBUF_SLAB_SNIP_NUMOF     (32U)
+#endif
+
+/**
+ * @brief   Maximum size in byte of data stored in the small block pool
+ */
+#ifndef GNRC_PKTBUF_SLAB_SMALL_SIZE
+#define GNRC_PKTBUF_SLAB_SMALL_SIZE     (32U)
+#endif
+
+/**
+ * @brief   Number of blocks in the small block pool
+ */
+#ifndef GNRC_PKTBUF_SLAB_SMALL_NUMOF
+#define GNRC_PKTBUF_SLAB_SMALL_NUMOF    (16U)
+#endif
+/** @} */
+
 /**
  * @brief   Initializes packet buffer module.
  */
@@ -281,7 +314,9 @@ gnrc_pktsnip_t *gnrc_pktbuf_duplicate_upto(gnrc_pktsnip_t *pkt, gnrc_nettype_t t
  *
  * @note    Only available with DEVELHELP defined.
  *
- * @details Statistics include maximum number of reserved bytes.
+ * @details Statistics include maximum number of reserved bytes. With
+ *          `gnrc_pktbuf_slab` they also include the usage and high-water
+ *          marks of each size class and the fragmentation of the arena.
  */
 void gnrc_pktbuf_stats(void);
 #endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_pkttrace Packet latency tracing
+ * @ingroup     net_gnrc
+ * @brief       Per-layer latency histograms of packets passing through GNRC
+ *
+ * A packet is stamped with the current time and the layer it is handed to
+ * whenever it is passed on with @ref gnrc_netapi_dispatch(),
+ * @ref gnrc_netapi_send() or @ref gnrc_netapi_receive(). The layer is the
+ * @ref gnrc_nettype_t dispatched to, or the type of the first snip for the
+ * functions addressing a thread. On every stamp, the time since the previous
+ * stamp is accounted to the layer of the previous stamp, i.e. it is the
+ * time the packet spent in the message queue and in processing of that
+ * layer. As the layers are accounted independent of the threads, this also
+ * works when several layers share a thread. Received packets are first
+ * stamped in the interrupt of their network device as held by
+ * @ref GNRC_NETTYPE_NETIF, so the time of the interface includes the
+ * interrupt latency. Sent packets are stamped a last time when the
+ * interface thread hands them to the device.
+ *
+ * The stamp is kept in the packet snip, so packets copied to new snips
+ * (e.g. by @ref gnrc_pktbuf_start_write()) or reassembled start a new trace.
+ * A stamp is only written to snips the caller owns alone. The receivers of a
+ * packet dispatched to several of them thus all account their latency from
+ * the stamp of the dispatch, and only restart the trace on snips they
+ * prepended or got with @ref gnrc_pktbuf_start_write().
+ *
+ * @{
+ *
+ * @file
+ * @brief       Packet latency tracing definitions
+ */
+#ifndef NET_GNRC_PKTTRACE_H
+#define NET_GNRC_PKTTRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net/gnrc/nettype.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of buckets of the latency histograms
+ *
+ * Bucket 0 counts latencies below 2 us, bucket i > 0 latencies in
+ * [2^i, 2^(i + 1)) us. The last bucket counts all longer latencies.
+ */
+#ifndef GNRC_PKTTRACE_BUCKETS
+#define GNRC_PKTTRACE_BUCKETS   (16U)
+#endif
+
+/**
+ * @brief   Trace state of a packet snip
+ */
+typedef struct {
+    uint32_t time;      /**< time of the last stamp in us */
+    int8_t layer;       /**< @ref gnrc_nettype_t holding the snip since */
+    bool valid;         /**< snip carries a stamp */
+} gnrc_pkttrace_t;
+
+/**
+ * @brief   Latency statistics of a layer
+ */
+typedef struct {
+    uint32_t count;                         /**< number of packets */
+    uint32_t sum;                           /**< sum of latencies in us */
+    uint32_t max;                           /**< maximum latency in us */
+    uint32_t hist[GNRC_PKTTRACE_BUCKETS];   /**< latency histogram */
+} gnrc_pkttrace_stats_t;
+
+/* forward declaration to avoid cyclic include with net/gnrc/pkt.h */
+struct gnrc_pktsnip;
+
+/**
+ * @brief   Starts a new trace of a packet
+ *
+ * @param[in,out] pkt   The packet
+ * @param[in] time      Time of the first stamp in us
+ * @param[in] layer     Layer holding the packet from then on
+ */
+void gnrc_pkttrace_start(struct gnrc_pktsnip *pkt, uint32_t time,
+                         gnrc_nettype_t layer);
+
+/**
+ * @brief   Stamps a packet when it is passed on to another layer
+ *
+ * Accounts the time since the last stamp of @p pkt to the layer of that
+ * stamp. Starts a new trace if @p pkt carries no stamp. Snips shared with
+ * other users are left as they are.
+ *
+ * @param[in,out] pkt   The packet
+ * @param[in] layer     Layer the packet is passed on to
+ */
+void gnrc_pkttrace_stamp(struct gnrc_pktsnip *pkt, gnrc_nettype_t layer);
+
+/**
+ * @brief   Gets the latency statistics of a layer
+ *
+ * @param[in] layer The layer
+ *
+ * @return  The statistics of @p layer
+ * @return  NULL if @p layer is invalid
+ */
+const gnrc_pkttrace_stats_t *gnrc_pkttrace_get(gnrc_nettype_t layer);
+
+/**
+ * @brief   Resets the statistics of all layers
+ */
+void gnrc_pkttrace_reset(void);
+
+/**
+ * @brief   Prints the statistics of all layers that held packets
+ */
+void gnrc_pkttrace_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_PKTTRACE_H */
+/** @} */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_single_thread Single-thread mode
+ * @ingroup     net_gnrc
+ * @brief       Runs the GNRC layers above the network interfaces in one
+ *              shared thread
+ *
+ * By default @ref net_gnrc_sixlowpan, @ref net_gnrc_ipv6 and
+ * @ref net_gnrc_udp each run in their own thread and a packet is passed
+ * between them with a message, costing a stack per layer and a context switch
+ * per hop. With this module the layers instead add themselves to one shared
+ * thread that runs an @ref sys_event queue:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_single_thread
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Each layer is registered at the @ref net_gnrc_netreg with a
+ * @ref net_gnrc_netapi_callbacks "callback". When a packet is dispatched to a
+ * layer from within the shared thread, the layer's handler is called directly.
+ * Otherwise, e.g. from a network interface or an application, the packet is
+ * put into the layer's queue and the layer is posted as event to the shared
+ * thread.
+ *
+ * Messages sent to the shared thread, e.g. from timers, are passed to the
+ * layer that registered their type. @ref net_gnrc_netapi messages sent to
+ * the thread directly are passed to the layer of @ref GNRC_NETTYPE_IPV6, as
+ * its PID is the only one of the layers known to other modules.
+ *
+ * @note    The network interfaces keep their own threads, as they handle
+ *          the interrupts of their devices.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Single-thread mode definitions
+ */
+#ifndef NET_GNRC_SINGLE_THREAD_H
+#define NET_GNRC_SINGLE_THREAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cib.h"
+#include "event.h"
+#include "kernel_types.h"
+#include "msg.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/nettype.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Stack size of the shared thread
+ *
+ * Dispatching a packet from one layer to the next calls the next layer's
+ * handler directly, so the stack must hold a path through all layers.
+ */
+#ifndef GNRC_SINGLE_THREAD_STACK_SIZE
+#define GNRC_SINGLE_THREAD_STACK_SIZE       (2 * THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the shared thread
+ */
+#ifndef GNRC_SINGLE_THREAD_PRIO
+#define GNRC_SINGLE_THREAD_PRIO             (THREAD_PRIORITY_MAIN - 4)
+#endif
+
+/**
+ * @brief   Message queue size of the shared thread
+ */
+#ifndef GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE
+#define GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE   (8U)
+#endif
+
+/**
+ * @brief   Number of packets a layer can queue, must be a power of 2
+ */
+#ifndef GNRC_SINGLE_THREAD_LAYER_QUEUE_SIZE
+#define GNRC_SINGLE_THREAD_LAYER_QUEUE_SIZE (8U)
+#endif
+
+/**
+ * @brief   Handler of a layer
+ *
+ * @param[in] msg   A @ref GNRC_NETAPI_MSG_TYPE_RCV or
+ *                  @ref GNRC_NETAPI_MSG_TYPE_SND command or a message sent to
+ *                  the shared thread
+ */
+typedef void (*gnrc_single_thread_handler_t)(msg_t *msg);
+
+/**
+ * @brief   A layer running in the shared thread
+ *
+ * @note    All members are private, the layer only provides the memory.
+ */
+typedef struct gnrc_single_thread_layer {
+    event_t super;                          /**< event posted to the thread */
+    struct gnrc_single_thread_layer *next;  /**< next layer in the thread */
+    gnrc_single_thread_handler_t handler;   /**< handler of the layer */
+    gnrc_netreg_entry_cbd_t cbd;            /**< netreg callback */
+    gnrc_netreg_entry_t entry;              /**< netreg entry */
+    gnrc_nettype_t type;                    /**< type the layer handles */
+    uint16_t msg_first;                     /**< first message type */
+    uint16_t msg_last;                      /**< last message type */
+    cib_t cib;                              /**< index of gnrc_single_thread_layer_t::queue */
+    /**
+     * @brief   commands queued for the layer
+     */
+    msg_t queue[GNRC_SINGLE_THREAD_LAYER_QUEUE_SIZE];
+    bool busy;                              /**< layer's handler is running */
+} gnrc_single_thread_layer_t;
+
+/**
+ * @brief   Adds a layer to the shared thread
+ *
+ * Starts the shared thread if it is not running yet.
+ *
+ * @param[out] layer    The layer to add, must stay valid
+ * @param[in] type      Type of the packets the layer handles
+ * @param[in] handler   Handler of the layer
+ * @param[in] msg_first First type of the messages to pass to the layer
+ * @param[in] msg_last  Last type of the messages to pass to the layer. Less
+ *                      than @p msg_first if the layer receives no messages
+ *
+ * @return  PID of the shared thread
+ */
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer,
+                                    gnrc_nettype_t type,
+                                    gnrc_single_thread_handler_t handler,
+                                    uint16_t msg_first, uint16_t msg_last);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_SINGLE_THREAD_H */
+/** @} */
@@ -38,6 +38,18 @@ extern "C" {
 #define GNRC_SIXLOWPAN_CTX_SIZE (16)    /**< maximum number of entries in
                                          *   context buffer */
 
+/**
+ * @brief   Number of addresses for which the result of
+ *          gnrc_sixlowpan_ctx_lookup_addr() is cached
+ *
+ * Saves the prefix matching against all contexts for the addresses of
+ * ongoing communication. The cache is flushed on every update of the context
+ * buffer.
+ */
+#ifndef GNRC_SIXLOWPAN_CTX_CACHE_SIZE
+#define GNRC_SIXLOWPAN_CTX_CACHE_SIZE   (4U)
+#endif
+
 /**
  * @{
  * @name    Context flags.
@@ -113,6 +125,18 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
                                                 uint8_t prefix_len, uint16_t ltime,
                                                 bool comp);
 
+/**
+ * @brief   Gets the version of the context buffer
+ *
+ * The version changes with every update of the context buffer, so results
+ * derived from the context buffer can be cached as long as it stays the
+ * same. Removal of a context does not change the version, check the context
+ * with gnrc_sixlowpan_ctx_lookup_id() instead.
+ *
+ * @return  The current version of the context buffer.
+ */
+uint32_t gnrc_sixlowpan_ctx_version(void);
+
 #ifdef MODULE_GNRC_SIXLOWPAN_CTX
 /**
  * @brief   Removes context.
@@ -50,6 +50,18 @@ extern "C" {
  * @brief   Message type for triggering garbage collection reassembly buffer
  */
 #define GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF     (0x0226)
+
+/**
+ * @brief   Message type for an acknowledgment timeout of
+ *          @ref net_gnrc_sixlowpan_frag_sfr
+ */
+#define GNRC_SIXLOWPAN_MSG_SFR_ARQ_TIMEOUT  (0x0227)
+
+/**
+ * @brief   Message type for triggering garbage collection of the reassembly
+ *          buffer of @ref net_gnrc_sixlowpan_frag_sfr
+ */
+#define GNRC_SIXLOWPAN_MSG_SFR_GC           (0x0228)
 /** @} */
 
 /**
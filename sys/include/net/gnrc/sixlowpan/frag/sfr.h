@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_sixlowpan_frag_sfr Selective fragment recovery
+ * @ingroup     net_gnrc_sixlowpan_frag
+ * @brief       Fragments datagrams with per-fragment acknowledgments
+ *
+ * With the classic fragmentation of @ref net_gnrc_sixlowpan_frag a single lost
+ * fragment loses the whole datagram, and it is only recovered when an upper
+ * layer sends it again after the reassembly buffer timed out. With
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_sixlowpan_frag_sfr
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * unicast datagrams are sent as recoverable fragments (RFRAG) instead. The
+ * sender keeps up to @ref GNRC_SIXLOWPAN_SFR_WIN_SIZE fragments in flight and
+ * requests an acknowledgment with the last of them. The receiver answers with
+ * a bitmap of the fragments it received (RFRAG-ACK), and the sender then
+ * sends only the missing fragments again, together with the next fragments
+ * of the datagram. Without an acknowledgment within
+ * @ref GNRC_SIXLOWPAN_SFR_ARQ_TIMEOUT the last fragment in flight is sent
+ * again to request one, up to @ref GNRC_SIXLOWPAN_SFR_FRAG_RETRIES times.
+ *
+ * Both ends of a link need this module. Multicast datagrams are still
+ * fragmented the classic way, as they are not acknowledged.
+ *
+ * Fragments that arrive before the first fragment of their datagram are
+ * reassembled as well. Until the first fragment tells the size of the
+ * datagram, its buffer only grows to the end of the furthest fragment, and
+ * the acknowledgments request the missing first fragment.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc8931">
+ *          RFC 8931
+ *      </a>
+ *
+ * @{
+ *
+ * @file
+ * @brief       Selective fragment recovery definitions
+ */
+#ifndef NET_GNRC_SIXLOWPAN_FRAG_SFR_H
+#define NET_GNRC_SIXLOWPAN_FRAG_SFR_H
+
+#include <stdint.h>
+
+#include "net/gnrc/netif.h"
+#include "net/gnrc/pkt.h"
+#include "net/sixlowpan.h"
+#include "timex.h"
+#include "xtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of fragments in flight before the sender waits for an
+ *          acknowledgment
+ *
+ * Must be less or equal to @ref SIXLOWPAN_SFR_SEQ_MAX + 1.
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_WIN_SIZE
+#define GNRC_SIXLOWPAN_SFR_WIN_SIZE         (8U)
+#endif
+
+/**
+ * @brief   Time in microseconds to wait for an acknowledgment
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_ARQ_TIMEOUT
+#define GNRC_SIXLOWPAN_SFR_ARQ_TIMEOUT      (700U * US_PER_MS)
+#endif
+
+/**
+ * @brief   Number of acknowledgment timeouts in a row before the datagram is
+ *          dropped
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_FRAG_RETRIES
+#define GNRC_SIXLOWPAN_SFR_FRAG_RETRIES     (2U)
+#endif
+
+/**
+ * @brief   Number of datagrams that can be sent at the same time
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_FBUF_SIZE
+#define GNRC_SIXLOWPAN_SFR_FBUF_SIZE        (2U)
+#endif
+
+/**
+ * @brief   Number of datagrams that can be reassembled at the same time
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_RBUF_SIZE
+#define GNRC_SIXLOWPAN_SFR_RBUF_SIZE        (4U)
+#endif
+
+/**
+ * @brief   Timeout of a reassembly in microseconds
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT
+#define GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT     (3U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Maximum size in bytes of a datagram that is reassembled
+ *
+ * Larger datagrams are dropped before any space is allocated for them.
+ * Defaults to the maximum of the classic 6LoWPAN fragmentation.
+ */
+#ifndef GNRC_SIXLOWPAN_SFR_DATAGRAM_MAX
+#define GNRC_SIXLOWPAN_SFR_DATAGRAM_MAX     (SIXLOWPAN_FRAG_SIZE_MASK)
+#endif
+
+/**
+ * @brief   A datagram that is sent
+ */
+typedef struct {
+    gnrc_pktsnip_t *pkt;    /**< compressed datagram with its netif header */
+    xtimer_t arq_timer;     /**< acknowledgment timer */
+    msg_t arq_msg;          /**< message of gnrc_sixlowpan_frag_sfr_fbuf_t::arq_timer */
+    uint32_t acked;         /**< acknowledged fragments, bit 31 is sequence 0 */
+    uint16_t datagram_size; /**< size of the compressed datagram */
+    uint16_t frag_size;     /**< size of all fragments but the last */
+    uint8_t tag;            /**< datagram tag */
+    uint8_t frags;          /**< number of fragments */
+    uint8_t sent;           /**< number of fragments sent so far */
+    uint8_t retries;        /**< retries since the last acknowledgment */
+} gnrc_sixlowpan_frag_sfr_fbuf_t;
+
+/**
+ * @brief   Sends a datagram as recoverable fragments
+ *
+ * @param[in] pkt       A compressed datagram with its netif header. The
+ *                      destination must be a unicast address.
+ * @param[in] netif     The interface to send over.
+ *
+ * @return  0, if the sending started. @p pkt is released when all fragments
+ *          were acknowledged or the sending failed.
+ * @return  -ENOBUFS, if no more datagrams can be sent at the moment.
+ * @return  -EMSGSIZE, if @p pkt does not fit into
+ *          @ref SIXLOWPAN_SFR_SEQ_MAX + 1 fragments.
+ */
+int gnrc_sixlowpan_frag_sfr_send(gnrc_pktsnip_t *pkt, gnrc_netif_t *netif);
+
+/**
+ * @brief   Handles a packet containing an RFRAG or RFRAG-ACK header
+ *
+ * @param[in] pkt   The packet to handle.
+ */
+void gnrc_sixlowpan_frag_sfr_handle_pkt(gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Handles an acknowledgment timeout
+ *
+ * @param[in] fbuf  The datagram whose acknowledgment timed out.
+ */
+void gnrc_sixlowpan_frag_sfr_arq_timeout(gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf);
+
+/**
+ * @brief   Removes timed out reassemblies
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_SFR_GC, which a timer sends as long as
+ * datagrams are reassembled.
+ */
+void gnrc_sixlowpan_frag_sfr_gc(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_SIXLOWPAN_FRAG_SFR_H */
+/** @} */
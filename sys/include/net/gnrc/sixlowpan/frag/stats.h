@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_sixlowpan_frag_stats Fragmentation statistics
+ * @ingroup     net_gnrc_sixlowpan_frag
+ * @brief       Counts events of the 6LoWPAN reassembly buffer
+ *
+ * With
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_sixlowpan_frag_stats
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * the reassembly buffer counts why it lost datagrams, which helps to tune
+ * its size for a network.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Fragmentation statistics definitions
+ */
+#ifndef NET_GNRC_SIXLOWPAN_FRAG_STATS_H
+#define NET_GNRC_SIXLOWPAN_FRAG_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Statistics of the reassembly buffer
+ */
+typedef struct {
+    uint32_t datagrams; /**< datagrams reassembled */
+    uint32_t evictions; /**< reassemblies removed to make room for new ones */
+    uint32_t timeouts;  /**< reassemblies that timed out */
+    uint32_t overlaps;  /**< reassemblies restarted due to overlapping fragments */
+} gnrc_sixlowpan_frag_stats_t;
+
+/**
+ * @brief   Gets the statistics of the reassembly buffer
+ *
+ * @return  The statistics, may be reset by the caller.
+ */
+gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_SIXLOWPAN_FRAG_STATS_H */
+/** @} */
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_sixlowpan_frag_vrb Virtual reassembly buffer
+ * @ingroup     net_gnrc_sixlowpan_frag
+ * @brief       Forwards 6LoWPAN fragments without reassembling the datagram
+ *
+ * Without this module a router reassembles every fragmented datagram before
+ * @ref net_gnrc_ipv6 forwards it and fragments it again for the next hop.
+ * With
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_sixlowpan_frag_vrb
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * only the IPHC header of the first fragment is decoded to look up the next
+ * hop. The first fragment is then recompressed for the next hop and sent with
+ * a new datagram tag, and an entry mapping the source and tag of the datagram
+ * to the next hop and the new tag is added to the virtual reassembly buffer.
+ * The subsequent fragments are switched by that entry, only their tag is
+ * rewritten.
+ *
+ * Datagrams for this node, multicast datagrams and datagrams without a known
+ * next hop on a 6LoWPAN interface are reassembled as before. So are the
+ * subsequent fragments that arrive before the first fragment of their
+ * datagram.
+ *
+ * @see <a href="https://tools.ietf.org/html/draft-ietf-lwig-6lowpan-virtual-reassembly-00">
+ *          draft-ietf-lwig-6lowpan-virtual-reassembly-00
+ *      </a>
+ *
+ * @{
+ *
+ * @file
+ * @brief       Virtual reassembly buffer definitions
+ */
+#ifndef NET_GNRC_SIXLOWPAN_FRAG_VRB_H
+#define NET_GNRC_SIXLOWPAN_FRAG_VRB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "kernel_types.h"
+#include "net/sixlowpan.h"
+#include "timex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of datagrams that can be forwarded at the same time
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_SIZE
+#define GNRC_SIXLOWPAN_FRAG_VRB_SIZE        (16U)
+#endif
+
+/**
+ * @brief   Timeout of an entry in microseconds
+ *
+ * An entry times out when no fragment of its datagram was forwarded for this
+ * long. Timed out entries are removed when they are looked up, when space for
+ * a new entry is searched, and by gnrc_sixlowpan_frag_vrb_gc().
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT
+#define GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT     (3U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Maximum length of the link-layer addresses
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX_LEN  (8U)
+
+/**
+ * @brief   Granularity in bytes in which the forwarded part of a datagram is
+ *          tracked
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE       (8U)
+
+/**
+ * @brief   Number of units of @ref GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE in the
+ *          largest datagram
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_UNITS \
+    ((SIXLOWPAN_FRAG_SIZE_MASK + GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE) / \
+     GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE)
+
+/**
+ * @brief   An entry of the virtual reassembly buffer
+ *
+ * The datagram is identified by gnrc_sixlowpan_frag_vrb_t::src,
+ * gnrc_sixlowpan_frag_vrb_t::datagram_size and
+ * gnrc_sixlowpan_frag_vrb_t::in_tag.
+ */
+typedef struct {
+    uint32_t arrival;           /**< time in microseconds of the last fragment */
+    /**
+     * @brief   link-layer source address of the datagram
+     */
+    uint8_t src[GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX_LEN];
+    /**
+     * @brief   link-layer address of the next hop
+     */
+    uint8_t out_dst[GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX_LEN];
+    uint8_t src_len;            /**< length of gnrc_sixlowpan_frag_vrb_t::src */
+    uint8_t out_dst_len;        /**< length of gnrc_sixlowpan_frag_vrb_t::out_dst */
+    kernel_pid_t out_netif;     /**< interface to the next hop */
+    uint16_t datagram_size;     /**< size of the datagram, 0 if entry is unused */
+    uint16_t in_tag;            /**< tag of the received fragments */
+    uint16_t out_tag;           /**< tag of the forwarded fragments */
+    uint16_t forwarded_numof;   /**< number of units forwarded so far */
+    /**
+     * @brief   forwarded units of the datagram, counted in uncompressed bytes
+     *          like the fragment offsets
+     */
+    BITFIELD(forwarded, GNRC_SIXLOWPAN_FRAG_VRB_UNITS);
+} gnrc_sixlowpan_frag_vrb_t;
+
+/**
+ * @brief   Adds an entry to the virtual reassembly buffer
+ *
+ * An existing entry for the same datagram is replaced. No unit of the datagram
+ * is marked forwarded in the added entry.
+ *
+ * @pre `(entry != NULL) && (entry->datagram_size > 0)`
+ *
+ * @param[in] entry     The entry to add, is copied.
+ *
+ * @return  The entry in the buffer.
+ * @return  NULL, if the buffer is full.
+ */
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_add(
+        const gnrc_sixlowpan_frag_vrb_t *entry);
+
+/**
+ * @brief   Gets the entry of a datagram
+ *
+ * A timed out entry is removed instead.
+ *
+ * @param[in] src           Link-layer source address of the datagram.
+ * @param[in] src_len       Length of @p src.
+ * @param[in] datagram_size Size of the datagram.
+ * @param[in] tag           Tag of the received fragments of the datagram.
+ *
+ * @return  The entry of the datagram.
+ * @return  NULL, if there is none.
+ */
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_get(const uint8_t *src,
+                                                       size_t src_len,
+                                                       unsigned datagram_size,
+                                                       unsigned tag);
+
+/**
+ * @brief   Removes an entry from the virtual reassembly buffer
+ *
+ * @param[in] entry     The entry to remove.
+ */
+static inline void gnrc_sixlowpan_frag_vrb_rm(gnrc_sixlowpan_frag_vrb_t *entry)
+{
+    entry->datagram_size = 0;
+}
+
+/**
+ * @brief   Marks a fragment of a datagram as forwarded
+ *
+ * Also restarts the timeout of the entry.
+ *
+ * @param[in] entry     The entry of the datagram.
+ * @param[in] offset    Offset of the fragment in the uncompressed datagram.
+ * @param[in] size      Uncompressed size of the fragment.
+ *
+ * @return  Number of units of the fragment that were not forwarded before,
+ *          0 for a duplicate.
+ */
+unsigned gnrc_sixlowpan_frag_vrb_mark(gnrc_sixlowpan_frag_vrb_t *entry,
+                                      size_t offset, size_t size);
+
+/**
+ * @brief   Checks if all units of a datagram were forwarded
+ *
+ * @param[in] entry     The entry of the datagram.
+ *
+ * @return  true, if the whole datagram was forwarded.
+ */
+static inline bool gnrc_sixlowpan_frag_vrb_complete(
+        const gnrc_sixlowpan_frag_vrb_t *entry)
+{
+    return entry->forwarded_numof >=
+           ((entry->datagram_size + GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE - 1) /
+            GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE);
+}
+
+/**
+ * @brief   Removes timed out entries
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, not needed for correctness.
+ */
+void gnrc_sixlowpan_frag_vrb_gc(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_SIXLOWPAN_FRAG_VRB_H */
+/** @} */
@@ -29,6 +29,21 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of flows whose address compression is remembered
+ *
+ * With the `gnrc_sixlowpan_iphc_flow` module, the compressed addresses of
+ * the last flows, identified by their interface, link-layer and IPv6
+ * addresses, are kept, so gnrc_sixlowpan_iphc_encode() only copies them for
+ * further datagrams of a flow. This saves the context lookups and, for
+ * addresses derived from the interface identifier of the interface, asking
+ * the interface for it. A flow is compressed again when the context buffer
+ * changed.
+ */
+#ifndef GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF
+#define GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF  (4U)
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
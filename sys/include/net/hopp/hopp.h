@@ -9,7 +9,12 @@
 #ifndef HOPP_H
 #define HOPP_H
 
+#include "bitfield.h"
 #include "compas/routing/dodag.h"
+#include "evtimer_msg.h"
+#include "mutex.h"
+#include "net/gnrc/netif.h"
+#include "net/hopp/nam_idx.h"
 #include "thread.h"
 
 #ifndef HOPP_STACKSZ
@@ -77,28 +82,130 @@
 #ifndef HOPP_STOP_MSG
 #define HOPP_STOP_MSG               (0xBFF6)
 #endif
+#ifndef HOPP_NAM_AGGR_MSG
+#define HOPP_NAM_AGGR_MSG           (0xBFF7)
+#endif
+#ifndef HOPP_NAM_WHEEL_MSG
+#define HOPP_NAM_WHEEL_MSG          (0xBFF8)
+#endif
+
+/* NAM retransmission wheel: granularity in ms and number of buckets. The
+ * wheel spans HOPP_NAM_WHEEL_TICK * (HOPP_NAM_WHEEL_SLOTS - 1) ms, which must
+ * cover HOPP_NAM_PERIOD */
+#ifndef HOPP_NAM_WHEEL_TICK
+#define HOPP_NAM_WHEEL_TICK         (100)
+#endif
+#ifndef HOPP_NAM_WHEEL_SLOTS
+#define HOPP_NAM_WHEEL_SLOTS        (32)
+#endif
+
+/* NAM aggregation (module hopp_nam_aggr): names that become due within
+ * HOPP_NAM_AGGR_WINDOW ms are sent together in as few frames as possible */
+#ifndef HOPP_NAM_AGGR_WINDOW
+#define HOPP_NAM_AGGR_WINDOW        (50)
+#endif
+/* frame payload limit if the interface does not report NETOPT_MAX_PACKET_SIZE */
+#ifndef HOPP_NAM_AGGR_MAX_LEN
+#define HOPP_NAM_AGGR_MAX_LEN       (80)
+#endif
 
 #ifndef HOPP_NAM_STALE_TIME
 #define HOPP_NAM_STALE_TIME         (10 * US_PER_SEC)
 #endif
 
+/* number of counters of the content store membership filter */
+#ifndef HOPP_CS_FILTER_LEN
+#define HOPP_CS_FILTER_LEN          (256)
+#endif
+
 #ifndef HOPP_INTEREST_BUFSIZE
 #define HOPP_INTEREST_BUFSIZE       (64)
 #endif
 
-extern char hopp_stack[HOPP_STACKSZ];
-extern gnrc_netif_t *hopp_netif;
-extern kernel_pid_t hopp_pid;
-extern compas_dodag_t dodag;
+struct ccnl_relay_s;
+struct ccnl_pkt_s;
+struct ccnl_face_s;
+
+/* name/content pair for hopp_publish_contents() */
+typedef struct {
+    const char *name;
+    size_t name_len;
+    unsigned char *content;
+    size_t content_len;
+} hopp_publish_item_t;
 
 typedef void (*hopp_cb_published)(struct ccnl_relay_s *relay,
                                   struct ccnl_pkt_s *pkt,
                                   struct ccnl_face_s *from);
 
-void *hopp(void *arg);
-void hopp_root_start(const char *prefix, size_t prefix_len);
-bool hopp_publish_content(const char *name, size_t name_len,
+/* retransmission wheel for NAMs: one bucket per HOPP_NAM_WHEEL_TICK ms and
+ * one doubly linked list of NAM cache slots per bucket, so arming and
+ * cancelling the NAM timer of a cache entry is O(1) and only the wheel itself
+ * occupies the evtimer */
+typedef struct {
+    uint16_t head[HOPP_NAM_WHEEL_SLOTS];
+    uint16_t next[COMPAS_NAM_CACHE_LEN];
+    uint16_t prev[COMPAS_NAM_CACHE_LEN];
+    uint8_t bucket[COMPAS_NAM_CACHE_LEN];   /* HOPP_NAM_WHEEL_SLOTS if idle */
+    uint16_t armed;
+    uint8_t cur;
+    bool running;
+} hopp_nam_wheel_t;
+
+/* State of one HoPP instance. Every instance runs its own thread and DODAG
+ * on one network interface, so a relay with several interfaces runs one
+ * instance per interface. All members are private to hopp.c. */
+typedef struct hopp {
+    struct hopp *next;
+    gnrc_netif_t *netif;
+    struct ccnl_relay_s *relay;
+    struct ccnl_face_s *loopback_face;
+    kernel_pid_t pid;
+    compas_dodag_t dodag;
+    mutex_t lock;                   /* guards NAM cache and index */
+    msg_t q[HOPP_QSZ];
+    evtimer_msg_t evtimer;
+    evtimer_msg_event_t sol_msg_evt;
+    evtimer_msg_event_t pam_msg_evt;
+    evtimer_msg_event_t pto_msg_evt;
+    uint32_t nce_times[COMPAS_NAM_CACHE_LEN];
+    hopp_nam_wheel_t nam_wheel;
+    evtimer_msg_event_t nam_wheel_evt;
+    hopp_nam_idx_bucket_t nam_idx_buckets[HOPP_NAM_IDX_LEN];
+    hopp_nam_idx_t nam_idx;
+#ifdef MODULE_HOPP_NAM_AGGR
+    evtimer_msg_event_t nam_aggr_evt;
+    BITFIELD(nam_pending, COMPAS_NAM_CACHE_LEN);
+    bool nam_aggr_armed;
+    uint16_t nam_aggr_max_len;
+#endif
+    hopp_cb_published cb_published;
+} hopp_t;
+
+/* Initializes hopp and starts its thread on netif, using relay as
+ * forwarder. Returns the PID of the thread or a negative errno from
+ * thread_create(). */
+kernel_pid_t hopp_create(hopp_t *hopp, char *stack, int stacksize,
+                         char priority, const char *name, gnrc_netif_t *netif,
+                         struct ccnl_relay_s *relay);
+void hopp_root_start(hopp_t *hopp, const char *prefix, size_t prefix_len);
+bool hopp_publish_content(hopp_t *hopp, const char *name, size_t name_len,
                           unsigned char *content, size_t content_len);
-void hopp_set_cb_published(hopp_cb_published cb);
+/* Publishes a batch of contents without blocking: stops at the first item
+ * that can not be handed to CCN-lite or added to the NAM cache, and
+ * announces all published names with a single message to the HoPP thread.
+ * Returns the number of items published from the start of items. */
+size_t hopp_publish_contents(hopp_t *hopp, const hopp_publish_item_t *items,
+                             size_t items_numof);
+void hopp_set_cb_published(hopp_t *hopp, hopp_cb_published cb);
+/* Content store insert and evict hooks for the membership filter that
+ * check_nce() consults before asking the CCN-lite thread. HoPP adds the
+ * names it publishes and receives itself. Applications that add contents to
+ * the content store on their own must add their names as well.
+ * hopp_cs_remove() must only be called for a name added before. CCN-lite
+ * reports no evictions, so contents that leave the store stay in the filter
+ * until removed this way and only cost the exact query. */
+void hopp_cs_add(const char *name, size_t name_len);
+void hopp_cs_remove(const char *name, size_t name_len);
 
 #endif /* HOPP_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_hopp_nam_idx   HoPP NAM cache index
+ * @ingroup     net
+ * @brief       Hashed name index over the NAM cache of a DODAG
+ *
+ * The index maps the hash of a name to the slot of the corresponding
+ * @ref compas_nam_cache_entry_t in the NAM cache. Collisions are resolved
+ * with linear probing and backward-shift deletion, so no tombstones
+ * accumulate. The index never moves cache entries: a slot number returned
+ * by the index is the position of the entry in the cache array and can be
+ * used to address per-slot state kept alongside the cache.
+ *
+ * @{
+ *
+ * @file
+ * @brief   HoPP NAM cache index definitions
+ */
+#ifndef NET_HOPP_NAM_IDX_H
+#define NET_HOPP_NAM_IDX_H
+
+#include <stdint.h>
+
+#include "compas/routing/nam.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of buckets of the index used by HoPP
+ *
+ * @note    Should be at least twice @ref COMPAS_NAM_CACHE_LEN to keep the
+ *          probe sequences short.
+ */
+#ifndef HOPP_NAM_IDX_LEN
+#define HOPP_NAM_IDX_LEN        (2 * COMPAS_NAM_CACHE_LEN)
+#endif
+
+/**
+ * @brief   Slot value marking an empty bucket
+ */
+#define HOPP_NAM_IDX_EMPTY      (UINT16_MAX)
+
+/**
+ * @brief   A bucket of the index
+ */
+typedef struct {
+    uint16_t tag;               /**< upper half of the name hash */
+    uint16_t slot;              /**< slot in the NAM cache or
+                                 *   @ref HOPP_NAM_IDX_EMPTY */
+} hopp_nam_idx_bucket_t;
+
+/**
+ * @brief   A NAM cache index
+ */
+typedef struct {
+    hopp_nam_idx_bucket_t *buckets;     /**< bucket array */
+    compas_nam_cache_entry_t *cache;    /**< indexed NAM cache */
+    uint16_t buckets_numof;             /**< number of buckets */
+    uint16_t cache_len;                 /**< number of entries in cache */
+} hopp_nam_idx_t;
+
+/**
+ * @brief   Initializes an empty index
+ *
+ * @param[out] idx              The index
+ * @param[in] buckets           Bucket array of the index
+ * @param[in] buckets_numof     Number of buckets in @p buckets. Must be
+ *                              greater than @p cache_len
+ * @param[in] cache             The NAM cache to index
+ * @param[in] cache_len         Number of entries in @p cache
+ */
+void hopp_nam_idx_init(hopp_nam_idx_t *idx, hopp_nam_idx_bucket_t *buckets,
+                       uint16_t buckets_numof,
+                       compas_nam_cache_entry_t *cache, uint16_t cache_len);
+
+/**
+ * @brief   Re-creates the index from all entries of the cache that are in use
+ *
+ * @param[in,out] idx   The index
+ */
+void hopp_nam_idx_rebuild(hopp_nam_idx_t *idx);
+
+/**
+ * @brief   Adds a cache entry to the index
+ *
+ * @pre The name of the cache entry at @p slot is already set.
+ *
+ * @param[in,out] idx   The index
+ * @param[in] slot      Slot of the entry in the cache
+ *
+ * @return  0 on success
+ * @return  -ENOSPC if there is no free bucket left
+ */
+int hopp_nam_idx_add(hopp_nam_idx_t *idx, uint16_t slot);
+
+/**
+ * @brief   Removes a cache entry from the index
+ *
+ * @pre The name of the cache entry at @p slot is still set.
+ *
+ * @param[in,out] idx   The index
+ * @param[in] slot      Slot of the entry in the cache
+ */
+void hopp_nam_idx_del(hopp_nam_idx_t *idx, uint16_t slot);
+
+/**
+ * @brief   Looks up a cache entry by name
+ *
+ * @param[in] idx   The index
+ * @param[in] name  The name to search for
+ *
+ * @return  The cache entry with name @p name
+ * @return  NULL if no cache entry with name @p name is in use
+ */
+compas_nam_cache_entry_t *hopp_nam_idx_find(const hopp_nam_idx_t *idx,
+                                            const compas_name_t *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_HOPP_NAM_IDX_H */
+/** @} */
@@ -141,6 +141,176 @@ static inline bool sixlowpan_frag_is(sixlowpan_frag_t *hdr)
 }
 /** @} */
 
+/**
+ * @name    6LoWPAN selective fragment recovery header definitions
+ * @see     <a href="https://tools.ietf.org/html/rfc8931#section-5">
+ *              RFC 8931, section 5
+ *          </a>
+ * @{
+ */
+#define SIXLOWPAN_SFR_DISP_MASK     (0xfe)      /**< mask for SFR dispatches */
+#define SIXLOWPAN_SFR_RFRAG_DISP    (0xe8)      /**< dispatch for RFRAG */
+#define SIXLOWPAN_SFR_ACK_DISP      (0xea)      /**< dispatch for RFRAG-ACK */
+#define SIXLOWPAN_SFR_ECN           (0x01)      /**< explicit congestion
+                                                 *   notification flag */
+#define SIXLOWPAN_SFR_ACK_REQ       (0x80)      /**< acknowledgment request
+                                                 *   flag in the first byte of
+                                                 *   sixlowpan_sfr_rfrag_t::ar_seq_fs */
+#define SIXLOWPAN_SFR_SEQ_POS       (10U)       /**< position of the sequence
+                                                 *   number */
+#define SIXLOWPAN_SFR_SEQ_MASK      (0x7c00)    /**< mask for sequence number */
+#define SIXLOWPAN_SFR_SEQ_MAX       (31U)       /**< maximum sequence number */
+#define SIXLOWPAN_SFR_FRAG_SIZE_MASK    (0x03ff)    /**< mask for fragment size */
+#define SIXLOWPAN_SFR_ACK_BITMAP_SIZE   (4U)        /**< size of the bitmap of
+                                                     *   an RFRAG-ACK */
+
+/**
+ * @brief   Generic SFR header
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t disp_ecn;   /**< dispatch and ECN flag */
+    uint8_t tag;        /**< datagram tag */
+} sixlowpan_sfr_t;
+
+/**
+ * @brief   Recoverable fragment (RFRAG) header
+ *
+ * @extends sixlowpan_sfr_t
+ */
+typedef struct __attribute__((packed)) {
+    sixlowpan_sfr_t base;       /**< generic SFR header */
+    /**
+     * @brief   Acknowledgment request flag, sequence number and fragment size
+     */
+    network_uint16_t ar_seq_fs;
+    /**
+     * @brief   Offset of the fragment in the compressed datagram
+     *
+     * @details Size of the compressed datagram in the first fragment
+     *          (sequence number 0).
+     */
+    network_uint16_t offset;
+} sixlowpan_sfr_rfrag_t;
+
+/**
+ * @brief   RFRAG acknowledgment (RFRAG-ACK) header
+ *
+ * @extends sixlowpan_sfr_t
+ */
+typedef struct __attribute__((packed)) {
+    sixlowpan_sfr_t base;       /**< generic SFR header */
+    /**
+     * @brief   Received fragments, bit 7 of the first byte is sequence 0
+     */
+    uint8_t bitmap[SIXLOWPAN_SFR_ACK_BITMAP_SIZE];
+} sixlowpan_sfr_ack_t;
+
+/**
+ * @brief   Checks if a given header is an RFRAG header
+ *
+ * @param[in] hdr   A 6LoWPAN frame.
+ *
+ * @return  true, if @p hdr is an RFRAG header.
+ * @return  false, if @p hdr is not an RFRAG header.
+ */
+static inline bool sixlowpan_sfr_rfrag_is(const sixlowpan_sfr_t *hdr)
+{
+    return ((hdr->disp_ecn & SIXLOWPAN_SFR_DISP_MASK) ==
+            SIXLOWPAN_SFR_RFRAG_DISP);
+}
+
+/**
+ * @brief   Checks if a given header is an RFRAG-ACK header
+ *
+ * @param[in] hdr   A 6LoWPAN frame.
+ *
+ * @return  true, if @p hdr is an RFRAG-ACK header.
+ * @return  false, if @p hdr is not an RFRAG-ACK header.
+ */
+static inline bool sixlowpan_sfr_ack_is(const sixlowpan_sfr_t *hdr)
+{
+    return ((hdr->disp_ecn & SIXLOWPAN_SFR_DISP_MASK) ==
+            SIXLOWPAN_SFR_ACK_DISP);
+}
+
+/**
+ * @brief   Checks if a given header is an SFR header
+ *
+ * @param[in] hdr   A 6LoWPAN frame.
+ *
+ * @return  true, if @p hdr is an RFRAG or RFRAG-ACK header.
+ * @return  false, if @p hdr is not an SFR header.
+ */
+static inline bool sixlowpan_sfr_is(const sixlowpan_sfr_t *hdr)
+{
+    return sixlowpan_sfr_rfrag_is(hdr) || sixlowpan_sfr_ack_is(hdr);
+}
+
+/**
+ * @brief   Initializes an RFRAG header
+ *
+ * @param[out] hdr      An RFRAG header.
+ * @param[in] tag       Datagram tag.
+ * @param[in] seq       Sequence number, less or equal to
+ *                      @ref SIXLOWPAN_SFR_SEQ_MAX.
+ * @param[in] frag_size Fragment size without the header.
+ * @param[in] offset    Offset of the fragment or the datagram size if @p seq
+ *                      is 0.
+ * @param[in] ack_req   Request an acknowledgment.
+ */
+static inline void sixlowpan_sfr_rfrag_set(sixlowpan_sfr_rfrag_t *hdr,
+                                           uint8_t tag, uint8_t seq,
+                                           uint16_t frag_size, uint16_t offset,
+                                           bool ack_req)
+{
+    hdr->base.disp_ecn = SIXLOWPAN_SFR_RFRAG_DISP;
+    hdr->base.tag = tag;
+    hdr->ar_seq_fs = byteorder_htons((seq << SIXLOWPAN_SFR_SEQ_POS) |
+                                     (frag_size & SIXLOWPAN_SFR_FRAG_SIZE_MASK));
+    if (ack_req) {
+        hdr->ar_seq_fs.u8[0] |= SIXLOWPAN_SFR_ACK_REQ;
+    }
+    hdr->offset = byteorder_htons(offset);
+}
+
+/**
+ * @brief   Checks if an RFRAG requests an acknowledgment
+ *
+ * @param[in] hdr   An RFRAG header.
+ *
+ * @return  true, if an acknowledgment is requested.
+ */
+static inline bool sixlowpan_sfr_rfrag_ack_req(const sixlowpan_sfr_rfrag_t *hdr)
+{
+    return (hdr->ar_seq_fs.u8[0] & SIXLOWPAN_SFR_ACK_REQ);
+}
+
+/**
+ * @brief   Gets the sequence number of an RFRAG
+ *
+ * @param[in] hdr   An RFRAG header.
+ *
+ * @return  The sequence number.
+ */
+static inline unsigned sixlowpan_sfr_rfrag_get_seq(const sixlowpan_sfr_rfrag_t *hdr)
+{
+    return (byteorder_ntohs(hdr->ar_seq_fs) & SIXLOWPAN_SFR_SEQ_MASK) >>
+           SIXLOWPAN_SFR_SEQ_POS;
+}
+
+/**
+ * @brief   Gets the fragment size of an RFRAG
+ *
+ * @param[in] hdr   An RFRAG header.
+ *
+ * @return  The size of the fragment without the header.
+ */
+static inline unsigned sixlowpan_sfr_rfrag_get_frag_size(const sixlowpan_sfr_rfrag_t *hdr)
+{
+    return byteorder_ntohs(hdr->ar_seq_fs) & SIXLOWPAN_SFR_FRAG_SIZE_MASK;
+}
+/** @} */
+
 /**
  * @name    6LoWPAN IPHC dispatch definitions
  * @{
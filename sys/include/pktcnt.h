@@ -21,6 +21,7 @@
 #ifndef PKTCNT_H
 #define PKTCNT_H
 
+#include <stdatomic.h>
 #include <stdint.h>
 
 #include "net/gnrc/pkt.h"
@@ -37,15 +38,87 @@ extern uint32_t tx_data;
 extern uint32_t rx_interest;
 extern uint32_t rx_data;
 extern uint32_t netdev_evt_tx_noack;
-extern uint32_t tx_pam;
-extern uint32_t tx_nam;
-extern uint32_t tx_sol;
-extern uint32_t rx_nam;
-extern uint32_t rx_pam;
-extern uint32_t rx_sol;
+/* HoPP counters, atomic since every HoPP instance runs in a thread of its
+ * own */
+extern atomic_uint_least32_t tx_pam;
+extern atomic_uint_least32_t tx_nam;
+extern atomic_uint_least32_t tx_nam_names;  /* names sent in all NAMs */
+extern atomic_uint_least32_t tx_sol;
+extern atomic_uint_least32_t rx_nam;
+extern atomic_uint_least32_t rx_pam;
+extern atomic_uint_least32_t rx_sol;
 void pktcnt_fast_print(void);
 #endif
 
+#ifdef MODULE_PKTCNT_BIN
+/* binary logging (module pktcnt_bin): instead of printing, the logging paths
+ * append compact records to a ring buffer that a low-priority thread writes
+ * out as "PKTB <hex>" lines. dist/tools/pktcnt/pktcnt_decode.py turns them
+ * back into the text format. */
+#ifndef PKTCNT_BIN_BUFSIZE
+#define PKTCNT_BIN_BUFSIZE      (1024)  /* must be a power of 2 */
+#endif
+#ifndef PKTCNT_BIN_PRIO
+#define PKTCNT_BIN_PRIO         (THREAD_PRIORITY_IDLE - 1)
+#endif
+#ifndef PKTCNT_BIN_STACKSIZE
+#define PKTCNT_BIN_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#endif
+#define PKTCNT_BIN_ADDR_MAX     (8)
+#ifndef PKTCNT_BIN_NAME_MAX
+#define PKTCNT_BIN_NAME_MAX     (32)
+#endif
+
+/* record types */
+enum {
+    PKTCNT_BIN_PKT_TX = 0,
+    PKTCNT_BIN_PKT_RX,
+    PKTCNT_BIN_FWD,
+};
+
+/* protocol of a record, selects the meaning of code, code2, id and id2 */
+enum {
+    PKTCNT_BIN_PROTO_UNKNOWN = 0,
+    PKTCNT_BIN_PROTO_NFRAG,     /* 6LoWPAN subsequent fragment */
+    PKTCNT_BIN_PROTO_UDP,       /* id: source port, id2: destination port */
+    PKTCNT_BIN_PROTO_COAP,      /* code: code, id: message ID */
+    PKTCNT_BIN_PROTO_MQTT,      /* code: type, id: message ID */
+    PKTCNT_BIN_PROTO_ICMPV6,    /* code: type, code2: code */
+    PKTCNT_BIN_PROTO_NDN,       /* code: type, name */
+    PKTCNT_BIN_PROTO_HOPP,      /* code: type, id: rank or name */
+};
+
+#define PKTCNT_BIN_FLAG_BCAST   (0x01)  /* sent to broadcast or multicast */
+#define PKTCNT_BIN_FLAG_ID      (0x02)  /* id is set */
+
+/* all multi-byte fields in host byte order */
+typedef struct __attribute__((packed)) {
+    uint8_t len;            /* length of the record including data */
+    uint8_t type;
+    uint8_t proto;
+    uint8_t flags;
+    uint64_t time;          /* in us */
+    uint16_t size;          /* packet size */
+    uint8_t seq;            /* link-layer sequence number */
+    uint8_t code;
+    uint8_t code2;
+    uint16_t id;
+    uint16_t id2;
+    uint8_t src_len;        /* source address at start of data */
+    uint8_t dst_len;        /* followed by destination address */
+    uint8_t name_len;       /* followed by the name */
+    uint8_t data[2 * PKTCNT_BIN_ADDR_MAX + PKTCNT_BIN_NAME_MAX];
+} pktcnt_bin_rec_t;
+
+extern uint32_t pktcnt_bin_lost;   /* records dropped on a full buffer */
+
+/* Starts the drain thread, called by pktcnt_init(). Records written before
+ * stay in the buffer. */
+int pktcnt_bin_init(void);
+/* Appends rec, sets rec->len. Callable from any thread. */
+void pktcnt_bin_write(pktcnt_bin_rec_t *rec);
+#endif
+
 enum {
     PKTCNT_OK = 0,
     PKTCNT_ERR_INIT = -1,
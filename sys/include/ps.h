@@ -32,6 +32,19 @@ extern "C" {
  */
 void ps(void);
 
+#if defined(MODULE_SCHEDPROF) || defined(DOXYGEN)
+/**
+ * @brief Print the wakeup-to-run latency and run time histograms of all
+ *        active threads to stdout.
+ */
+void ps_profile(void);
+
+/**
+ * @brief Clear the latency and run time histograms of all threads.
+ */
+void ps_profile_reset(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_spscrb Single-producer single-consumer ringbuffer
+ * @ingroup     sys
+ * @brief       Lock-free ringbuffer for one producer and one consumer
+ *
+ * The producer only ever writes spscrb_t::writes and the consumer only ever
+ * writes spscrb_t::reads, so one side can be an interrupt handler and the
+ * other one a thread without disabling interrupts.
+ *
+ * Elements of any size are copied in bulk with at most two `memcpy()` calls.
+ * Alternatively, the producer can write to the buffer in place with
+ * spscrb_reserve() and spscrb_commit() and the consumer can read from it in
+ * place with spscrb_peek() and spscrb_consume().
+ *
+ * @attention   The number of elements must be a power of two!
+ *
+ * @{
+ *
+ * @file
+ * @brief       Single-producer single-consumer ringbuffer interface
+ */
+
+#ifndef SPSCRB_H
+#define SPSCRB_H
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Single-producer single-consumer ringbuffer
+ */
+typedef struct {
+    void *buf;              /**< Buffer to operate on */
+    unsigned size;          /**< Number of elements, must be power of 2 */
+    size_t elem_size;       /**< Size of one element in bytes */
+    atomic_uint reads;      /**< Total number of elements read */
+    atomic_uint writes;     /**< Total number of elements written */
+} spscrb_t;
+
+/**
+ * @brief   Static initializer
+ *
+ * @param[in] BUF   An array of elements, its length must be a power of 2
+ */
+#define SPSCRB_INIT(BUF)    { (BUF), sizeof(BUF) / sizeof((BUF)[0]), \
+                              sizeof((BUF)[0]), ATOMIC_VAR_INIT(0), \
+                              ATOMIC_VAR_INIT(0) }
+
+/**
+ * @brief   Initialize a ringbuffer
+ *
+ * @param[out] rb           Ringbuffer to initialize
+ * @param[in] buf           Buffer to use, @p size * @p elem_size bytes
+ * @param[in] size          Number of elements, must be power of 2
+ * @param[in] elem_size     Size of one element in bytes
+ */
+static inline void spscrb_init(spscrb_t *rb, void *buf, unsigned size,
+                               size_t elem_size)
+{
+    assert((size != 0) && ((size & (size - 1)) == 0));
+
+    rb->buf = buf;
+    rb->size = size;
+    rb->elem_size = elem_size;
+    atomic_init(&rb->reads, 0);
+    atomic_init(&rb->writes, 0);
+}
+
+/**
+ * @brief   Get the number of elements available for reading
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ *
+ * @return  number of elements available
+ */
+static inline unsigned spscrb_avail(spscrb_t *rb)
+{
+    return atomic_load_explicit(&rb->writes, memory_order_acquire) -
+           atomic_load_explicit(&rb->reads, memory_order_relaxed);
+}
+
+/**
+ * @brief   Get the number of elements that can be written
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ *
+ * @return  number of free elements
+ */
+static inline unsigned spscrb_free(spscrb_t *rb)
+{
+    return rb->size -
+           (atomic_load_explicit(&rb->writes, memory_order_relaxed) -
+            atomic_load_explicit(&rb->reads, memory_order_acquire));
+}
+
+/**
+ * @brief   Add one element to the ringbuffer
+ *
+ * Must only be called by the producer.
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[in] elem  Element to add
+ *
+ * @return  0 on success
+ * @return  -1, if the ringbuffer is full
+ */
+int spscrb_add_one(spscrb_t *rb, const void *elem);
+
+/**
+ * @brief   Get one element from the ringbuffer
+ *
+ * Must only be called by the consumer.
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[out] elem Buffer for the element
+ *
+ * @return  0 on success
+ * @return  -1, if the ringbuffer is empty
+ */
+int spscrb_get_one(spscrb_t *rb, void *elem);
+
+/**
+ * @brief   Add elements to the ringbuffer
+ *
+ * Must only be called by the producer.
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[in] src   Elements to add
+ * @param[in] n     Maximum number of elements to add
+ *
+ * @return  number of elements added, less than @p n if the ringbuffer ran
+ *          full
+ */
+unsigned spscrb_add(spscrb_t *rb, const void *src, unsigned n);
+
+/**
+ * @brief   Get elements from the ringbuffer
+ *
+ * Must only be called by the consumer.
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[out] dst  Buffer for the elements
+ * @param[in] n     Maximum number of elements to get
+ *
+ * @return  number of elements written to @p dst
+ */
+unsigned spscrb_get(spscrb_t *rb, void *dst, unsigned n);
+
+/**
+ * @brief   Get the contiguous free space in the ringbuffer to write to it in
+ *          place
+ *
+ * Must only be called by the producer. The elements become visible to the
+ * consumer with spscrb_commit().
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[out] n    Number of elements that can be written to the returned
+ *                  window
+ *
+ * @return  start of the window
+ * @return  NULL, if the ringbuffer is full
+ */
+void *spscrb_reserve(spscrb_t *rb, unsigned *n);
+
+/**
+ * @brief   Make elements written with spscrb_reserve() visible to the
+ *          consumer
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[in] n     Number of elements written, must not exceed the window
+ *                  returned by spscrb_reserve()
+ */
+void spscrb_commit(spscrb_t *rb, unsigned n);
+
+/**
+ * @brief   Get the contiguous elements available in the ringbuffer to read
+ *          them in place
+ *
+ * Must only be called by the consumer. The elements stay in the ringbuffer
+ * until spscrb_consume() is called.
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[out] n    Number of elements in the returned window
+ *
+ * @return  start of the window
+ * @return  NULL, if the ringbuffer is empty
+ */
+const void *spscrb_peek(spscrb_t *rb, unsigned *n);
+
+/**
+ * @brief   Release elements read with spscrb_peek() to the producer
+ *
+ * @param[in] rb    Ringbuffer to operate on
+ * @param[in] n     Number of elements read, must not exceed the window
+ *                  returned by spscrb_peek()
+ */
+void spscrb_consume(spscrb_t *rb, unsigned n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPSCRB_H */
+/** @} */
@@ -20,6 +20,18 @@
  * number of active timers.  The reason for this is that multiplexing is
  * realized by next-first singly linked lists.
  *
+ * Without a timer due, the low-level timer still fires once per overflow of
+ * its counter to keep track of the upper bits of the time. With the
+ * `xtimer_tickless` module and a 32 bit wide low-level timer, this tick is
+ * skipped whenever a timer is due in the next period: the period is advanced
+ * when that timer fires instead. The module also counts the low-level timer
+ * interrupts, see @ref xtimer_get_wakeups().
+ *
+ * The `xtimer_wheel` module replaces the lists by a hierarchical timer wheel,
+ * setting a timer then takes constant time and removing one only walks the
+ * timers of its slot, at the cost of
+ * @ref XTIMER_WHEEL_LEVELS * 2^@ref XTIMER_WHEEL_SLOT_BITS pointers of RAM.
+ *
  * @{
  * @file
  * @brief   xtimer interface definitions
@@ -74,6 +86,11 @@ typedef struct xtimer {
     xtimer_callback_t callback;  /**< callback function to call when timer
                                      expires */
     void *arg;                   /**< argument to pass to callback function */
+#if defined(MODULE_XTIMER_WHEEL) || defined(DOXYGEN)
+    uint16_t slot;               /**< index of the wheel slot holding this
+                                     timer, only used by the timer wheel
+                                     backend */
+#endif
 } xtimer_t;
 
 /**
@@ -471,6 +488,27 @@ int xtimer_mutex_lock_timeout(mutex_t *mutex, uint64_t us);
  */
 void xtimer_set_timeout_flag(xtimer_t *t, uint32_t timeout);
 
+#if defined(MODULE_XTIMER_TICKLESS) || defined(DOXYGEN)
+/**
+ * @brief   Number of low-level timer interrupts handled by xtimer, by reason
+ */
+typedef struct {
+    uint32_t timer;     /**< interrupts that fired at least one timer */
+    uint32_t period;    /**< interrupts that only advanced the timer period */
+    uint32_t skipped;   /**< period ticks that were merged into the
+                             interrupt of the first timer of the period */
+} xtimer_wakeups_t;
+
+/**
+ * @brief   Get the number of low-level timer interrupts handled so far
+ *
+ * @note    Requires module `xtimer_tickless`
+ *
+ * @param[out] wakeups  interrupt counters
+ */
+void xtimer_get_wakeups(xtimer_wakeups_t *wakeups);
+#endif
+
 /**
  * @brief xtimer backoff value
  *
@@ -541,6 +579,27 @@ void xtimer_set_timeout_flag(xtimer_t *t, uint32_t timeout);
 #define XTIMER_PERIODIC_RELATIVE (512)
 #endif
 
+#ifndef XTIMER_WHEEL_SLOT_BITS
+/**
+ * @brief   Number of slots per level of the timer wheel as power of two
+ *
+ * Used by the `xtimer_wheel` module only, must not exceed 4.
+ */
+#define XTIMER_WHEEL_SLOT_BITS (4U)
+#endif
+
+#ifndef XTIMER_WHEEL_LEVELS
+/**
+ * @brief   Number of levels of the timer wheel
+ *
+ * Used by the `xtimer_wheel` module only. Timers further away than
+ * 2^(@ref XTIMER_WHEEL_SLOT_BITS * XTIMER_WHEEL_LEVELS) ticks are parked in
+ * the top level and placed again once it is reached. The default reaches
+ * 2^32 ticks.
+ */
+#define XTIMER_WHEEL_LEVELS (8U)
+#endif
+
 /*
  * Default xtimer configuration
  */
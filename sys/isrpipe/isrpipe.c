@@ -25,12 +25,12 @@
 void isrpipe_init(isrpipe_t *isrpipe, char *buf, size_t bufsize)
 {
     mutex_init(&isrpipe->mutex);
-    tsrb_init(&isrpipe->tsrb, buf, bufsize);
+    spscrb_init(&isrpipe->rb, buf, bufsize, sizeof(char));
 }
 
 int isrpipe_write_one(isrpipe_t *isrpipe, char c)
 {
-    int res = tsrb_add_one(&isrpipe->tsrb, c);
+    int res = spscrb_add_one(&isrpipe->rb, &c);
 
     /* `res` is either 0 on success or -1 when the buffer is full. Either way,
      * unlocking the mutex is fine.
@@ -40,11 +40,20 @@ int isrpipe_write_one(isrpipe_t *isrpipe, char c)
     return res;
 }
 
+int isrpipe_write(isrpipe_t *isrpipe, const char *buf, size_t count)
+{
+    int res = spscrb_add(&isrpipe->rb, buf, count);
+
+    mutex_unlock(&isrpipe->mutex);
+
+    return res;
+}
+
 int isrpipe_read(isrpipe_t *isrpipe, char *buffer, size_t count)
 {
     int res;
 
-    while (!(res = tsrb_get(&isrpipe->tsrb, buffer, count))) {
+    while (!(res = spscrb_get(&isrpipe->rb, buffer, count))) {
         mutex_lock(&isrpipe->mutex);
     }
     return res;
@@ -72,7 +81,7 @@ int isrpipe_read_timeout(isrpipe_t *isrpipe, char *buffer, size_t count, uint32_
     xtimer_t timer = { .callback = _cb, .arg = &_timeout };
 
     xtimer_set(&timer, timeout);
-    while (!(res = tsrb_get(&isrpipe->tsrb, buffer, count))) {
+    while (!(res = spscrb_get(&isrpipe->rb, buffer, count))) {
         mutex_lock(&isrpipe->mutex);
         if (_timeout.flag) {
             res = -ETIMEDOUT;
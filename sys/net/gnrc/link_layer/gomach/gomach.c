@@ -2019,14 +2019,8 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
 
     if (event == NETDEV_EVENT_ISR) {
-        msg_t msg;
-
-        msg.type = NETDEV_MSG_TYPE_EVENT;
-        msg.content.ptr = (void *) netif;
-
-        if (msg_send(&msg, netif->pid) <= 0) {
-            DEBUG("[GOMACH] gnrc_netdev: possibly lost interrupt.\n");
-        }
+        /* handled by the interface thread like without MAC */
+        defer_signal(&netif->isr);
     }
     else {
         DEBUG("gnrc_netdev: event triggered -> %i\n", event);
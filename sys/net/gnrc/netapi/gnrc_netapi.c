@@ -23,6 +23,9 @@
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netapi.h"
+#ifdef MODULE_GNRC_PKTTRACE
+#include "net/gnrc/pkttrace.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -99,6 +102,10 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
     if (numof != 0) {
         gnrc_netreg_entry_t *sendto = gnrc_netreg_lookup(type, demux_ctx);
 
+#ifdef MODULE_GNRC_PKTTRACE
+        /* stamped while pkt is not shared yet, all receivers are of type */
+        gnrc_pkttrace_stamp(pkt, type);
+#endif
         gnrc_pktbuf_hold(pkt, numof - 1);
 
         while (sendto) {
@@ -147,11 +154,17 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
 
 int gnrc_netapi_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt)
 {
+#ifdef MODULE_GNRC_PKTTRACE
+    gnrc_pkttrace_stamp(pkt, pkt->type);
+#endif
     return _snd_rcv(pid, GNRC_NETAPI_MSG_TYPE_SND, pkt);
 }
 
 int gnrc_netapi_receive(kernel_pid_t pid, gnrc_pktsnip_t *pkt)
 {
+#ifdef MODULE_GNRC_PKTTRACE
+    gnrc_pkttrace_stamp(pkt, pkt->type);
+#endif
     return _snd_rcv(pid, GNRC_NETAPI_MSG_TYPE_RCV, pkt);
 }
 
@@ -25,6 +25,10 @@
 #ifdef MODULE_NETSTATS_IPV6
 #include "net/netstats.h"
 #endif
+#ifdef MODULE_GNRC_PKTTRACE
+#include "net/gnrc/pkttrace.h"
+#include "xtimer.h"
+#endif
 #include "log.h"
 #include "sched.h"
 
@@ -38,11 +42,16 @@
 #define _NETIF_NETAPI_MSG_QUEUE_SIZE    (8)
 #endif
 
+#ifndef _NETIF_NETAPI_MSG_BATCH_SIZE
+#define _NETIF_NETAPI_MSG_BATCH_SIZE    (4)
+#endif
+
 static gnrc_netif_t _netifs[GNRC_NETIF_NUMOF];
 
 static void _update_l2addr_from_dev(gnrc_netif_t *netif);
 static void *_gnrc_netif_thread(void *args);
 static void _event_cb(netdev_t *dev, netdev_event_t event);
+static void _isr(defer_t *defer);
 
 gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
                                 const char *name, netdev_t *netdev,
@@ -60,7 +69,11 @@ gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
         }
     }
     assert(netif != NULL);
+#ifdef MODULE_CORE_MUTEX_PI
+    rmutex_pi_init(&netif->mutex);
+#else
     rmutex_init(&netif->mutex);
+#endif
     netif->ops = ops;
     assert(netif->dev == NULL);
     netif->dev = netdev;
@@ -437,14 +450,22 @@ size_t gnrc_netif_addr_from_str(const char *str, uint8_t *out)
 void gnrc_netif_acquire(gnrc_netif_t *netif)
 {
     if (netif && (netif->ops)) {
+#ifdef MODULE_CORE_MUTEX_PI
+        rmutex_pi_lock(&netif->mutex);
+#else
         rmutex_lock(&netif->mutex);
+#endif
     }
 }
 
 void gnrc_netif_release(gnrc_netif_t *netif)
 {
     if (netif && (netif->ops)) {
+#ifdef MODULE_CORE_MUTEX_PI
+        rmutex_pi_unlock(&netif->mutex);
+#else
         rmutex_unlock(&netif->mutex);
+#endif
     }
 }
 
@@ -1231,7 +1252,8 @@ static void *_gnrc_netif_thread(void *args)
     netdev_t *dev;
     int res;
     msg_t reply = { .type = GNRC_NETAPI_MSG_TYPE_ACK };
-    msg_t msg, msg_queue[_NETIF_NETAPI_MSG_QUEUE_SIZE];
+    msg_t msgs[_NETIF_NETAPI_MSG_BATCH_SIZE];
+    msg_t msg_queue[_NETIF_NETAPI_MSG_QUEUE_SIZE];
 
     DEBUG("gnrc_netif: starting thread %i\n", sched_active_pid);
     netif = args;
@@ -1240,6 +1262,9 @@ static void *_gnrc_netif_thread(void *args)
     netif->pid = sched_active_pid;
     /* setup the link-layer's message queue */
     msg_init_queue(msg_queue, _NETIF_NETAPI_MSG_QUEUE_SIZE);
+    /* device interrupts are handled in this thread */
+    defer_init(&netif->isr, _isr, netif, (thread_t *)sched_active_thread,
+               GNRC_NETIF_THREAD_FLAG_ISR);
     /* register the event callback with the device driver */
     dev->event_callback = _event_cb;
     dev->context = netif;
@@ -1258,65 +1283,79 @@ static void *_gnrc_netif_thread(void *args)
 
     while (1) {
         DEBUG("gnrc_netif: waiting for incoming messages\n");
-        msg_receive(&msg);
-        /* dispatch netdev, MAC and gnrc_netapi messages */
-        switch (msg.type) {
-            case NETDEV_MSG_TYPE_EVENT:
-                DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_EVENT received\n");
-                dev->driver->isr(dev);
-                break;
-            case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
+        thread_flags_wait_any(THREAD_FLAG_MSG_WAITING |
+                              GNRC_NETIF_THREAD_FLAG_ISR);
+        defer_run(&netif->isr);
+        int numof = msg_try_receive_batch(msgs, _NETIF_NETAPI_MSG_BATCH_SIZE);
+
+        if (numof == _NETIF_NETAPI_MSG_BATCH_SIZE) {
+            /* there may be more, get them after the device had its turn */
+            thread_flags_set((thread_t *)sched_active_thread,
+                             THREAD_FLAG_MSG_WAITING);
+        }
+
+        for (int i = 0; i < numof; i++) {
+            msg_t *msg = &msgs[i];
+
+            /* dispatch netdev, MAC and gnrc_netapi messages */
+            switch (msg->type) {
+                case GNRC_NETAPI_MSG_TYPE_SND:
+                    DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
 #if defined MODULE_PKTCNT && !defined MODULE_PKTCNT_FAST
-                pktcnt_log_tx(msg.content.ptr);
+                    pktcnt_log_tx(msg->content.ptr);
 #endif
-                res = netif->ops->send(netif, msg.content.ptr);
-                if (res < 0) {
-                    DEBUG("gnrc_netif: error sending packet %p (code: %u)\n",
-                          msg.content.ptr, res);
-                }
-                break;
-            case GNRC_NETAPI_MSG_TYPE_SET:
-                opt = msg.content.ptr;
+#ifdef MODULE_GNRC_PKTTRACE
+                    /* the device holds the packet from now on */
+                    gnrc_pkttrace_stamp(msg->content.ptr, GNRC_NETTYPE_UNDEF);
+#endif
+                    res = netif->ops->send(netif, msg->content.ptr);
+                    if (res < 0) {
+                        DEBUG("gnrc_netif: error sending packet %p (code: %u)\n",
+                              msg->content.ptr, res);
+                    }
+                    break;
+                case GNRC_NETAPI_MSG_TYPE_SET:
+                    opt = msg->content.ptr;
 #ifdef MODULE_NETOPT
-                DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_SET received. opt=%s\n",
-                      netopt2str(opt->opt));
+                    DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_SET received. opt=%s\n",
+                          netopt2str(opt->opt));
 #else
-                DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_SET received. opt=%d\n",
-                      opt->opt);
+                    DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_SET received. opt=%d\n",
+                          opt->opt);
 #endif
-                /* set option for device driver */
-                res = netif->ops->set(netif, opt);
-                DEBUG("gnrc_netif: response of netif->ops->set(): %i\n", res);
-                reply.content.value = (uint32_t)res;
-                msg_reply(&msg, &reply);
-                break;
-            case GNRC_NETAPI_MSG_TYPE_GET:
-                opt = msg.content.ptr;
+                    /* set option for device driver */
+                    res = netif->ops->set(netif, opt);
+                    DEBUG("gnrc_netif: response of netif->ops->set(): %i\n", res);
+                    reply.content.value = (uint32_t)res;
+                    msg_reply(msg, &reply);
+                    break;
+                case GNRC_NETAPI_MSG_TYPE_GET:
+                    opt = msg->content.ptr;
 #ifdef MODULE_NETOPT
-                DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_GET received. opt=%s\n",
-                      netopt2str(opt->opt));
+                    DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_GET received. opt=%s\n",
+                          netopt2str(opt->opt));
 #else
-                DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_GET received. opt=%d\n",
-                      opt->opt);
+                    DEBUG("gnrc_netif: GNRC_NETAPI_MSG_TYPE_GET received. opt=%d\n",
+                          opt->opt);
 #endif
-                /* get option from device driver */
-                res = netif->ops->get(netif, opt);
-                DEBUG("gnrc_netif: response of netif->ops->get(): %i\n", res);
-                reply.content.value = (uint32_t)res;
-                msg_reply(&msg, &reply);
-                break;
-            default:
-                if (netif->ops->msg_handler) {
-                    DEBUG("gnrc_netif: delegate message of type 0x%04x to "
-                          "netif->ops->msg_handler()\n", msg.type);
-                    netif->ops->msg_handler(netif, &msg);
-                }
-                else {
-                    DEBUG("gnrc_netif: unknown message type 0x%04x"
-                          "(no message handler defined)\n", msg.type);
-                }
-                break;
+                    /* get option from device driver */
+                    res = netif->ops->get(netif, opt);
+                    DEBUG("gnrc_netif: response of netif->ops->get(): %i\n", res);
+                    reply.content.value = (uint32_t)res;
+                    msg_reply(msg, &reply);
+                    break;
+                default:
+                    if (netif->ops->msg_handler) {
+                        DEBUG("gnrc_netif: delegate message of type 0x%04x to "
+                              "netif->ops->msg_handler()\n", msg->type);
+                        netif->ops->msg_handler(netif, msg);
+                    }
+                    else {
+                        DEBUG("gnrc_netif: unknown message type 0x%04x"
+                              "(no message handler defined)\n", msg->type);
+                    }
+                    break;
+            }
         }
     }
     /* never reached */
@@ -1333,17 +1372,29 @@ static void _pass_on_packet(gnrc_pktsnip_t *pkt)
     }
 }
 
+static void _isr(defer_t *defer)
+{
+    netdev_t *dev = ((gnrc_netif_t *)defer->arg)->dev;
+
+    /* netdev drivers handle one interrupt per call, there is no way to ask
+     * them if more is pending */
+    for (unsigned i = 0; i < defer->signals; i++) {
+        DEBUG("gnrc_netif: handling device interrupt\n");
+        dev->driver->isr(dev);
+    }
+}
+
 static void _event_cb(netdev_t *dev, netdev_event_t event)
 {
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
 
     if (event == NETDEV_EVENT_ISR) {
-        msg_t msg = { .type = NETDEV_MSG_TYPE_EVENT,
-                      .content = { .ptr = netif } };
-
-        if (msg_send(&msg, netif->pid) <= 0) {
-            puts("gnrc_netif: possibly lost interrupt.");
-        }
+#ifdef MODULE_GNRC_PKTTRACE
+        netif->isr_time = xtimer_now_usec();
+#endif
+        /* interrupts while the last one is not handled yet are handled
+         * together with it */
+        defer_signal(&netif->isr);
     }
     else {
         DEBUG("gnrc_netif: event triggered -> %i\n", event);
@@ -1352,6 +1403,9 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
                     gnrc_pktsnip_t *pkt = netif->ops->recv(netif);
 
                     if (pkt) {
+#ifdef MODULE_GNRC_PKTTRACE
+                        gnrc_pkttrace_start(pkt, netif->isr_time, GNRC_NETTYPE_NETIF);
+#endif
                         _pass_on_packet(pkt);
                     }
                 }
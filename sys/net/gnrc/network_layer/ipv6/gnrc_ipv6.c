@@ -39,7 +39,11 @@
 
 #define _MAX_L2_ADDR_LEN    (8U)
 
-#if ENABLE_DEBUG
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+
+static gnrc_single_thread_layer_t _layer;
+#elif ENABLE_DEBUG
 static char _stack[GNRC_IPV6_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_IPV6_STACK_SIZE];
@@ -69,8 +73,12 @@ static void _receive(gnrc_pktsnip_t *pkt);
  * prep_hdr: prepare header for sending (call to _fill_ipv6_hdr()), otherwise
  * assume it is already prepared */
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr);
+/* Handles a message to IPv6 */
+static void _handle_msg(msg_t *msg);
+#ifndef MODULE_GNRC_SINGLE_THREAD
 /* Main event loop for IPv6 */
 static void *_event_loop(void *args);
+#endif
 
 /* Handles encapsulated IPv6 packets: http://tools.ietf.org/html/rfc2473 */
 static void _decapsulate(gnrc_pktsnip_t *pkt);
@@ -78,9 +86,16 @@ static void _decapsulate(gnrc_pktsnip_t *pkt);
 kernel_pid_t gnrc_ipv6_init(void)
 {
     if (gnrc_ipv6_pid == KERNEL_PID_UNDEF) {
+#ifdef MODULE_GNRC_SINGLE_THREAD
+        gnrc_ipv6_pid = gnrc_single_thread_add(&_layer, GNRC_NETTYPE_IPV6,
+                                               _handle_msg,
+                                               GNRC_IPV6_NIB_SND_UC_NS,
+                                               GNRC_IPV6_NIB_ROUTE_TIMEOUT);
+#else
         gnrc_ipv6_pid = thread_create(_stack, sizeof(_stack), GNRC_IPV6_PRIO,
                                       THREAD_CREATE_STACKTEST,
                                       _event_loop, NULL, "ipv6");
+#endif
     }
 
 #ifdef MODULE_FIB
@@ -245,9 +260,56 @@ static void _dispatch_next_header(gnrc_pktsnip_t *current, gnrc_pktsnip_t *pkt,
     }
 }
 
+static void _handle_msg(msg_t *msg)
+{
+    msg_t reply;
+
+    switch (msg->type) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
+            _receive(msg->content.ptr);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
+            _send(msg->content.ptr, true);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_GET:
+        case GNRC_NETAPI_MSG_TYPE_SET:
+            DEBUG("ipv6: reply to unsupported get/set\n");
+            reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+            reply.content.value = -ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
+
+        case GNRC_IPV6_NIB_SND_UC_NS:
+        case GNRC_IPV6_NIB_SND_MC_NS:
+        case GNRC_IPV6_NIB_SND_NA:
+        case GNRC_IPV6_NIB_SEARCH_RTR:
+        case GNRC_IPV6_NIB_REPLY_RS:
+        case GNRC_IPV6_NIB_SND_MC_RA:
+        case GNRC_IPV6_NIB_REACH_TIMEOUT:
+        case GNRC_IPV6_NIB_DELAY_TIMEOUT:
+        case GNRC_IPV6_NIB_ADDR_REG_TIMEOUT:
+        case GNRC_IPV6_NIB_ABR_TIMEOUT:
+        case GNRC_IPV6_NIB_PFX_TIMEOUT:
+        case GNRC_IPV6_NIB_RTR_TIMEOUT:
+        case GNRC_IPV6_NIB_RECALC_REACH_TIME:
+        case GNRC_IPV6_NIB_REREG_ADDRESS:
+        case GNRC_IPV6_NIB_ROUTE_TIMEOUT:
+            DEBUG("ipv6: NIB timer event received\n");
+            gnrc_ipv6_nib_handle_timer_event(msg->content.ptr, msg->type);
+            break;
+        default:
+            break;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *args)
 {
-    msg_t msg, reply, msg_q[GNRC_IPV6_MSG_QUEUE_SIZE];
+    msg_t msgs[GNRC_IPV6_MSG_BATCH_SIZE], msg_q[GNRC_IPV6_MSG_QUEUE_SIZE];
     gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
 
@@ -257,57 +319,19 @@ static void *_event_loop(void *args)
     /* register interest in all IPv6 packets */
     gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me_reg);
 
-    /* preinitialize ACK */
-    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
-
     /* start event loop */
     while (1) {
         DEBUG("ipv6: waiting for incoming message.\n");
-        msg_receive(&msg);
-
-        switch (msg.type) {
-            case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
-                _receive(msg.content.ptr);
-                break;
-
-            case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
-                _send(msg.content.ptr, true);
-                break;
-
-            case GNRC_NETAPI_MSG_TYPE_GET:
-            case GNRC_NETAPI_MSG_TYPE_SET:
-                DEBUG("ipv6: reply to unsupported get/set\n");
-                reply.content.value = -ENOTSUP;
-                msg_reply(&msg, &reply);
-                break;
-
-            case GNRC_IPV6_NIB_SND_UC_NS:
-            case GNRC_IPV6_NIB_SND_MC_NS:
-            case GNRC_IPV6_NIB_SND_NA:
-            case GNRC_IPV6_NIB_SEARCH_RTR:
-            case GNRC_IPV6_NIB_REPLY_RS:
-            case GNRC_IPV6_NIB_SND_MC_RA:
-            case GNRC_IPV6_NIB_REACH_TIMEOUT:
-            case GNRC_IPV6_NIB_DELAY_TIMEOUT:
-            case GNRC_IPV6_NIB_ADDR_REG_TIMEOUT:
-            case GNRC_IPV6_NIB_ABR_TIMEOUT:
-            case GNRC_IPV6_NIB_PFX_TIMEOUT:
-            case GNRC_IPV6_NIB_RTR_TIMEOUT:
-            case GNRC_IPV6_NIB_RECALC_REACH_TIME:
-            case GNRC_IPV6_NIB_REREG_ADDRESS:
-            case GNRC_IPV6_NIB_ROUTE_TIMEOUT:
-                DEBUG("ipv6: NIB timer event received\n");
-                gnrc_ipv6_nib_handle_timer_event(msg.content.ptr, msg.type);
-                break;
-            default:
-                break;
+        int numof = msg_receive_batch(msgs, GNRC_IPV6_MSG_BATCH_SIZE);
+
+        for (int i = 0; i < numof; i++) {
+            _handle_msg(&msgs[i]);
         }
     }
 
     return NULL;
 }
+#endif
 
 static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 {
@@ -697,6 +721,17 @@ static inline bool _pkt_not_for_me(gnrc_netif_t **netif, ipv6_hdr_t *hdr)
 #include "fmt.h"
 #include "net/udp.h"
 
+#ifdef MODULE_PKTCNT_BIN
+#include <stddef.h>
+#include <string.h>
+
+#include "pktcnt.h"
+#include "xtimer.h"
+
+/* record of the packet currently forwarded */
+static pktcnt_bin_rec_t fwd_rec;
+#endif
+
 static unsigned _code_class(uint8_t code)
 {
     return code >> 5;
@@ -710,8 +745,15 @@ static unsigned _code_detail(uint8_t code)
 static void log_coap(uint8_t *payload)
 {
     uint8_t code = payload[1];
+#ifdef MODULE_PKTCNT_BIN
+    fwd_rec.proto = PKTCNT_BIN_PROTO_COAP;
+    fwd_rec.code = code;
+    fwd_rec.id = (((uint16_t)payload[2]) << 8) | (payload[3]);
+    fwd_rec.flags |= PKTCNT_BIN_FLAG_ID;
+#else
     printf("%u.%02u;%u-", _code_class(code), _code_detail(code),
            (((uint16_t)payload[2]) << 8) | (payload[3]));
+#endif
 }
 
 static void log_mqtt(uint8_t *payload)
@@ -740,10 +782,22 @@ static void log_mqtt(uint8_t *payload)
             msgid = (((uint16_t)payload[type_offset + 4]) << 8) | payload[type_offset + 5];
             break;
         default:
+#ifdef MODULE_PKTCNT_BIN
+            fwd_rec.proto = PKTCNT_BIN_PROTO_MQTT;
+            fwd_rec.code = type;
+#else
             printf("%02x;", type);
+#endif
             return;
     }
+#ifdef MODULE_PKTCNT_BIN
+    fwd_rec.proto = PKTCNT_BIN_PROTO_MQTT;
+    fwd_rec.code = type;
+    fwd_rec.id = msgid;
+    fwd_rec.flags |= PKTCNT_BIN_FLAG_ID;
+#else
     printf("%02x;%u-", type, msgid);
+#endif
 }
 #endif
 
@@ -900,7 +954,9 @@ static void _receive(gnrc_pktsnip_t *pkt)
                 udp_hdr_t *udp_hdr;
                 uint8_t *iid;
                 uint8_t *udp_payload;
+#ifndef MODULE_PKTCNT_BIN
                 char addr_str[17];
+#endif
                 uint16_t port;
 
                 if (udp != NULL) {
@@ -927,6 +983,23 @@ static void _receive(gnrc_pktsnip_t *pkt)
                     }
                     port = byteorder_ntohs(udp_hdr->dst_port);
                 }
+#ifdef MODULE_PKTCNT_BIN
+                if ((port == COAP_PORT) || (port == MQTT_PORT)) {
+                    memset(&fwd_rec, 0, offsetof(pktcnt_bin_rec_t, data));
+                    fwd_rec.type = PKTCNT_BIN_FWD;
+                    fwd_rec.time = xtimer_now_usec64();
+                    if (port == COAP_PORT) {
+                        log_coap(udp_payload);
+                    }
+                    else {
+                        log_mqtt(udp_payload);
+                    }
+                    /* the IID goes in as source address */
+                    memcpy(fwd_rec.data, iid, 8);
+                    fwd_rec.src_len = 8;
+                    pktcnt_bin_write(&fwd_rec);
+                }
+#else
                 fmt_bytes_hex(addr_str, iid, 8);
                 addr_str[16] = '\0';
                 switch (port) {
@@ -943,6 +1016,7 @@ static void _receive(gnrc_pktsnip_t *pkt)
                     default:
                         break;
                 }
+#endif
             }
 #endif
 
@@ -323,7 +323,7 @@ void _probe_nbr(_nib_onl_entry_t *nbr, bool reset)
         case GNRC_IPV6_NIB_NC_INFO_NUD_STATE_INCOMPLETE:
         case GNRC_IPV6_NIB_NC_INFO_NUD_STATE_UNREACHABLE: {
                 gnrc_netif_t *netif = gnrc_netif_get_by_pid(_nib_onl_get_if(nbr));
-                uint32_t next_ns = _evtimer_lookup(nbr,
+                uint32_t next_ns = _evtimer_lookup(&nbr->nud_timeout,
                                                    GNRC_IPV6_NIB_SND_MC_NS);
 
                 assert(netif != NULL);
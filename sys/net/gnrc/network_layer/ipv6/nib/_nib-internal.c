@@ -809,21 +809,13 @@ static inline bool _node_unreachable(_nib_onl_entry_t *node)
     }
 }
 
-uint32_t _evtimer_lookup(const void *ctx, uint16_t type)
+uint32_t _evtimer_lookup(const evtimer_msg_event_t *event, uint16_t type)
 {
-    evtimer_msg_event_t *event = (evtimer_msg_event_t *)_nib_evtimer.events;
-    uint32_t offset = 0;
-
-    DEBUG("nib: lookup ctx = %p, type = %04x\n", (void *)ctx, type);
-    while (event != NULL) {
-        offset += event->event.offset;
-        if ((event->msg.type == type) &&
-            ((ctx == NULL) || (event->msg.content.ptr == ctx))) {
-            return offset;
-        }
-        event = (evtimer_msg_event_t *)event->event.next;
+    DEBUG("nib: lookup event = %p, type = %04x\n", (void *)event, type);
+    if (event->msg.type != type) {
+        return UINT32_MAX;
     }
-    return UINT32_MAX;
+    return evtimer_get_remaining((evtimer_t *)&_nib_evtimer, &event->event);
 }
 
 /** @} */
@@ -788,13 +788,16 @@ int _nib_get_route(const ipv6_addr_t *dst, gnrc_pktsnip_t *ctx,
 /**
  * @brief   Looks up if an event is queued in the event timer
  *
- * @param[in] ctx   Context of the event. May be NULL for any event context.
+ * Every event type is only ever scheduled with one event of its context, so
+ * there is no need to search the event queue for it.
+ *
+ * @param[in] event The event of the context used for @p type.
  * @param[in] type  [Type of the event](@ref net_gnrc_ipv6_nib_msg).
  *
- * @return  Milliseconds to the event, if event in queue.
+ * @return  Milliseconds to the event, if event in queue with @p type.
  * @return  UINT32_MAX, event is not in queue.
  */
-uint32_t _evtimer_lookup(const void *ctx, uint16_t type);
+uint32_t _evtimer_lookup(const evtimer_msg_event_t *event, uint16_t type);
 
 /**
  * @brief   Adds an event to the event timer
@@ -81,13 +81,9 @@ void _handle_search_rtr(gnrc_netif_t *netif);
 
 void gnrc_ipv6_nib_init(void)
 {
-    evtimer_event_t *tmp;
-
     mutex_lock(&_nib_mutex);
-    for (evtimer_event_t *ptr = _nib_evtimer.events;
-         (ptr != NULL) && (tmp = (ptr->next), 1);
-         ptr = tmp) {
-        evtimer_del((evtimer_t *)(&_nib_evtimer), ptr);
+    while (_nib_evtimer.events != NULL) {
+        evtimer_del((evtimer_t *)(&_nib_evtimer), _nib_evtimer.events);
     }
     _nib_init();
     mutex_unlock(&_nib_mutex);
@@ -477,7 +473,7 @@ static void _handle_rtr_sol(gnrc_netif_t *netif, const ipv6_hdr_t *ipv6,
         nce = _nib_onl_get(&ipv6->src, netif->pid);
     }
     if (!gnrc_netif_is_6ln(netif)) {
-        uint32_t next_ra_scheduled = _evtimer_lookup(netif,
+        uint32_t next_ra_scheduled = _evtimer_lookup(&netif->ipv6.snd_mc_ra,
                                                      GNRC_IPV6_NIB_SND_MC_RA);
         if (next_ra_scheduled < next_ra_delay) {
             DEBUG("nib: There is a MC RA scheduled within the next %" PRIu32 "ms. "
@@ -1175,7 +1171,8 @@ void _handle_search_rtr(gnrc_netif_t *netif)
 {
     gnrc_netif_acquire(netif);
     if (!(gnrc_netif_is_rtr_adv(netif)) || gnrc_netif_is_6ln(netif)) {
-        uint32_t next_rs = _evtimer_lookup(netif, GNRC_IPV6_NIB_SEARCH_RTR);
+        uint32_t next_rs = _evtimer_lookup(&netif->ipv6.search_rtr,
+                                          GNRC_IPV6_NIB_SEARCH_RTR);
         uint32_t interval = _get_next_rs_interval(netif);
 
         if (next_rs > interval) {
@@ -25,6 +25,18 @@
 static gnrc_sixlowpan_ctx_t _ctxs[GNRC_SIXLOWPAN_CTX_SIZE];
 static uint32_t _ctx_inval_times[GNRC_SIXLOWPAN_CTX_SIZE];
 static mutex_t _ctx_mutex = MUTEX_INIT;
+static uint32_t _ctx_version;
+
+/* marks a cache entry whose address matches no context */
+#define CACHE_NO_CTX    (UINT8_MAX)
+
+typedef struct {
+    ipv6_addr_t addr;
+    uint8_t id;     /* context ID + 1, 0 if unused, CACHE_NO_CTX if none */
+} _cache_entry_t;
+
+static _cache_entry_t _cache[GNRC_SIXLOWPAN_CTX_CACHE_SIZE];
+static unsigned _cache_next;
 
 static uint32_t _current_minute(void);
 static void _update_lifetime(uint8_t id);
@@ -37,13 +49,40 @@ static inline bool _valid(uint8_t id)
     return (_ctxs[id].prefix_len > 0);
 }
 
+static void _cache_flush(void)
+{
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_CTX_CACHE_SIZE; i++) {
+        _cache[i].id = 0;
+    }
+}
+
+static _cache_entry_t *_cache_get(const ipv6_addr_t *addr)
+{
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_CTX_CACHE_SIZE; i++) {
+        if ((_cache[i].id != 0) && ipv6_addr_equal(&_cache[i].addr, addr)) {
+            return &_cache[i];
+        }
+    }
+    return NULL;
+}
+
 gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_addr(const ipv6_addr_t *addr)
 {
     uint8_t best = 0;
     gnrc_sixlowpan_ctx_t *res = NULL;
+    _cache_entry_t *cached;
 
     mutex_lock(&_ctx_mutex);
 
+    cached = _cache_get(addr);
+    /* removal does not flush the cache, so check the context is still there */
+    if ((cached != NULL) &&
+        ((cached->id == CACHE_NO_CTX) || _valid(cached->id - 1))) {
+        res = (cached->id == CACHE_NO_CTX) ? NULL : &(_ctxs[cached->id - 1]);
+        mutex_unlock(&_ctx_mutex);
+        return res;
+    }
+
     for (unsigned int id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
         if (_valid(id)) {
             uint8_t match = ipv6_addr_match_prefix(&_ctxs[id].prefix, addr);
@@ -55,6 +94,13 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_addr(const ipv6_addr_t *addr)
         }
     }
 
+    if (cached == NULL) {
+        cached = &_cache[_cache_next];
+        _cache_next = (_cache_next + 1) % GNRC_SIXLOWPAN_CTX_CACHE_SIZE;
+        cached->addr = *addr;
+    }
+    cached->id = (res == NULL) ? CACHE_NO_CTX : (uint8_t)(res - _ctxs) + 1;
+
     mutex_unlock(&_ctx_mutex);
 
 #if ENABLE_DEBUG
@@ -124,11 +170,18 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
           id, ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
           _ctxs[id].prefix_len, _ctxs[id].ltime);
     _ctx_inval_times[id] = ltime + _current_minute();
+    _ctx_version++;
+    _cache_flush();
 
     mutex_unlock(&_ctx_mutex);
     return &(_ctxs[id]);
 }
 
+uint32_t gnrc_sixlowpan_ctx_version(void)
+{
+    return _ctx_version;
+}
+
 static uint32_t _current_minute(void)
 {
     return xtimer_now_usec() / (US_PER_SEC * 60);
@@ -161,6 +214,8 @@ static void _update_lifetime(uint8_t id)
 void gnrc_sixlowpan_ctx_reset(void)
 {
     memset(_ctxs, 0, sizeof(_ctxs));
+    _ctx_version++;
+    _cache_flush();
 }
 #endif
 
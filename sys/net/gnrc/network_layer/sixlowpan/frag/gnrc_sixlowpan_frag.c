@@ -25,6 +25,16 @@
 #include "net/gnrc/netif.h"
 #include "net/sixlowpan.h"
 #include "utlist.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+#include <assert.h>
+#include <stddef.h>
+
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/udp.h"
+#endif
 
 #include "rbuf.h"
 
@@ -275,6 +285,276 @@ void gnrc_sixlowpan_frag_send(gnrc_sixlowpan_msg_frag_t *fragment_msg)
     }
 }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+/* copies the fragment received in pkt into a new fragment to the next hop of
+ * vrb with the tag of vrb, pkt is released */
+static gnrc_pktsnip_t *_vrb_copy(gnrc_sixlowpan_frag_vrb_t *vrb,
+                                 gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *netif, *frag;
+    sixlowpan_frag_t *hdr;
+
+    netif = gnrc_netif_hdr_build(NULL, 0, vrb->out_dst, vrb->out_dst_len);
+    if (netif == NULL) {
+        DEBUG("6lo vrb: error allocating link-layer header\n");
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = vrb->out_netif;
+    frag = gnrc_pktbuf_add(NULL, pkt->data, pkt->size, GNRC_NETTYPE_SIXLOWPAN);
+    gnrc_pktbuf_release(pkt);
+    if (frag == NULL) {
+        DEBUG("6lo vrb: error allocating fragment\n");
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+    hdr = frag->data;
+    hdr->tag = byteorder_htons(vrb->out_tag);
+    netif->next = frag;
+    return netif;
+}
+
+/* recompresses the IPv6 header in ipv6_hdr for the next hop and builds the
+ * first fragment of vrb with it and the payload of the received one */
+static gnrc_pktsnip_t *_vrb_build_1st(gnrc_sixlowpan_frag_vrb_t *vrb,
+                                      const ipv6_hdr_t *ipv6_hdr,
+                                      const uint8_t *nh, size_t nh_len,
+                                      const uint8_t *payload,
+                                      size_t payload_len, size_t max_size)
+{
+    gnrc_pktsnip_t *netif, *ipv6, *data, *frag;
+    sixlowpan_frag_t *hdr;
+    uint8_t *ptr;
+
+    data = gnrc_pktbuf_add(NULL, NULL, nh_len + payload_len,
+                           GNRC_NETTYPE_UNDEF);
+    if (data == NULL) {
+        return NULL;
+    }
+    memcpy(data->data, nh, nh_len);
+    memcpy(((uint8_t *)data->data) + nh_len, payload, payload_len);
+    ipv6 = gnrc_pktbuf_add(data, ipv6_hdr, sizeof(ipv6_hdr_t),
+                           GNRC_NETTYPE_IPV6);
+    if (ipv6 == NULL) {
+        gnrc_pktbuf_release(data);
+        return NULL;
+    }
+    netif = gnrc_netif_hdr_build(NULL, 0, vrb->out_dst, vrb->out_dst_len);
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = vrb->out_netif;
+    netif->next = ipv6;
+    if (!gnrc_sixlowpan_iphc_encode(netif)) {
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+    if ((sizeof(sixlowpan_frag_t) + gnrc_pkt_len(netif->next)) > max_size) {
+        DEBUG("6lo vrb: recompressed first fragment too big\n");
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+    frag = gnrc_pktbuf_add(NULL, NULL, sizeof(sixlowpan_frag_t) +
+                           gnrc_pkt_len(netif->next), GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+    hdr = frag->data;
+    hdr->disp_size = byteorder_htons(vrb->datagram_size);
+    hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+    hdr->tag = byteorder_htons(vrb->out_tag);
+    ptr = (uint8_t *)(hdr + 1);
+    for (gnrc_pktsnip_t *snip = netif->next; snip != NULL; snip = snip->next) {
+        memcpy(ptr, snip->data, snip->size);
+        ptr += snip->size;
+    }
+    gnrc_pktbuf_release(netif->next);
+    netif->next = frag;
+    return netif;
+}
+
+/* tries to forward a first fragment without reassembly, returns false if the
+ * datagram has to be reassembled. Fragments that can't belong to a valid
+ * datagram are dropped. */
+static bool _vrb_forward_1st(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                             size_t frag_size)
+{
+    sixlowpan_frag_t *frag = pkt->data;
+    uint8_t *data = (uint8_t *)(frag + 1);
+    struct {
+        ipv6_hdr_t ipv6;
+        udp_hdr_t udp;
+    } dec;
+    gnrc_pktsnip_t dec_snip = { .data = &dec, .size = sizeof(dec),
+                                .users = 1, .type = GNRC_NETTYPE_IPV6 };
+    gnrc_pktsnip_t *dec_hdr = &dec_snip;
+    gnrc_sixlowpan_frag_vrb_t vrb = { .datagram_size = 0 };
+    gnrc_ipv6_nib_nc_t nce;
+    gnrc_netif_t *in, *out;
+    size_t dispatch_len, nh_len = 0, uncomp_size;
+
+    in = gnrc_netif_get_by_pid(netif_hdr->if_pid);
+    if ((in == NULL) || !gnrc_netif_is_rtr(in) ||
+        (netif_hdr->src_l2addr_len > sizeof(vrb.src))) {
+        return false;
+    }
+    vrb.datagram_size = byteorder_ntohs(frag->disp_size) &
+                        SIXLOWPAN_FRAG_SIZE_MASK;
+    if (vrb.datagram_size == 0) {
+        /* NHC would decode into a snip of its own for size 0 */
+        DEBUG("6lo vrb: datagram size 0, dropping fragment\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    if (data[0] == SIXLOWPAN_UNCOMP) {
+        dispatch_len = 1;
+        if (frag_size < (dispatch_len + sizeof(ipv6_hdr_t))) {
+            return false;
+        }
+        memcpy(&dec.ipv6, data + dispatch_len, sizeof(ipv6_hdr_t));
+    }
+    else if (sixlowpan_iphc_is(data)) {
+        dispatch_len = gnrc_sixlowpan_iphc_decode(&dec_hdr, pkt,
+                                                  vrb.datagram_size,
+                                                  sizeof(sixlowpan_frag_t),
+                                                  &nh_len);
+        /* with a datagram size given, the headers are decoded in place */
+        assert(dec_hdr == &dec_snip);
+        if ((dispatch_len == 0) || (dispatch_len > frag_size) ||
+            (nh_len > sizeof(dec.udp))) {
+            return false;
+        }
+    }
+    else {
+        return false;
+    }
+    /* the uncompressed bytes of the fragment */
+    uncomp_size = frag_size - dispatch_len + nh_len;
+    if (data[0] != SIXLOWPAN_UNCOMP) {
+        uncomp_size += sizeof(ipv6_hdr_t);
+    }
+    if (uncomp_size > vrb.datagram_size) {
+        DEBUG("6lo vrb: first fragment exceeds datagram size, dropping it\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    if (ipv6_addr_is_multicast(&dec.ipv6.dst) ||
+        ipv6_addr_is_link_local(&dec.ipv6.dst) || (dec.ipv6.hl <= 1) ||
+        (gnrc_netif_get_by_ipv6_addr(&dec.ipv6.dst) != NULL) ||
+        (gnrc_ipv6_nib_get_next_hop_l2addr(&dec.ipv6.dst, NULL, NULL,
+                                           &nce) < 0)) {
+        /* let IPv6 handle the datagram */
+        return false;
+    }
+    out = gnrc_netif_get_by_pid(gnrc_ipv6_nib_nc_get_iface(&nce));
+    if ((out == NULL) || !gnrc_netif_is_6ln(out) ||
+        (nce.l2addr_len > sizeof(vrb.out_dst))) {
+        return false;
+    }
+    memcpy(vrb.src, gnrc_netif_hdr_get_src_addr(netif_hdr),
+           netif_hdr->src_l2addr_len);
+    vrb.src_len = netif_hdr->src_l2addr_len;
+    memcpy(vrb.out_dst, nce.l2addr, nce.l2addr_len);
+    vrb.out_dst_len = nce.l2addr_len;
+    vrb.out_netif = out->pid;
+    vrb.in_tag = byteorder_ntohs(frag->tag);
+    vrb.out_tag = ++_tag;
+    if (data[0] == SIXLOWPAN_UNCOMP) {
+        gnrc_sixlowpan_frag_vrb_t *entry;
+        gnrc_pktsnip_t *fwd;
+
+        if (pkt->size > out->sixlo.max_frag_size) {
+            return false;
+        }
+        if ((entry = gnrc_sixlowpan_frag_vrb_add(&vrb)) == NULL) {
+            return false;
+        }
+        gnrc_sixlowpan_frag_vrb_mark(entry, 0, uncomp_size);
+        if ((fwd = _vrb_copy(entry, pkt)) != NULL) {
+            /* the uncompressed header is carried inline, so only its hop
+             * limit has to be decremented */
+            data = ((uint8_t *)fwd->next->data) + sizeof(sixlowpan_frag_t);
+            data[dispatch_len + offsetof(ipv6_hdr_t, hl)]--;
+            gnrc_sixlowpan_dispatch_send(fwd, NULL, 0);
+        }
+    }
+    else {
+        gnrc_sixlowpan_frag_vrb_t *entry;
+        gnrc_pktsnip_t *fwd;
+
+        dec.ipv6.hl--;
+        fwd = _vrb_build_1st(&vrb, &dec.ipv6, (uint8_t *)&dec.udp, nh_len,
+                             data + dispatch_len, frag_size - dispatch_len,
+                             out->sixlo.max_frag_size);
+        if (fwd == NULL) {
+            return false;
+        }
+        if ((entry = gnrc_sixlowpan_frag_vrb_add(&vrb)) == NULL) {
+            gnrc_pktbuf_release(fwd);
+            return false;
+        }
+        gnrc_sixlowpan_frag_vrb_mark(entry, 0, uncomp_size);
+        gnrc_pktbuf_release(pkt);
+        DEBUG("6lo vrb: forward first fragment (datagram tag: %u => %u)\n",
+              entry->in_tag, entry->out_tag);
+        gnrc_sixlowpan_dispatch_send(fwd, NULL, 0);
+    }
+    return true;
+}
+
+/* tries to forward a fragment without reassembly, returns false if the
+ * fragment has to be added to the reassembly buffer */
+static bool _vrb_forward(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                         size_t frag_size, size_t offset)
+{
+    sixlowpan_frag_t *frag = pkt->data;
+    gnrc_sixlowpan_frag_vrb_t *entry;
+    gnrc_pktsnip_t *fwd;
+    gnrc_netif_t *out;
+
+    if (offset == 0) {
+        return _vrb_forward_1st(netif_hdr, pkt, frag_size);
+    }
+    entry = gnrc_sixlowpan_frag_vrb_get(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                                        netif_hdr->src_l2addr_len,
+                                        byteorder_ntohs(frag->disp_size) &
+                                        SIXLOWPAN_FRAG_SIZE_MASK,
+                                        byteorder_ntohs(frag->tag));
+    if (entry == NULL) {
+        return false;
+    }
+    if ((offset + frag_size) > entry->datagram_size) {
+        DEBUG("6lo vrb: fragment exceeds datagram size, dropping it\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    out = gnrc_netif_get_by_pid(entry->out_netif);
+    if ((out == NULL) || (pkt->size > out->sixlo.max_frag_size)) {
+        DEBUG("6lo vrb: can't forward fragment, dropping datagram\n");
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    if (gnrc_sixlowpan_frag_vrb_mark(entry, offset, frag_size) == 0) {
+        /* every unit was forwarded before, so don't count it twice */
+        DEBUG("6lo vrb: dropping duplicate fragment\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    if ((fwd = _vrb_copy(entry, pkt)) != NULL) {
+        DEBUG("6lo vrb: forward fragment (datagram tag: %u => %u)\n",
+              entry->in_tag, entry->out_tag);
+        gnrc_sixlowpan_dispatch_send(fwd, NULL, 0);
+    }
+    if (gnrc_sixlowpan_frag_vrb_complete(entry)) {
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+    }
+    return true;
+}
+#endif
+
 void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
 {
     gnrc_netif_hdr_t *hdr = pkt->next->data;
@@ -299,6 +579,12 @@ void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
             return;
     }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+    if (_vrb_forward(hdr, pkt, frag_size, offset)) {
+        return;
+    }
+#endif
+
     rbuf_add(hdr, pkt, frag_size, offset);
 
     gnrc_pktbuf_release(pkt);
@@ -307,6 +593,9 @@ void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
 void gnrc_sixlowpan_frag_gc_rbuf(void)
 {
     rbuf_gc();
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+    gnrc_sixlowpan_frag_vrb_gc();
+#endif
 }
 
 /** @} */
@@ -21,6 +21,9 @@
 #include "net/gnrc.h"
 #include "net/gnrc/sixlowpan.h"
 #include "net/gnrc/sixlowpan/frag.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+#include "net/gnrc/sixlowpan/frag/stats.h"
+#endif
 #include "net/sixlowpan.h"
 #include "thread.h"
 #include "xtimer.h"
@@ -29,22 +32,22 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-/* estimated fragment payload size to determinate RBUF_INT_SIZE, default to
- * MAC payload size - fragment header. */
-#ifndef GNRC_SIXLOWPAN_FRAG_SIZE
-/* assuming 64-bit source/destination address, source PAN ID omitted */
-#define GNRC_SIXLOWPAN_FRAG_SIZE (104 - 5)
-#endif
+/* index after the last unit covered by a fragment, the last fragment of a
+ * datagram may end within a unit */
+#define _RBUF_UNITS_END(offset, frag_size) \
+    (((offset) + (frag_size) + RBUF_UNIT_SIZE - 1) / RBUF_UNIT_SIZE)
 
-#ifndef RBUF_INT_SIZE
-/* same as ((int) ceil((double) N / D)) */
-#define DIV_CEIL(N, D) (((N) + (D) - 1) / (D))
-#define RBUF_INT_SIZE (DIV_CEIL(IPV6_MIN_MTU, GNRC_SIXLOWPAN_FRAG_SIZE) * RBUF_SIZE)
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+#define RBUF_STATS_INC(counter) (gnrc_sixlowpan_frag_stats_get()->counter++)
+#else
+#define RBUF_STATS_INC(counter)
 #endif
 
-static rbuf_int_t rbuf_int[RBUF_INT_SIZE];
-
 static rbuf_t rbuf[RBUF_SIZE];
+static rbuf_t *_buckets[RBUF_BUCKETS];
+
+/* bytes of the packet buffer currently occupied by rbuf */
+static size_t _used;
 
 static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 
@@ -54,14 +57,18 @@ static msg_t _gc_timer_msg = { .type = GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF };
 /* ------------------------------------
  * internal function definitions
  * ------------------------------------*/
-/* checks whether start and end overlaps, but not identical to, given interval i */
-static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, uint16_t end);
-/* gets a free entry from interval buffer */
-static rbuf_int_t *_rbuf_int_get_free(void);
+/* counts the units of a fragment already received for entry */
+static unsigned _rbuf_received(rbuf_t *entry, uint16_t offset, size_t frag_size);
+/* checks if a fragment has the same offset and size as a received one */
+static bool _rbuf_is_duplicate(rbuf_t *entry, uint16_t offset, size_t frag_size);
+/* hashes the tupel identifying an entry */
+static unsigned _rbuf_hash(const uint8_t *src, size_t src_len,
+                           const uint8_t *dst, size_t dst_len,
+                           size_t size, uint16_t tag);
 /* remove entry from reassembly buffer */
 static void _rbuf_rem(rbuf_t *entry);
-/* update interval buffer of entry */
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
+/* marks the units of a fragment as received for entry */
+static void _rbuf_set_received(rbuf_t *entry, uint16_t offset, size_t frag_size);
 /* gets an entry identified by its tupel */
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
@@ -76,22 +83,19 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     unsigned int data_offset = 0;
     size_t original_size = frag_size;
     sixlowpan_frag_t *frag = pkt->data;
-    rbuf_int_t *ptr;
+    unsigned received;
     uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
 
-    rbuf_gc();
     entry = _rbuf_get(gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len,
                       gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len,
                       byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK,
                       byteorder_ntohs(frag->tag));
 
     if (entry == NULL) {
-        DEBUG("6lo rbuf: reassembly buffer full.\n");
+        DEBUG("6lo rbuf: no space for datagram in reassembly buffer.\n");
         return;
     }
 
-    ptr = entry->ints;
-
     /* dispatches in the first fragment are ignored */
     if (offset == 0) {
         if (data[0] == SIXLOWPAN_UNCOMP) {
@@ -132,29 +136,31 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     /* If the fragment overlaps another fragment and differs in either the size
      * or the offset of the overlapped fragment, discards the datagram
      * https://tools.ietf.org/html/rfc4944#section-5.3 */
-    while (ptr != NULL) {
-        if (_rbuf_int_overlap_partially(ptr, offset, offset + frag_size - 1)) {
-            DEBUG("6lo rfrag: overlapping intervals, discarding datagram\n");
-            gnrc_pktbuf_release(entry->pkt);
-            _rbuf_rem(entry);
+    received = _rbuf_received(entry, offset, frag_size);
+    if ((received > 0) && !_rbuf_is_duplicate(entry, offset, frag_size)) {
+        DEBUG("6lo rfrag: overlapping fragments, discarding datagram\n");
+        RBUF_STATS_INC(overlaps);
+        gnrc_pktbuf_release(entry->pkt);
+        _rbuf_rem(entry);
 
-            /* "A fresh reassembly may be commenced with the most recently
-             * received link fragment"
-             * https://tools.ietf.org/html/rfc4944#section-5.3 */
-            rbuf_add(netif_hdr, pkt, original_size, offset);
+        /* "A fresh reassembly may be commenced with the most recently
+         * received link fragment"
+         * https://tools.ietf.org/html/rfc4944#section-5.3 */
+        rbuf_add(netif_hdr, pkt, original_size, offset);
 
-            return;
-        }
-
-        ptr = ptr->next;
+        return;
     }
 
-    if (_rbuf_update_ints(entry, offset, frag_size)) {
+    if (received == 0) {
         DEBUG("6lo rbuf: add fragment data\n");
+        _rbuf_set_received(entry, offset, frag_size);
         entry->cur_size += (uint16_t)frag_size;
         memcpy(((uint8_t *)entry->pkt->data) + offset + data_offset, data,
                frag_size - data_offset);
     }
+    else {
+        DEBUG("6lo rbuf: duplicate fragment, ignoring\n");
+    }
 
     if (entry->cur_size == entry->pkt->size) {
         gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(entry->src, entry->src_len,
@@ -177,145 +183,218 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         new_netif_hdr->lqi = netif_hdr->lqi;
         new_netif_hdr->rssi = netif_hdr->rssi;
         LL_APPEND(entry->pkt, netif);
+        RBUF_STATS_INC(datagrams);
         gnrc_sixlowpan_dispatch_recv(entry->pkt, NULL, 0);
         _rbuf_rem(entry);
     }
 }
 
-static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, uint16_t end)
+static unsigned _rbuf_received(rbuf_t *entry, uint16_t offset, size_t frag_size)
 {
-    /* start and ends are both inclusive, so using <= for both */
-    return ((i->start <= end) && (start <= i->end)) && /* overlaps */
-        ((start != i->start) || (end != i->end)); /* not identical */
-}
+    unsigned received = 0;
 
-static rbuf_int_t *_rbuf_int_get_free(void)
-{
-    for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
+    for (unsigned i = offset / RBUF_UNIT_SIZE;
+         i < _RBUF_UNITS_END(offset, frag_size); i++) {
+        if (bf_isset(entry->received, i)) {
+            received++;
         }
     }
-
-    return NULL;
+    return received;
 }
 
-static void _rbuf_rem(rbuf_t *entry)
+static bool _rbuf_is_duplicate(rbuf_t *entry, uint16_t offset, size_t frag_size)
 {
-    while (entry->ints != NULL) {
-        rbuf_int_t *next = entry->ints->next;
+    unsigned start = offset / RBUF_UNIT_SIZE;
+    unsigned end = _RBUF_UNITS_END(offset, frag_size);
 
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
-        entry->ints = next;
+    /* a received fragment starts with the same unit ... */
+    if (!bf_isset(entry->first, start)) {
+        return false;
     }
-
-    entry->pkt = NULL;
+    /* ... covers all the units of this one without another starting ... */
+    for (unsigned i = start + 1; i < end; i++) {
+        if (!bf_isset(entry->received, i) || bf_isset(entry->first, i)) {
+            return false;
+        }
+    }
+    /* ... and does not continue after them */
+    return (end >= _RBUF_UNITS_END(0, entry->datagram_size)) ||
+           !bf_isset(entry->received, end) || bf_isset(entry->first, end);
 }
 
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
+static unsigned _rbuf_hash(const uint8_t *src, size_t src_len,
+                           const uint8_t *dst, size_t dst_len,
+                           size_t size, uint16_t tag)
 {
-    rbuf_int_t *new;
-    uint16_t end = (uint16_t)(offset + frag_size - 1);
-
-    new = _rbuf_int_get_free();
+    /* FNV-1a */
+    uint32_t hash = 2166136261U;
 
-    if (new == NULL) {
-        DEBUG("6lo rfrag: no space left in rbuf interval buffer.\n");
-        return false;
+    for (unsigned i = 0; i < src_len; i++) {
+        hash = (hash ^ src[i]) * 16777619U;
+    }
+    for (unsigned i = 0; i < dst_len; i++) {
+        hash = (hash ^ dst[i]) * 16777619U;
     }
+    hash = (hash ^ (tag & 0xff)) * 16777619U;
+    hash = (hash ^ (tag >> 8)) * 16777619U;
+    hash = (hash ^ (size & 0xff)) * 16777619U;
+    hash = (hash ^ (size >> 8)) * 16777619U;
+    return hash % RBUF_BUCKETS;
+}
 
-    new->start = offset;
-    new->end = end;
+static void _rbuf_rem(rbuf_t *entry)
+{
+    rbuf_t **bucket = &_buckets[_rbuf_hash(entry->src, entry->src_len,
+                                           entry->dst, entry->dst_len,
+                                           entry->datagram_size, entry->tag)];
 
-    DEBUG("6lo rfrag: add interval (%" PRIu16 ", %" PRIu16 ") to entry (%s, ",
-          new->start, new->end, gnrc_netif_addr_to_str(entry->src,
-                                                       entry->src_len,
-                                                       l2addr_str));
+    LL_DELETE(*bucket, entry);
+    entry->next = NULL;
+    _used -= entry->datagram_size;
+    entry->pkt = NULL;
+}
+
+static void _rbuf_set_received(rbuf_t *entry, uint16_t offset, size_t frag_size)
+{
+    DEBUG("6lo rfrag: add fragment (%" PRIu16 ", %u) to entry (%s, ",
+          offset, (unsigned)(offset + frag_size - 1),
+          gnrc_netif_addr_to_str(entry->src, entry->src_len, l2addr_str));
     DEBUG("%s, %u, %u)\n", gnrc_netif_addr_to_str(entry->dst, entry->dst_len,
                                                   l2addr_str),
-          (unsigned)entry->pkt->size, entry->tag);
+          (unsigned)entry->datagram_size, entry->tag);
 
-    LL_PREPEND(entry->ints, new);
+    bf_set(entry->first, offset / RBUF_UNIT_SIZE);
+    for (unsigned i = offset / RBUF_UNIT_SIZE;
+         i < _RBUF_UNITS_END(offset, frag_size); i++) {
+        bf_set(entry->received, i);
+    }
+}
 
-    return true;
+static void _rbuf_set_gc_timer(uint32_t offset)
+{
+    xtimer_set_msg(&_gc_timer, offset, &_gc_timer_msg, sched_active_pid);
 }
 
 void rbuf_gc(void)
 {
     uint32_t now_usec = xtimer_now_usec();
-    unsigned int i;
+    uint32_t next = UINT32_MAX;
+
+    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
+        uint32_t age;
 
-    for (i = 0; i < RBUF_SIZE; i++) {
+        if (rbuf[i].pkt == NULL) {
+            continue;
+        }
+        age = now_usec - rbuf[i].arrival;
         /* since pkt occupies pktbuf, aggressivly collect garbage */
-        if ((rbuf[i].pkt != NULL) &&
-              ((now_usec - rbuf[i].arrival) > RBUF_TIMEOUT)) {
+        if (age > RBUF_TIMEOUT) {
             DEBUG("6lo rfrag: entry (%s, ",
                   gnrc_netif_addr_to_str(rbuf[i].src, rbuf[i].src_len,
                                          l2addr_str));
             DEBUG("%s, %u, %u) timed out\n",
                   gnrc_netif_addr_to_str(rbuf[i].dst, rbuf[i].dst_len,
                                          l2addr_str),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
+                  (unsigned)rbuf[i].datagram_size, rbuf[i].tag);
 
+            RBUF_STATS_INC(timeouts);
             gnrc_pktbuf_release(rbuf[i].pkt);
             _rbuf_rem(&(rbuf[i]));
         }
+        else if ((RBUF_TIMEOUT - age) < next) {
+            next = RBUF_TIMEOUT - age;
+        }
+    }
+    /* fragments refresh the arrival time without rescheduling the timer, so
+     * schedule it for the next entry to time out, if any */
+    if (next != UINT32_MAX) {
+        _rbuf_set_gc_timer(next + 1);
+    }
+    else {
+        xtimer_remove(&_gc_timer);
     }
 }
 
-static inline void _set_rbuf_timeout(void)
+static rbuf_t *_rbuf_get_free(void)
 {
-    xtimer_set_msg(&_gc_timer, RBUF_TIMEOUT, &_gc_timer_msg, sched_active_pid);
+    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
+        if (rbuf[i].pkt == NULL) {
+            return &(rbuf[i]);
+        }
+    }
+    return NULL;
+}
+
+static rbuf_t *_rbuf_oldest(void)
+{
+    rbuf_t *oldest = NULL;
+
+    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
+        /* note that xtimer_now will overflow in ~1.2 hours */
+        if ((rbuf[i].pkt != NULL) &&
+            ((oldest == NULL) ||
+             ((rbuf[i].arrival - oldest->arrival) > UINT32_MAX / 2))) {
+            oldest = &(rbuf[i]);
+        }
+    }
+    return oldest;
 }
 
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
                          size_t size, uint16_t tag)
 {
-    rbuf_t *res = NULL, *oldest = NULL;
+    rbuf_t *res = NULL, *oldest, **bucket;
     uint32_t now_usec = xtimer_now_usec();
 
-    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
+    bucket = &_buckets[_rbuf_hash(src, src_len, dst, dst_len, size, tag)];
+    LL_FOREACH(*bucket, res) {
         /* check first if entry already available */
-        if ((rbuf[i].pkt != NULL) && (rbuf[i].pkt->size == size) &&
-            (rbuf[i].tag == tag) && (rbuf[i].src_len == src_len) &&
-            (rbuf[i].dst_len == dst_len) &&
-            (memcmp(rbuf[i].src, src, src_len) == 0) &&
-            (memcmp(rbuf[i].dst, dst, dst_len) == 0)) {
-            DEBUG("6lo rfrag: entry %p (%s, ", (void *)(&rbuf[i]),
-                  gnrc_netif_addr_to_str(rbuf[i].src, rbuf[i].src_len,
+        if ((res->datagram_size == size) && (res->tag == tag) &&
+            (res->src_len == src_len) && (res->dst_len == dst_len) &&
+            (memcmp(res->src, src, src_len) == 0) &&
+            (memcmp(res->dst, dst, dst_len) == 0)) {
+            DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
+                  gnrc_netif_addr_to_str(res->src, res->src_len,
                                          l2addr_str));
             DEBUG("%s, %u, %u) found\n",
-                  gnrc_netif_addr_to_str(rbuf[i].dst, rbuf[i].dst_len,
+                  gnrc_netif_addr_to_str(res->dst, res->dst_len,
                                          l2addr_str),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-            rbuf[i].arrival = now_usec;
-            _set_rbuf_timeout();
-            return &(rbuf[i]);
+                  (unsigned)res->datagram_size, res->tag);
+            res->arrival = now_usec;
+            return res;
         }
+    }
 
-        /* if there is a free spot: remember it */
-        if ((res == NULL) && (rbuf[i].pkt == NULL)) {
-            res = &(rbuf[i]);
-        }
+    if (size > RBUF_BUDGET) {
+        DEBUG("6lo rfrag: datagram of size %u exceeds reassembly buffer\n",
+              (unsigned)size);
+        return NULL;
+    }
 
-        /* remember oldest slot */
-        /* note that xtimer_now will overflow in ~1.2 hours */
-        if ((oldest == NULL) || (oldest->arrival - rbuf[i].arrival < UINT32_MAX / 2)) {
-            oldest = &(rbuf[i]);
-        }
+    oldest = _rbuf_oldest();
+    if ((oldest != NULL) && ((now_usec - oldest->arrival) > RBUF_TIMEOUT)) {
+        /* the message of the garbage collection timer got lost, e.g. in a
+         * full message queue: collect now, which also restarts the timer */
+        rbuf_gc();
+        oldest = _rbuf_oldest();
+    }
+    if (oldest == NULL) {
+        /* the timer runs as long as there are entries, so it only needs to
+         * be started for the first one */
+        _rbuf_set_gc_timer(RBUF_TIMEOUT + 1);
     }
 
-    /* entry not in buffer and no empty spot found */
-    if (res == NULL) {
+    /* make room for the datagram, oldest entries go first */
+    while (((_used + size) > RBUF_BUDGET) ||
+           ((res = _rbuf_get_free()) == NULL)) {
+        oldest = _rbuf_oldest();
+        /* if there are no entries, the datagram fits */
         assert(oldest != NULL);
-        assert(oldest->pkt != NULL); /* if oldest->pkt == NULL, res must not be NULL */
         DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
+        RBUF_STATS_INC(evictions);
         gnrc_pktbuf_release(oldest->pkt);
         _rbuf_rem(oldest);
-        res = oldest;
     }
 
     /* now we have an empty spot */
@@ -334,7 +413,12 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
     res->src_len = src_len;
     res->dst_len = dst_len;
     res->tag = tag;
+    res->datagram_size = size;
     res->cur_size = 0;
+    memset(res->received, 0, sizeof(res->received));
+    memset(res->first, 0, sizeof(res->first));
+    LL_PREPEND(*bucket, res);
+    _used += size;
 
     DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
           gnrc_netif_addr_to_str(res->src, res->src_len, l2addr_str));
@@ -342,8 +426,6 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
           gnrc_netif_addr_to_str(res->dst, res->dst_len, l2addr_str), (unsigned)res->pkt->size,
           res->tag);
 
-    _set_rbuf_timeout();
-
     return res;
 }
 
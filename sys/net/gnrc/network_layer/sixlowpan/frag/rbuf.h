@@ -21,8 +21,11 @@
 
 #include <inttypes.h>
 
+#include "bitfield.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
+#include "net/ipv6.h"
+#include "net/sixlowpan.h"
 
 #include "net/gnrc/sixlowpan/frag.h"
 #ifdef __cplusplus
@@ -31,26 +34,65 @@ extern "C" {
 #endif
 
 #define RBUF_L2ADDR_MAX_LEN (8U)               /**< maximum length for link-layer addresses */
-#define RBUF_SIZE           (4U)               /**< size of the reassembly buffer */
-#define RBUF_TIMEOUT        (3U * US_PER_SEC) /**< timeout for reassembly in microseconds */
 
 /**
- * @brief   Fragment intervals to identify limits of fragments.
+ * @brief   Timeout for reassembly in microseconds
+ */
+#ifndef RBUF_TIMEOUT
+#define RBUF_TIMEOUT        (3U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Maximum number of datagrams in the reassembly buffer
  *
- * @note    Fragments MUST NOT overlap and overlapping fragments are to be
- *          discarded
+ * How many of them can actually be reassembled at the same time is limited by
+ * @ref RBUF_BUDGET.
+ */
+#ifndef RBUF_SIZE
+#define RBUF_SIZE           (8U)
+#endif
+
+/**
+ * @brief   Maximum number of bytes all datagrams in the reassembly buffer may
+ *          occupy in the packet buffer together
+ *
+ * When a new datagram does not fit, the oldest datagrams are removed until it
+ * does. Datagrams larger than the budget are dropped.
+ */
+#ifndef RBUF_BUDGET
+#define RBUF_BUDGET         (4U * IPV6_MIN_MTU)
+#endif
+
+/**
+ * @brief   Number of hash buckets to look up datagrams in the reassembly buffer
+ */
+#ifndef RBUF_BUCKETS
+#define RBUF_BUCKETS        (8U)
+#endif
+
+/**
+ * @brief   Granularity in bytes in which the reception of a datagram is tracked
+ *
+ * All fragments but the last of a datagram have a multiple of this size, as
+ * fragment offsets are given in units of 8 bytes.
+ *
+ * A fragment overlapping received fragments is ignored as a duplicate when it
+ * has the offset and size of one of them. Otherwise the datagram is discarded
+ * and reassembly restarts with the fragment. Sizes are compared in units, so
+ * fragments ending within the same unit count as the same size. Only the last
+ * fragment may do so, since it ends with the datagram.
  *
  * @see <a href="https://tools.ietf.org/html/rfc4944#section-5.3">
  *          RFC 4944, section 5.3
  *      </a>
- *
- * @internal
  */
-typedef struct rbuf_int {
-    struct rbuf_int *next;  /**< next element in interval list */
-    uint16_t start;         /**< start byte of interval */
-    uint16_t end;           /**< end byte of interval */
-} rbuf_int_t;
+#define RBUF_UNIT_SIZE      (8U)
+
+/**
+ * @brief   Number of units of @ref RBUF_UNIT_SIZE in the largest datagram
+ */
+#define RBUF_UNITS          ((SIXLOWPAN_FRAG_SIZE_MASK + RBUF_UNIT_SIZE) / \
+                             RBUF_UNIT_SIZE)
 
 /**
  * @brief   An entry in the 6LoWPAN reassembly buffer.
@@ -59,7 +101,7 @@ typedef struct rbuf_int {
  *
  * 1. the source address,
  * 2. the destination address,
- * 3. the datagram size (gnrc_pktsnip_t::size of rbuf_t::pkt), and
+ * 3. the datagram size (rbuf_t::datagram_size), and
  * 4. the datagram tag
  *
  * to identify all fragments that belong to the given datagram.
@@ -70,8 +112,8 @@ typedef struct rbuf_int {
  *
  * @internal
  */
-typedef struct {
-    rbuf_int_t *ints;                   /**< intervals of the fragment */
+typedef struct rbuf {
+    struct rbuf *next;                  /**< next entry in the same hash bucket */
     gnrc_pktsnip_t *pkt;                /**< the reassembled packet in packet buffer */
     uint32_t arrival;                   /**< time in microseconds of arrival of
                                          *   last received fragment */
@@ -80,7 +122,11 @@ typedef struct {
     uint8_t src_len;                    /**< length of source address */
     uint8_t dst_len;                    /**< length of destination address */
     uint16_t tag;                       /**< the datagram's tag */
+    uint16_t datagram_size;             /**< the datagram's size */
     uint16_t cur_size;                  /**< the datagram's current size */
+    BITFIELD(received, RBUF_UNITS);     /**< received units of the datagram */
+    BITFIELD(first, RBUF_UNITS);        /**< units a received fragment starts
+                                         *   with */
 } rbuf_t;
 
 /**
@@ -102,6 +148,9 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *frag,
 
 /**
  * @brief   Checks timeouts and removes entries if necessary
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF. The timer sending this
+ * message is only running while there are entries in the reassembly buffer.
  */
 void rbuf_gc(void);
 
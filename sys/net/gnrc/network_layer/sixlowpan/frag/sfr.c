@@ -0,0 +1,545 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/internal.h"
+#include "utlist.h"
+
+#include "net/gnrc/sixlowpan/frag/sfr.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* bit of a sequence number in a bitmap */
+#define SEQ_BIT(seq)    (0x80000000UL >> (seq))
+
+/* a datagram that is reassembled */
+typedef struct {
+    /* the datagram so far, NULL if it is complete or nothing was received */
+    gnrc_pktsnip_t *pkt;
+    uint32_t arrival;       /* time of the last fragment */
+    uint32_t received;      /* received fragments */
+    uint8_t src[GNRC_NETIF_HDR_L2ADDR_MAX_LEN];
+    uint8_t dst[GNRC_NETIF_HDR_L2ADDR_MAX_LEN];
+    uint8_t src_len;
+    uint8_t dst_len;
+    kernel_pid_t if_pid;
+    uint16_t datagram_size; /* 0 until fragment 0 arrived */
+    uint16_t cur_size;      /* bytes received so far */
+    uint8_t tag;
+    bool used;
+} _rbuf_t;
+
+static gnrc_sixlowpan_frag_sfr_fbuf_t _fbuf[GNRC_SIXLOWPAN_SFR_FBUF_SIZE];
+static _rbuf_t _rbuf[GNRC_SIXLOWPAN_SFR_RBUF_SIZE];
+static xtimer_t _gc_timer;
+static msg_t _gc_msg = { .type = GNRC_SIXLOWPAN_MSG_SFR_GC };
+static uint8_t _tag;
+
+static inline uint32_t _all_frags(const gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf)
+{
+    return (fbuf->frags > SIXLOWPAN_SFR_SEQ_MAX) ? 0xffffffffUL
+                                                 : ~(0xffffffffUL >> fbuf->frags);
+}
+
+static void _fbuf_rm(gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf)
+{
+    xtimer_remove(&fbuf->arq_timer);
+    gnrc_pktbuf_release(fbuf->pkt);
+    fbuf->pkt = NULL;
+}
+
+/* copies size bytes from offset of the data in pkt to data */
+static void _copy(gnrc_pktsnip_t *pkt, size_t offset, uint8_t *data,
+                  size_t size)
+{
+    while ((pkt != NULL) && (offset >= pkt->size)) {
+        offset -= pkt->size;
+        pkt = pkt->next;
+    }
+    while ((pkt != NULL) && (size > 0)) {
+        size_t len = pkt->size - offset;
+
+        if (len > size) {
+            len = size;
+        }
+        memcpy(data, ((uint8_t *)pkt->data) + offset, len);
+        data += len;
+        size -= len;
+        offset = 0;
+        pkt = pkt->next;
+    }
+}
+
+static bool _send_frag(gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf, unsigned seq,
+                       bool ack_req)
+{
+    gnrc_netif_hdr_t *hdr = fbuf->pkt->data;
+    gnrc_pktsnip_t *netif, *frag;
+    uint16_t offset = seq * fbuf->frag_size;
+    uint16_t size = fbuf->datagram_size - offset;
+
+    if (size > fbuf->frag_size) {
+        size = fbuf->frag_size;
+    }
+    netif = gnrc_netif_hdr_build(gnrc_netif_hdr_get_src_addr(hdr),
+                                 hdr->src_l2addr_len,
+                                 gnrc_netif_hdr_get_dst_addr(hdr),
+                                 hdr->dst_l2addr_len);
+    if (netif == NULL) {
+        DEBUG("6lo sfr: error allocating link-layer header\n");
+        return false;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = hdr->if_pid;
+    ((gnrc_netif_hdr_t *)netif->data)->flags = hdr->flags;
+    frag = gnrc_pktbuf_add(NULL, NULL, sizeof(sixlowpan_sfr_rfrag_t) + size,
+                           GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        DEBUG("6lo sfr: error allocating fragment\n");
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    /* the first fragment carries the datagram size instead of its offset */
+    sixlowpan_sfr_rfrag_set(frag->data, fbuf->tag, seq, size,
+                            (seq == 0) ? fbuf->datagram_size : offset,
+                            ack_req);
+    _copy(fbuf->pkt->next, offset,
+          ((uint8_t *)frag->data) + sizeof(sixlowpan_sfr_rfrag_t), size);
+    netif->next = frag;
+    DEBUG("6lo sfr: send fragment %u of datagram %u (offset: %u, size: %u%s)\n",
+          seq, fbuf->tag, offset, size, (ack_req) ? ", ack requested" : "");
+    gnrc_sixlowpan_dispatch_send(netif, NULL, 0);
+    return true;
+}
+
+/* sends the unacknowledged fragments in flight again and new fragments until
+ * the window is full, the last one requests an acknowledgment */
+static void _send_window(gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf)
+{
+    unsigned in_flight = 0, last = 0, sent = fbuf->sent;
+
+    for (unsigned seq = 0; seq < fbuf->frags; seq++) {
+        if ((seq < sent) ? !(fbuf->acked & SEQ_BIT(seq))
+                         : (in_flight < GNRC_SIXLOWPAN_SFR_WIN_SIZE)) {
+            in_flight++;
+            last = seq;
+        }
+    }
+    for (unsigned seq = 0; seq <= last; seq++) {
+        if ((seq < sent) && (fbuf->acked & SEQ_BIT(seq))) {
+            continue;
+        }
+        if (!_send_frag(fbuf, seq, (seq == last))) {
+            _fbuf_rm(fbuf);
+            return;
+        }
+        if (seq >= fbuf->sent) {
+            fbuf->sent = seq + 1;
+        }
+    }
+    xtimer_set_msg(&fbuf->arq_timer, GNRC_SIXLOWPAN_SFR_ARQ_TIMEOUT,
+                   &fbuf->arq_msg, sched_active_pid);
+}
+
+int gnrc_sixlowpan_frag_sfr_send(gnrc_pktsnip_t *pkt, gnrc_netif_t *netif)
+{
+    gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf = NULL;
+    size_t datagram_size = gnrc_pkt_len(pkt->next);
+    unsigned frag_size = netif->sixlo.max_frag_size -
+                         sizeof(sixlowpan_sfr_rfrag_t);
+    unsigned frags;
+
+    assert(((gnrc_netif_hdr_t *)pkt->data)->dst_l2addr_len > 0);
+    if (frag_size > SIXLOWPAN_SFR_FRAG_SIZE_MASK) {
+        frag_size = SIXLOWPAN_SFR_FRAG_SIZE_MASK;
+    }
+    frags = (datagram_size + frag_size - 1) / frag_size;
+    if (frags > (SIXLOWPAN_SFR_SEQ_MAX + 1)) {
+        DEBUG("6lo sfr: datagram too big (%u bytes)\n",
+              (unsigned)datagram_size);
+        return -EMSGSIZE;
+    }
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_SFR_FBUF_SIZE; i++) {
+        if (_fbuf[i].pkt == NULL) {
+            fbuf = &_fbuf[i];
+            break;
+        }
+    }
+    if (fbuf == NULL) {
+        DEBUG("6lo sfr: fragmentation buffer full\n");
+        return -ENOBUFS;
+    }
+    fbuf->pkt = pkt;
+    fbuf->arq_msg.type = GNRC_SIXLOWPAN_MSG_SFR_ARQ_TIMEOUT;
+    fbuf->arq_msg.content.ptr = fbuf;
+    fbuf->acked = 0;
+    fbuf->datagram_size = datagram_size;
+    fbuf->frag_size = frag_size;
+    fbuf->tag = _tag++;
+    fbuf->frags = frags;
+    fbuf->sent = 0;
+    fbuf->retries = 0;
+    _send_window(fbuf);
+    return 0;
+}
+
+void gnrc_sixlowpan_frag_sfr_arq_timeout(gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf)
+{
+    if (fbuf->pkt == NULL) {
+        /* acknowledged while the timeout was queued */
+        return;
+    }
+    if (++fbuf->retries > GNRC_SIXLOWPAN_SFR_FRAG_RETRIES) {
+        DEBUG("6lo sfr: datagram %u not acknowledged, dropping it\n",
+              fbuf->tag);
+        _fbuf_rm(fbuf);
+        return;
+    }
+    DEBUG("6lo sfr: acknowledgment timeout for datagram %u\n", fbuf->tag);
+    /* only probe with the last fragment in flight, the acknowledgment tells
+     * which of the others are missing */
+    for (unsigned seq = fbuf->sent; seq > 0; seq--) {
+        if (!(fbuf->acked & SEQ_BIT(seq - 1))) {
+            if (!_send_frag(fbuf, seq - 1, true)) {
+                _fbuf_rm(fbuf);
+                return;
+            }
+            break;
+        }
+    }
+    xtimer_set_msg(&fbuf->arq_timer, GNRC_SIXLOWPAN_SFR_ARQ_TIMEOUT,
+                   &fbuf->arq_msg, sched_active_pid);
+}
+
+static void _handle_ack(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt)
+{
+    sixlowpan_sfr_ack_t *ack = pkt->data;
+    uint32_t bitmap;
+
+    if (pkt->size < sizeof(sixlowpan_sfr_ack_t)) {
+        DEBUG("6lo sfr: RFRAG-ACK too short\n");
+        return;
+    }
+    bitmap = ((uint32_t)ack->bitmap[0] << 24) |
+             ((uint32_t)ack->bitmap[1] << 16) |
+             ((uint32_t)ack->bitmap[2] << 8) | ack->bitmap[3];
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_SFR_FBUF_SIZE; i++) {
+        gnrc_sixlowpan_frag_sfr_fbuf_t *fbuf = &_fbuf[i];
+        gnrc_netif_hdr_t *hdr;
+
+        if ((fbuf->pkt == NULL) || (fbuf->tag != ack->base.tag)) {
+            continue;
+        }
+        hdr = fbuf->pkt->data;
+        if ((hdr->dst_l2addr_len != netif_hdr->src_l2addr_len) ||
+            (memcmp(gnrc_netif_hdr_get_dst_addr(hdr),
+                    gnrc_netif_hdr_get_src_addr(netif_hdr),
+                    hdr->dst_l2addr_len) != 0)) {
+            continue;
+        }
+        xtimer_remove(&fbuf->arq_timer);
+        if (bitmap == 0) {
+            DEBUG("6lo sfr: datagram %u aborted by receiver\n", fbuf->tag);
+            _fbuf_rm(fbuf);
+        }
+        else if (((fbuf->acked |= bitmap) & _all_frags(fbuf)) ==
+                 _all_frags(fbuf)) {
+            DEBUG("6lo sfr: datagram %u acknowledged\n", fbuf->tag);
+            _fbuf_rm(fbuf);
+        }
+        else {
+            fbuf->retries = 0;
+            _send_window(fbuf);
+        }
+        return;
+    }
+    DEBUG("6lo sfr: RFRAG-ACK for unknown datagram %u\n", ack->base.tag);
+}
+
+static void _send_ack(_rbuf_t *entry)
+{
+    gnrc_pktsnip_t *netif, *ack;
+    sixlowpan_sfr_ack_t *hdr;
+
+    netif = gnrc_netif_hdr_build(NULL, 0, entry->src, entry->src_len);
+    if (netif == NULL) {
+        DEBUG("6lo sfr: error allocating link-layer header\n");
+        return;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = entry->if_pid;
+    ack = gnrc_pktbuf_add(NULL, NULL, sizeof(sixlowpan_sfr_ack_t),
+                          GNRC_NETTYPE_SIXLOWPAN);
+    if (ack == NULL) {
+        DEBUG("6lo sfr: error allocating RFRAG-ACK\n");
+        gnrc_pktbuf_release(netif);
+        return;
+    }
+    hdr = ack->data;
+    hdr->base.disp_ecn = SIXLOWPAN_SFR_ACK_DISP;
+    hdr->base.tag = entry->tag;
+    hdr->bitmap[0] = (uint8_t)(entry->received >> 24);
+    hdr->bitmap[1] = (uint8_t)(entry->received >> 16);
+    hdr->bitmap[2] = (uint8_t)(entry->received >> 8);
+    hdr->bitmap[3] = (uint8_t)entry->received;
+    netif->next = ack;
+    gnrc_sixlowpan_dispatch_send(netif, NULL, 0);
+}
+
+static void _rbuf_rm(_rbuf_t *entry)
+{
+    if (entry->pkt != NULL) {
+        gnrc_pktbuf_release(entry->pkt);
+        entry->pkt = NULL;
+    }
+    entry->used = false;
+}
+
+/* removes entry if it timed out, returns true if entry is unused */
+static bool _rbuf_expire(_rbuf_t *entry, uint32_t now)
+{
+    if (entry->used &&
+        ((now - entry->arrival) > GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT)) {
+        DEBUG("6lo sfr: reassembly of datagram %u timed out\n", entry->tag);
+        _rbuf_rm(entry);
+    }
+    return !entry->used;
+}
+
+static _rbuf_t *_rbuf_get(gnrc_netif_hdr_t *netif_hdr, uint8_t tag)
+{
+    _rbuf_t *free = NULL;
+    uint32_t now = xtimer_now_usec();
+    bool others = false;
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_SFR_RBUF_SIZE; i++) {
+        _rbuf_t *entry = &_rbuf[i];
+
+        if (_rbuf_expire(entry, now)) {
+            if (free == NULL) {
+                free = entry;
+            }
+            continue;
+        }
+        if ((entry->tag == tag) && (entry->if_pid == netif_hdr->if_pid) &&
+            (entry->src_len == netif_hdr->src_l2addr_len) &&
+            (entry->dst_len == netif_hdr->dst_l2addr_len) &&
+            (memcmp(entry->src, gnrc_netif_hdr_get_src_addr(netif_hdr),
+                    entry->src_len) == 0) &&
+            (memcmp(entry->dst, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                    entry->dst_len) == 0)) {
+            entry->arrival = now;
+            return entry;
+        }
+        others = true;
+    }
+    if ((free == NULL) ||
+        (netif_hdr->src_l2addr_len > sizeof(free->src)) ||
+        (netif_hdr->dst_l2addr_len > sizeof(free->dst))) {
+        return NULL;
+    }
+    memset(free, 0, sizeof(*free));
+    memcpy(free->src, gnrc_netif_hdr_get_src_addr(netif_hdr),
+           netif_hdr->src_l2addr_len);
+    memcpy(free->dst, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+           netif_hdr->dst_l2addr_len);
+    free->src_len = netif_hdr->src_l2addr_len;
+    free->dst_len = netif_hdr->dst_l2addr_len;
+    free->if_pid = netif_hdr->if_pid;
+    free->arrival = now;
+    free->tag = tag;
+    free->used = true;
+    /* the timer runs as long as there are reassemblies, so it only needs to
+     * be started for the first one */
+    if (!others) {
+        xtimer_set_msg(&_gc_timer, GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT + 1,
+                       &_gc_msg, sched_active_pid);
+    }
+    return free;
+}
+
+/* makes room for the bytes of a fragment up to end in the datagram of entry,
+ * datagram_size is the size from fragment 0 or 0 for any other fragment */
+static int _rbuf_fit(_rbuf_t *entry, unsigned datagram_size, unsigned end)
+{
+    size_t size = (entry->pkt != NULL) ? entry->pkt->size : 0;
+
+    if (datagram_size > 0) {
+        if (size > datagram_size) {
+            /* an earlier fragment exceeds the datagram */
+            return -EINVAL;
+        }
+        entry->datagram_size = datagram_size;
+        size = datagram_size;
+    }
+    else if (entry->datagram_size > 0) {
+        if (end > entry->datagram_size) {
+            return -EINVAL;
+        }
+    }
+    else if (end > size) {
+        /* grow the datagram until fragment 0 tells its size */
+        size = end;
+    }
+    if (entry->pkt == NULL) {
+        entry->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_SIXLOWPAN);
+        return (entry->pkt == NULL) ? -ENOMEM : 0;
+    }
+    if ((size != entry->pkt->size) &&
+        (gnrc_pktbuf_realloc_data(entry->pkt, size) != 0)) {
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+/* passes a complete datagram to 6LoWPAN again to decompress it */
+static void _rbuf_complete(_rbuf_t *entry, gnrc_netif_hdr_t *netif_hdr)
+{
+    gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(entry->src, entry->src_len,
+                                                 entry->dst, entry->dst_len);
+    gnrc_pktsnip_t *pkt = entry->pkt;
+
+    /* keep the entry to acknowledge repeated fragments until it times out */
+    entry->pkt = NULL;
+    if (netif == NULL) {
+        DEBUG("6lo sfr: error allocating link-layer header\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = netif_hdr->if_pid;
+    ((gnrc_netif_hdr_t *)netif->data)->flags = netif_hdr->flags;
+    ((gnrc_netif_hdr_t *)netif->data)->lqi = netif_hdr->lqi;
+    ((gnrc_netif_hdr_t *)netif->data)->rssi = netif_hdr->rssi;
+    LL_APPEND(pkt, netif);
+    if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN,
+                                      GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        DEBUG("6lo sfr: no receivers for reassembled datagram\n");
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static void _handle_rfrag(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt)
+{
+    sixlowpan_sfr_rfrag_t *rfrag = pkt->data;
+    unsigned seq, frag_size, offset, datagram_size = 0;
+    _rbuf_t *entry;
+
+    if (pkt->size < sizeof(sixlowpan_sfr_rfrag_t)) {
+        DEBUG("6lo sfr: RFRAG too short\n");
+        return;
+    }
+    seq = sixlowpan_sfr_rfrag_get_seq(rfrag);
+    frag_size = sixlowpan_sfr_rfrag_get_frag_size(rfrag);
+    offset = byteorder_ntohs(rfrag->offset);
+    if (frag_size != (pkt->size - sizeof(sixlowpan_sfr_rfrag_t))) {
+        DEBUG("6lo sfr: RFRAG size mismatch\n");
+        return;
+    }
+    if (seq == 0) {
+        /* the offset field carries the datagram size */
+        datagram_size = offset;
+        offset = 0;
+        if ((datagram_size == 0) || (frag_size > datagram_size)) {
+            DEBUG("6lo sfr: invalid datagram size %u\n", datagram_size);
+            return;
+        }
+    }
+    /* the size is chosen by the sender, so don't let it take up more of the
+     * packet buffer than a datagram can */
+    if ((datagram_size > GNRC_SIXLOWPAN_SFR_DATAGRAM_MAX) ||
+        ((offset + frag_size) > GNRC_SIXLOWPAN_SFR_DATAGRAM_MAX)) {
+        DEBUG("6lo sfr: fragment %u of datagram %u exceeds maximum size\n",
+              seq, rfrag->base.tag);
+        return;
+    }
+    /* any fragment starts a reassembly, so the acknowledgment requests the
+     * ones missing before it */
+    entry = _rbuf_get(netif_hdr, rfrag->base.tag);
+    if (entry == NULL) {
+        DEBUG("6lo sfr: no space to reassemble datagram %u\n",
+              rfrag->base.tag);
+        return;
+    }
+    /* a complete datagram keeps only its bitmap */
+    if (((entry->pkt != NULL) || (entry->received == 0)) &&
+        !(entry->received & SEQ_BIT(seq))) {
+        int res = _rbuf_fit(entry, datagram_size, offset + frag_size);
+
+        if (res == -EINVAL) {
+            DEBUG("6lo sfr: fragment exceeds datagram, aborting it\n");
+            entry->received = 0;
+            _send_ack(entry);
+            _rbuf_rm(entry);
+            return;
+        }
+        if (res < 0) {
+            DEBUG("6lo sfr: error allocating datagram\n");
+            _rbuf_rm(entry);
+            return;
+        }
+        memcpy(((uint8_t *)entry->pkt->data) + offset, rfrag + 1, frag_size);
+        entry->received |= SEQ_BIT(seq);
+        entry->cur_size += frag_size;
+    }
+    if (sixlowpan_sfr_rfrag_ack_req(rfrag)) {
+        _send_ack(entry);
+    }
+    if ((entry->pkt != NULL) && (entry->datagram_size > 0) &&
+        (entry->cur_size == entry->datagram_size)) {
+        DEBUG("6lo sfr: datagram %u complete\n", entry->tag);
+        _rbuf_complete(entry, netif_hdr);
+    }
+}
+
+void gnrc_sixlowpan_frag_sfr_handle_pkt(gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->next->data;
+
+    if (sixlowpan_sfr_ack_is(pkt->data)) {
+        _handle_ack(netif_hdr, pkt);
+    }
+    else {
+        _handle_rfrag(netif_hdr, pkt);
+    }
+    gnrc_pktbuf_release(pkt);
+}
+
+void gnrc_sixlowpan_frag_sfr_gc(void)
+{
+    uint32_t now = xtimer_now_usec();
+    uint32_t next = UINT32_MAX;
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_SFR_RBUF_SIZE; i++) {
+        if (!_rbuf_expire(&_rbuf[i], now) &&
+            ((GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT - (now - _rbuf[i].arrival)) <
+             next)) {
+            next = GNRC_SIXLOWPAN_SFR_RBUF_TIMEOUT - (now - _rbuf[i].arrival);
+        }
+    }
+    /* fragments refresh the arrival time without rescheduling the timer, so
+     * schedule it for the next reassembly to time out, if any */
+    if (next != UINT32_MAX) {
+        xtimer_set_msg(&_gc_timer, next + 1, &_gc_msg, sched_active_pid);
+    }
+}
+
+/** @} */
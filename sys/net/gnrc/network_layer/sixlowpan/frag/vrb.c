@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static gnrc_sixlowpan_frag_vrb_t _vrb[GNRC_SIXLOWPAN_FRAG_VRB_SIZE];
+
+/* removes entry if it timed out, returns true if entry is unused */
+static bool _expire(gnrc_sixlowpan_frag_vrb_t *entry, uint32_t now)
+{
+    if ((entry->datagram_size > 0) &&
+        ((now - entry->arrival) > GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT)) {
+        DEBUG("6lo vrb: entry %u timed out\n", (unsigned)(entry - _vrb));
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+    }
+    return (entry->datagram_size == 0);
+}
+
+static inline bool _match(const gnrc_sixlowpan_frag_vrb_t *entry,
+                          const uint8_t *src, size_t src_len,
+                          unsigned datagram_size, unsigned tag)
+{
+    return (entry->datagram_size == datagram_size) &&
+           (entry->in_tag == tag) &&
+           (entry->src_len == src_len) &&
+           (memcmp(entry->src, src, src_len) == 0);
+}
+
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_add(
+        const gnrc_sixlowpan_frag_vrb_t *entry)
+{
+    gnrc_sixlowpan_frag_vrb_t *free = NULL;
+    uint32_t now = xtimer_now_usec();
+
+    assert((entry != NULL) && (entry->datagram_size > 0));
+    assert(entry->src_len <= GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX_LEN);
+    assert(entry->out_dst_len <= GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX_LEN);
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; i++) {
+        gnrc_sixlowpan_frag_vrb_t *ptr = &_vrb[i];
+
+        if (_match(ptr, entry->src, entry->src_len, entry->datagram_size,
+                   entry->in_tag)) {
+            DEBUG("6lo vrb: replacing entry %u\n", i);
+            free = ptr;
+            break;
+        }
+        if ((free == NULL) && _expire(ptr, now)) {
+            free = ptr;
+        }
+    }
+    if (free == NULL) {
+        DEBUG("6lo vrb: virtual reassembly buffer full\n");
+        return NULL;
+    }
+    *free = *entry;
+    free->arrival = now;
+    free->forwarded_numof = 0;
+    memset(free->forwarded, 0, sizeof(free->forwarded));
+    return free;
+}
+
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_get(const uint8_t *src,
+                                                       size_t src_len,
+                                                       unsigned datagram_size,
+                                                       unsigned tag)
+{
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; i++) {
+        if (_match(&_vrb[i], src, src_len, datagram_size, tag)) {
+            return _expire(&_vrb[i], xtimer_now_usec()) ? NULL : &_vrb[i];
+        }
+    }
+    return NULL;
+}
+
+unsigned gnrc_sixlowpan_frag_vrb_mark(gnrc_sixlowpan_frag_vrb_t *entry,
+                                      size_t offset, size_t size)
+{
+    unsigned end = (offset + size + GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE - 1) /
+                   GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE;
+    unsigned marked = 0;
+
+    assert(end <= GNRC_SIXLOWPAN_FRAG_VRB_UNITS);
+    for (unsigned i = offset / GNRC_SIXLOWPAN_FRAG_VRB_UNIT_SIZE; i < end;
+         i++) {
+        if (!bf_isset(entry->forwarded, i)) {
+            bf_set(entry->forwarded, i);
+            marked++;
+        }
+    }
+    entry->forwarded_numof += marked;
+    entry->arrival = xtimer_now_usec();
+    return marked;
+}
+
+void gnrc_sixlowpan_frag_vrb_gc(void)
+{
+    uint32_t now = xtimer_now_usec();
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; i++) {
+        _expire(&_vrb[i], now);
+    }
+}
+
+/** @} */
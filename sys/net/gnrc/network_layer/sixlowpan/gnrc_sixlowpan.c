@@ -20,6 +20,9 @@
 #include "net/gnrc/ipv6/hdr.h"
 #include "net/gnrc/sixlowpan.h"
 #include "net/gnrc/sixlowpan/frag.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_SFR
+#include "net/gnrc/sixlowpan/frag/sfr.h"
+#endif
 #include "net/gnrc/sixlowpan/iphc.h"
 #include "net/gnrc/netif.h"
 #include "net/sixlowpan.h"
@@ -38,7 +41,17 @@ static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 static gnrc_sixlowpan_msg_frag_t fragment_msg = {KERNEL_PID_UNDEF, NULL, 0, 0};
 #endif
 
-#if ENABLE_DEBUG
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+
+static gnrc_single_thread_layer_t _layer;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_SFR
+#define MSG_TYPE_LAST   (GNRC_SIXLOWPAN_MSG_SFR_GC)
+#else
+#define MSG_TYPE_LAST   (GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF)
+#endif
+#elif ENABLE_DEBUG
 static char _stack[GNRC_SIXLOWPAN_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_SIXLOWPAN_STACK_SIZE];
@@ -49,8 +62,12 @@ static char _stack[GNRC_SIXLOWPAN_STACK_SIZE];
 static void _receive(gnrc_pktsnip_t *pkt);
 /* handles GNRC_NETAPI_MSG_TYPE_SND commands */
 static void _send(gnrc_pktsnip_t *pkt);
+/* handles a message to 6LoWPAN */
+static void _handle_msg(msg_t *msg);
+#ifndef MODULE_GNRC_SINGLE_THREAD
 /* Main event loop for 6LoWPAN */
 static void *_event_loop(void *args);
+#endif
 
 kernel_pid_t gnrc_sixlowpan_init(void)
 {
@@ -58,8 +75,13 @@ kernel_pid_t gnrc_sixlowpan_init(void)
         return _pid;
     }
 
+#ifdef MODULE_GNRC_SINGLE_THREAD
+    _pid = gnrc_single_thread_add(&_layer, GNRC_NETTYPE_SIXLOWPAN, _handle_msg,
+                                  GNRC_SIXLOWPAN_MSG_FRAG_SND, MSG_TYPE_LAST);
+#else
     _pid = thread_create(_stack, sizeof(_stack), GNRC_SIXLOWPAN_PRIO,
                          THREAD_CREATE_STACKTEST, _event_loop, NULL, "6lo");
+#endif
 
     return _pid;
 }
@@ -161,6 +183,13 @@ static void _receive(gnrc_pktsnip_t *pkt)
         pkt = gnrc_pktbuf_remove_snip(pkt, sixlowpan);
         payload->type = GNRC_NETTYPE_IPV6;
     }
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_SFR
+    else if (sixlowpan_sfr_is((sixlowpan_sfr_t *)dispatch)) {
+        DEBUG("6lo: received 6LoWPAN recoverable fragment\n");
+        gnrc_sixlowpan_frag_sfr_handle_pkt(pkt);
+        return;
+    }
+#endif
 #ifdef MODULE_GNRC_SIXLOWPAN_FRAG
     else if (sixlowpan_frag_is((sixlowpan_frag_t *)dispatch)) {
         DEBUG("6lo: received 6LoWPAN fragment\n");
@@ -305,6 +334,23 @@ static void _send(gnrc_pktsnip_t *pkt)
         return;
     }
 #ifdef MODULE_GNRC_SIXLOWPAN_FRAG
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_SFR
+    /* multicast is not acknowledged, so it is fragmented the classic way */
+    else if ((hdr->dst_l2addr_len > 0) &&
+             !(hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                             GNRC_NETIF_HDR_FLAGS_MULTICAST))) {
+        int res;
+
+        DEBUG("6lo: Send recoverable fragments (%u > %" PRIu8 ")\n",
+              (unsigned int)gnrc_pkt_len(pkt2->next),
+              iface->sixlo.max_frag_size);
+        if ((res = gnrc_sixlowpan_frag_sfr_send(pkt2, iface)) < 0) {
+            DEBUG("6lo: unable to send recoverable fragments (%d)\n", res);
+            gnrc_pktbuf_release(pkt2);
+        }
+        return;
+    }
+#endif
     else if (fragment_msg.pkt != NULL) {
         DEBUG("6lo: Fragmentation already ongoing. Dropping packet\n");
         gnrc_pktbuf_release(pkt2);
@@ -340,9 +386,59 @@ static void _send(gnrc_pktsnip_t *pkt)
 #endif
 }
 
+static void _handle_msg(msg_t *msg)
+{
+    msg_t reply;
+
+    switch (msg->type) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_RCV received\n");
+            _receive(msg->content.ptr);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_SND received\n");
+            _send(msg->content.ptr);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_GET:
+        case GNRC_NETAPI_MSG_TYPE_SET:
+            DEBUG("6lo: reply to unsupported get/set\n");
+            reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+            reply.content.value = -ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
+        case GNRC_SIXLOWPAN_MSG_FRAG_SND:
+            DEBUG("6lo: send fragmented event received\n");
+            gnrc_sixlowpan_frag_send(msg->content.ptr);
+            break;
+        case GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF:
+            DEBUG("6lo: garbage collect reassembly buffer event received\n");
+            gnrc_sixlowpan_frag_gc_rbuf();
+            break;
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_SFR
+        case GNRC_SIXLOWPAN_MSG_SFR_ARQ_TIMEOUT:
+            DEBUG("6lo: acknowledgment timeout event received\n");
+            gnrc_sixlowpan_frag_sfr_arq_timeout(msg->content.ptr);
+            break;
+        case GNRC_SIXLOWPAN_MSG_SFR_GC:
+            DEBUG("6lo: garbage collect recoverable reassemblies event received\n");
+            gnrc_sixlowpan_frag_sfr_gc();
+            break;
+#endif
+
+        default:
+            DEBUG("6lo: operation not supported\n");
+            break;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *args)
 {
-    msg_t msg, reply, msg_q[GNRC_SIXLOWPAN_MSG_QUEUE_SIZE];
+    msg_t msg, msg_q[GNRC_SIXLOWPAN_MSG_QUEUE_SIZE];
     gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
 
@@ -352,49 +448,15 @@ static void *_event_loop(void *args)
     /* register interest in all 6LoWPAN packets */
     gnrc_netreg_register(GNRC_NETTYPE_SIXLOWPAN, &me_reg);
 
-    /* preinitialize ACK */
-    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
-
     /* start event loop */
     while (1) {
         DEBUG("6lo: waiting for incoming message.\n");
         msg_receive(&msg);
-
-        switch (msg.type) {
-            case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_RCV received\n");
-                _receive(msg.content.ptr);
-                break;
-
-            case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_SND received\n");
-                _send(msg.content.ptr);
-                break;
-
-            case GNRC_NETAPI_MSG_TYPE_GET:
-            case GNRC_NETAPI_MSG_TYPE_SET:
-                DEBUG("6lo: reply to unsupported get/set\n");
-                reply.content.value = -ENOTSUP;
-                msg_reply(&msg, &reply);
-                break;
-#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
-            case GNRC_SIXLOWPAN_MSG_FRAG_SND:
-                DEBUG("6lo: send fragmented event received\n");
-                gnrc_sixlowpan_frag_send(msg.content.ptr);
-                break;
-            case GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF:
-                DEBUG("6lo: garbage collect reassembly buffer event received\n");
-                gnrc_sixlowpan_frag_gc_rbuf();
-                break;
-#endif
-
-            default:
-                DEBUG("6lo: operation not supported\n");
-                break;
-        }
+        _handle_msg(&msg);
     }
 
     return NULL;
 }
+#endif
 
 /** @} */
@@ -23,6 +23,9 @@
 #include "net/ipv6/hdr.h"
 #include "net/gnrc.h"
 #include "net/gnrc/sixlowpan/ctx.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_FLOW
+#include "net/gnrc/netif.h"
+#endif
 #include "net/sixlowpan.h"
 #include "utlist.h"
 #include "net/gnrc/nettype.h"
@@ -583,66 +586,48 @@ static inline bool _compressible(gnrc_pktsnip_t *hdr)
     }
 }
 
-bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+/* compressed source and destination address of a datagram */
+typedef struct {
+    uint16_t ctxs;      /* contexts used, bit n for context ID n */
+    uint8_t iphc2;      /* second IPHC byte, all its fields refer to addresses */
+    uint8_t cid;        /* context identifier extension */
+    uint8_t addrs_len;  /* number of bytes in addrs */
+    uint8_t addrs[2 * sizeof(ipv6_addr_t)];    /* addresses carried inline */
+} _iphc_addrs_t;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_FLOW
+/* link-layer addresses longer than that can not be used to derive IIDs */
+#define FLOW_L2ADDR_MAX_LEN         (8U)
+
+/* addresses of a flow and their compression */
+typedef struct {
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    uint32_t ctx_version;   /* context buffer version of flow::addrs */
+    uint8_t src_l2[FLOW_L2ADDR_MAX_LEN];
+    uint8_t dst_l2[FLOW_L2ADDR_MAX_LEN];
+    kernel_pid_t if_pid;    /* KERNEL_PID_UNDEF if unused */
+    uint8_t src_l2_len;
+    uint8_t dst_l2_len;
+    _iphc_addrs_t addrs;
+} _iphc_flow_t;
+
+static _iphc_flow_t _flows[GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF];
+static unsigned _flows_next;
+#endif
+
+/* compresses the addresses of ipv6_hdr the way gnrc_sixlowpan_iphc_encode()
+ * would */
+static void _iphc_encode_addrs(gnrc_netif_hdr_t *netif_hdr,
+                               ipv6_hdr_t *ipv6_hdr, _iphc_addrs_t *res)
 {
-    gnrc_netif_hdr_t *netif_hdr = pkt->data;
-    ipv6_hdr_t *ipv6_hdr;
-    uint8_t *iphc_hdr;
-    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
     bool addr_comp = false;
     gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch, *ptr = pkt->next;
-    size_t dispatch_size = 0;
+    uint8_t *inline_addrs = res->addrs;
 
-    dispatch = NULL;    /* use dispatch as temporary pointer for prev */
-    /* determine maximum dispatch size and write protect all headers until
-     * then because they will be removed */
-    while (_compressible(ptr)) {
-        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
-
-        if (tmp == NULL) {
-            DEBUG("6lo iphc: unable to write protect compressible header\n");
-            if (addr_comp) {    /* addr_comp was used as release indicator */
-                gnrc_pktbuf_release(pkt);
-            }
-            return false;
-        }
-        ptr = tmp;
-        if (dispatch == NULL) {
-            /* pkt was already write protected in gnrc_sixlowpan.c:_send so
-             * we shouldn't do it again */
-            pkt->next = ptr;    /* reset original packet */
-        }
-        else {
-            dispatch->next = ptr;
-        }
-        if (ptr->type == GNRC_NETTYPE_UNDEF) {
-            /* most likely UDP for now so use that (XXX: extend if extension
-             * headers make problems) */
-            dispatch_size += sizeof(udp_hdr_t);
-            break;  /* nothing special after UDP so quit even if more UNDEF
-                     * come */
-        }
-        else {
-            dispatch_size += ptr->size;
-        }
-        dispatch = ptr; /* use dispatch as temporary point for prev */
-        ptr = ptr->next;
-    }
-    ipv6_hdr = pkt->next->data;
-    dispatch = gnrc_pktbuf_add(NULL, NULL, dispatch_size,
-                               GNRC_NETTYPE_SIXLOWPAN);
-
-    if (dispatch == NULL) {
-        DEBUG("6lo iphc: error allocating dispatch space\n");
-        return false;
-    }
-
-    iphc_hdr = dispatch->data;
-
-    /* set initial dispatch value*/
-    iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
-    iphc_hdr[IPHC2_IDX] = 0;
+    res->ctxs = 0;
+    res->iphc2 = 0;
+    res->cid = 0;
 
     /* check for available contexts */
     if (!ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
@@ -663,95 +648,15 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
         }
     }
 
-    /* if contexts available and both != 0 */
-    /* since this moves inline_pos we have to do this ahead*/
-    if (((src_ctx != NULL) &&
-            ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) ||
-        ((dst_ctx != NULL) &&
-            ((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0))) {
-        /* add context identifier extension */
-        iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_CID_EXT;
-        iphc_hdr[CID_EXT_IDX] = 0;
-
-        /* move position to behind CID extension */
-        inline_pos += SIXLOWPAN_IPHC_CID_EXT_LEN;
-    }
-
-    /* compress flow label and traffic class */
-    if (ipv6_hdr_get_fl(ipv6_hdr) == 0) {
-        if (ipv6_hdr_get_tc(ipv6_hdr) == 0) {
-            /* elide both traffic class and flow label */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_ELIDE;
-        }
-        else {
-            /* elide flow label, traffic class (ECN + DSCP) inline (1 byte) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
-        }
-    }
-    else {
-        if (ipv6_hdr_get_tc_dscp(ipv6_hdr) == 0) {
-            /* elide DSCP, ECN + 2-bit pad + flow label inline (3 byte) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_FL;
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_tc_ecn(ipv6_hdr) << 6) |
-                                               ((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16));
-        }
-        else {
-            /* ECN + DSCP + 4-bit pad + flow label (4 bytes) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP_FL;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16);
-        }
-
-        /* copy remaining byteos of flow label */
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x0000ff00) >> 8);
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000000ff) >> 8);
-    }
-
-    /* check for compressible next header */
-    switch (ipv6_hdr->nh) {
-#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-        case PROTNUM_UDP:
-            iphc_hdr[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
-            break;
-#endif
-
-        default:
-            iphc_hdr[inline_pos++] = ipv6_hdr->nh;
-            break;
-    }
-
-    /* compress hop limit */
-    switch (ipv6_hdr->hl) {
-        case 1:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_1;
-            break;
-
-        case 64:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_64;
-            break;
-
-        case 255:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_255;
-            break;
-
-        default:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_INLINE;
-            iphc_hdr[inline_pos++] = ipv6_hdr->hl;
-            break;
-    }
-
     if (ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_UNSPEC;
+        res->iphc2 |= IPHC_SAC_SAM_UNSPEC;
     }
     else {
         if (src_ctx != NULL) {
             /* stateful source address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_SAC;
-
-            if (((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4);
-            }
+            res->iphc2 |= SIXLOWPAN_IPHC2_SAC;
+            res->cid |= ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4);
+            res->ctxs |= (1U << (src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
         }
 
         if ((src_ctx != NULL) || ipv6_addr_is_link_local(&(ipv6_hdr->src))) {
@@ -774,31 +679,31 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
             if ((ipv6_hdr->src.u64[1].u64 == iid.uint64.u64) ||
                 _context_overlaps_iid(src_ctx, &ipv6_hdr->src, &iid)) {
                 /* 0 bits. The address is derived from link-layer address */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_L2;
+                res->iphc2 |= IPHC_SAC_SAM_L2;
                 addr_comp = true;
             }
             else if ((byteorder_ntohl(ipv6_hdr->src.u32[2]) == 0x000000ff) &&
                      (byteorder_ntohs(ipv6_hdr->src.u16[6]) == 0xfe00)) {
                 /* 16 bits. The address is derived using 16 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_16;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u16 + 7, 2);
-                inline_pos += 2;
+                res->iphc2 |= IPHC_SAC_SAM_16;
+                memcpy(inline_addrs, ipv6_hdr->src.u16 + 7, 2);
+                inline_addrs += 2;
                 addr_comp = true;
             }
             else {
                 /* 64 bits. The address is derived using 64 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_64;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u64 + 1, 8);
-                inline_pos += 8;
+                res->iphc2 |= IPHC_SAC_SAM_64;
+                memcpy(inline_addrs, ipv6_hdr->src.u64 + 1, 8);
+                inline_addrs += 8;
                 addr_comp = true;
             }
         }
 
         if (!addr_comp) {
             /* full address is carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-            memcpy(iphc_hdr + inline_pos, &ipv6_hdr->src, 16);
-            inline_pos += 16;
+            res->iphc2 |= IPHC_SAC_SAM_FULL;
+            memcpy(inline_addrs, &ipv6_hdr->src, 16);
+            inline_addrs += 16;
         }
     }
 
@@ -806,7 +711,7 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
 
     /* M: Multicast compression */
     if (ipv6_addr_is_multicast(&(ipv6_hdr->dst))) {
-        iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_M;
+        res->iphc2 |= SIXLOWPAN_IPHC2_M;
 
         /* if multicast address is of format ffXX::XXXX:XXXX:XXXX */
         if ((ipv6_hdr->dst.u16[1].u16 == 0) &&
@@ -818,34 +723,34 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
                 (ipv6_hdr->dst.u16[6].u16 == 0) &&
                 (ipv6_hdr->dst.u8[14] == 0)) {
                 /* 8 bits. The address is derived using 8 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_8;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[15];
+                res->iphc2 |= IPHC_M_DAC_DAM_M_8;
+                *(inline_addrs++) = ipv6_hdr->dst.u8[15];
                 addr_comp = true;
             }
             /* if multicast address is of format ffXX::XX:XXXX */
             else if ((ipv6_hdr->dst.u16[5].u16 == 0) &&
                      (ipv6_hdr->dst.u8[12] == 0)) {
                 /* 32 bits. The address is derived using 32 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_32;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 13, 3);
-                inline_pos += 3;
+                res->iphc2 |= IPHC_M_DAC_DAM_M_32;
+                *(inline_addrs++) = ipv6_hdr->dst.u8[1];
+                memcpy(inline_addrs, ipv6_hdr->dst.u8 + 13, 3);
+                inline_addrs += 3;
                 addr_comp = true;
             }
             /* if multicast address is of format ffXX::XX:XXXX:XXXX */
             else if (ipv6_hdr->dst.u8[10] == 0) {
                 /* 48 bits. The address is derived using 48 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_48;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 11, 5);
-                inline_pos += 5;
+                res->iphc2 |= IPHC_M_DAC_DAM_M_48;
+                *(inline_addrs++) = ipv6_hdr->dst.u8[1];
+                memcpy(inline_addrs, ipv6_hdr->dst.u8 + 11, 5);
+                inline_addrs += 5;
                 addr_comp = true;
             }
         }
         /* try unicast prefix based compression */
         else {
             gnrc_sixlowpan_ctx_t *ctx;
-            ipv6_addr_t unicast_prefix;
+            ipv6_addr_t unicast_prefix = IPV6_ADDR_UNSPECIFIED;
             unicast_prefix.u16[0] = ipv6_hdr->dst.u16[2];
             unicast_prefix.u16[1] = ipv6_hdr->dst.u16[3];
             unicast_prefix.u16[2] = ipv6_hdr->dst.u16[4];
@@ -858,14 +763,13 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
                 /* Unicast prefix based IPv6 multicast address
                  * (https://tools.ietf.org/html/rfc3306) with given context
                  * for unicast prefix -> context based compression */
-                iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
-                if ((ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) {
-                    iphc_hdr[CID_EXT_IDX] |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-                }
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[2];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u16 + 6, 4);
-                inline_pos += 4;
+                res->iphc2 |= SIXLOWPAN_IPHC2_DAC;
+                res->cid |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+                res->ctxs |= (1U << (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
+                *(inline_addrs++) = ipv6_hdr->dst.u8[1];
+                *(inline_addrs++) = ipv6_hdr->dst.u8[2];
+                memcpy(inline_addrs, ipv6_hdr->dst.u16 + 6, 4);
+                inline_addrs += 4;
                 addr_comp = true;
             }
         }
@@ -876,11 +780,9 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
 
         if (dst_ctx != NULL) {
             /* stateful destination address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
-
-            if (((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-            }
+            res->iphc2 |= SIXLOWPAN_IPHC2_DAC;
+            res->cid |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+            res->ctxs |= (1U << (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
         }
 
         ieee802154_get_iid(&iid, gnrc_netif_hdr_get_dst_addr(netif_hdr),
@@ -889,32 +791,274 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
         if ((ipv6_hdr->dst.u64[1].u64 == iid.uint64.u64) ||
             _context_overlaps_iid(dst_ctx, &(ipv6_hdr->dst), &iid)) {
             /* 0 bits. The address is derived using the link-layer address */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_L2;
+            res->iphc2 |= IPHC_M_DAC_DAM_U_L2;
             addr_comp = true;
         }
         else if ((byteorder_ntohl(ipv6_hdr->dst.u32[2]) == 0x000000ff) &&
                  (byteorder_ntohs(ipv6_hdr->dst.u16[6]) == 0xfe00)) {
             /* 16 bits. The address is derived using 16 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_16;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u16[7]), 2);
-            inline_pos += 2;
+            res->iphc2 |= IPHC_M_DAC_DAM_U_16;
+            memcpy(inline_addrs, &(ipv6_hdr->dst.u16[7]), 2);
+            inline_addrs += 2;
             addr_comp = true;
         }
         else {
             /* 64 bits. The address is derived using 64 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_64;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u8[8]), 8);
-            inline_pos += 8;
+            res->iphc2 |= IPHC_M_DAC_DAM_U_64;
+            memcpy(inline_addrs, &(ipv6_hdr->dst.u8[8]), 8);
+            inline_addrs += 8;
             addr_comp = true;
         }
     }
 
     if (!addr_comp) {
         /* full destination address is carried inline */
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-        memcpy(iphc_hdr + inline_pos, &ipv6_hdr->dst, 16);
-        inline_pos += 16;
+        res->iphc2 |= IPHC_SAC_SAM_FULL;
+        memcpy(inline_addrs, &ipv6_hdr->dst, 16);
+        inline_addrs += 16;
+    }
+
+    /* context identifier extension is only needed for context IDs != 0 */
+    if (res->cid != 0) {
+        res->iphc2 |= SIXLOWPAN_IPHC2_CID_EXT;
+    }
+    res->addrs_len = (uint8_t)(inline_addrs - res->addrs);
+}
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_FLOW
+/* gets the link-layer address the source IID is derived from */
+static const uint8_t *_flow_src_l2addr(gnrc_netif_hdr_t *netif_hdr,
+                                       size_t *len)
+{
+    if ((netif_hdr->src_l2addr_len == 2) ||
+        (netif_hdr->src_l2addr_len == 4) ||
+        (netif_hdr->src_l2addr_len == 8)) {
+        *len = netif_hdr->src_l2addr_len;
+        return gnrc_netif_hdr_get_src_addr(netif_hdr);
+    }
+#if GNRC_NETIF_L2ADDR_MAXLEN > 0
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(netif_hdr->if_pid);
+
+    if ((netif != NULL) && (netif->l2addr_len <= FLOW_L2ADDR_MAX_LEN)) {
+        *len = netif->l2addr_len;
+        return netif->l2addr;
+    }
+#endif
+    return NULL;
+}
+
+static bool _flow_valid(const _iphc_flow_t *flow)
+{
+    if (flow->ctx_version != gnrc_sixlowpan_ctx_version()) {
+        return false;
     }
+    /* contexts may have expired or have been removed since */
+    for (unsigned id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+        if (flow->addrs.ctxs & (1U << id)) {
+            gnrc_sixlowpan_ctx_t *ctx = gnrc_sixlowpan_ctx_lookup_id(id);
+
+            if ((ctx == NULL) ||
+                !(ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+/* gets the compressed addresses of ipv6_hdr, either from a known flow or by
+ * compressing them into buf */
+static const _iphc_addrs_t *_iphc_get_addrs(gnrc_netif_hdr_t *netif_hdr,
+                                            ipv6_hdr_t *ipv6_hdr,
+                                            _iphc_addrs_t *buf)
+{
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_FLOW
+    _iphc_flow_t *flow = NULL;
+    const uint8_t *src_l2;
+    size_t src_l2_len;
+
+    src_l2 = _flow_src_l2addr(netif_hdr, &src_l2_len);
+    if ((src_l2 == NULL) || (netif_hdr->dst_l2addr_len > FLOW_L2ADDR_MAX_LEN)) {
+        _iphc_encode_addrs(netif_hdr, ipv6_hdr, buf);
+        return buf;
+    }
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF; i++) {
+        flow = &_flows[i];
+        if ((flow->if_pid == netif_hdr->if_pid) &&
+            ipv6_addr_equal(&flow->dst, &ipv6_hdr->dst) &&
+            ipv6_addr_equal(&flow->src, &ipv6_hdr->src) &&
+            (flow->dst_l2_len == netif_hdr->dst_l2addr_len) &&
+            (flow->src_l2_len == src_l2_len) &&
+            (memcmp(flow->dst_l2, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                    flow->dst_l2_len) == 0) &&
+            (memcmp(flow->src_l2, src_l2, src_l2_len) == 0)) {
+            if (_flow_valid(flow)) {
+                DEBUG("6lo iphc: using compression of flow %u\n", i);
+                return &flow->addrs;
+            }
+            break;
+        }
+        flow = NULL;
+    }
+    if (flow == NULL) {
+        flow = &_flows[_flows_next];
+        _flows_next = (_flows_next + 1) % GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF;
+        flow->if_pid = netif_hdr->if_pid;
+        flow->src = ipv6_hdr->src;
+        flow->dst = ipv6_hdr->dst;
+        flow->src_l2_len = src_l2_len;
+        flow->dst_l2_len = netif_hdr->dst_l2addr_len;
+        memcpy(flow->src_l2, src_l2, src_l2_len);
+        memcpy(flow->dst_l2, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+               flow->dst_l2_len);
+    }
+    flow->ctx_version = gnrc_sixlowpan_ctx_version();
+    _iphc_encode_addrs(netif_hdr, ipv6_hdr, &flow->addrs);
+    return &flow->addrs;
+#else
+    _iphc_encode_addrs(netif_hdr, ipv6_hdr, buf);
+    return buf;
+#endif
+}
+
+bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    ipv6_hdr_t *ipv6_hdr;
+    uint8_t *iphc_hdr;
+    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
+    bool addr_comp = false;
+    _iphc_addrs_t addrs_buf;
+    const _iphc_addrs_t *addrs;
+    gnrc_pktsnip_t *dispatch, *ptr = pkt->next;
+    size_t dispatch_size = 0;
+
+    dispatch = NULL;    /* use dispatch as temporary pointer for prev */
+    /* determine maximum dispatch size and write protect all headers until
+     * then because they will be removed */
+    while (_compressible(ptr)) {
+        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
+
+        if (tmp == NULL) {
+            DEBUG("6lo iphc: unable to write protect compressible header\n");
+            if (addr_comp) {    /* addr_comp was used as release indicator */
+                gnrc_pktbuf_release(pkt);
+            }
+            return false;
+        }
+        ptr = tmp;
+        if (dispatch == NULL) {
+            /* pkt was already write protected in gnrc_sixlowpan.c:_send so
+             * we shouldn't do it again */
+            pkt->next = ptr;    /* reset original packet */
+        }
+        else {
+            dispatch->next = ptr;
+        }
+        if (ptr->type == GNRC_NETTYPE_UNDEF) {
+            /* most likely UDP for now so use that (XXX: extend if extension
+             * headers make problems) */
+            dispatch_size += sizeof(udp_hdr_t);
+            break;  /* nothing special after UDP so quit even if more UNDEF
+                     * come */
+        }
+        else {
+            dispatch_size += ptr->size;
+        }
+        dispatch = ptr; /* use dispatch as temporary point for prev */
+        ptr = ptr->next;
+    }
+    ipv6_hdr = pkt->next->data;
+    dispatch = gnrc_pktbuf_add(NULL, NULL, dispatch_size,
+                               GNRC_NETTYPE_SIXLOWPAN);
+
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        return false;
+    }
+
+    iphc_hdr = dispatch->data;
+
+    /* set initial dispatch value*/
+    iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
+
+    /* the addresses are compressed ahead as the context identifier extension
+     * moves inline_pos */
+    addrs = _iphc_get_addrs(netif_hdr, ipv6_hdr, &addrs_buf);
+    iphc_hdr[IPHC2_IDX] = addrs->iphc2;
+    if (addrs->iphc2 & SIXLOWPAN_IPHC2_CID_EXT) {
+        iphc_hdr[CID_EXT_IDX] = addrs->cid;
+        /* move position to behind CID extension */
+        inline_pos += SIXLOWPAN_IPHC_CID_EXT_LEN;
+    }
+
+    /* compress flow label and traffic class */
+    if (ipv6_hdr_get_fl(ipv6_hdr) == 0) {
+        if (ipv6_hdr_get_tc(ipv6_hdr) == 0) {
+            /* elide both traffic class and flow label */
+            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_ELIDE;
+        }
+        else {
+            /* elide flow label, traffic class (ECN + DSCP) inline (1 byte) */
+            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP;
+            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
+        }
+    }
+    else {
+        if (ipv6_hdr_get_tc_dscp(ipv6_hdr) == 0) {
+            /* elide DSCP, ECN + 2-bit pad + flow label inline (3 byte) */
+            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_FL;
+            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_tc_ecn(ipv6_hdr) << 6) |
+                                               ((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16));
+        }
+        else {
+            /* ECN + DSCP + 4-bit pad + flow label (4 bytes) */
+            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP_FL;
+            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
+            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16);
+        }
+
+        /* copy remaining byteos of flow label */
+        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x0000ff00) >> 8);
+        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000000ff) >> 8);
+    }
+
+    /* check for compressible next header */
+    switch (ipv6_hdr->nh) {
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+        case PROTNUM_UDP:
+            iphc_hdr[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
+            break;
+#endif
+
+        default:
+            iphc_hdr[inline_pos++] = ipv6_hdr->nh;
+            break;
+    }
+
+    /* compress hop limit */
+    switch (ipv6_hdr->hl) {
+        case 1:
+            iphc_hdr[IPHC1_IDX] |= IPHC_HL_1;
+            break;
+
+        case 64:
+            iphc_hdr[IPHC1_IDX] |= IPHC_HL_64;
+            break;
+
+        case 255:
+            iphc_hdr[IPHC1_IDX] |= IPHC_HL_255;
+            break;
+
+        default:
+            iphc_hdr[IPHC1_IDX] |= IPHC_HL_INLINE;
+            iphc_hdr[inline_pos++] = ipv6_hdr->hl;
+            break;
+    }
+
+    memcpy(iphc_hdr + inline_pos, addrs->addrs, addrs->addrs_len);
+    inline_pos += addrs->addrs_len;
 
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
     switch (ipv6_hdr->nh) {
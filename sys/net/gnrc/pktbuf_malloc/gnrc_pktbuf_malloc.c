@@ -74,6 +74,9 @@ static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
 #ifdef MODULE_GNRC_NETERR
     pkt->err_sub = KERNEL_PID_UNDEF;
 #endif
+#ifdef MODULE_GNRC_PKTTRACE
+    pkt->trace.valid = false;
+#endif
 }
 
 void gnrc_pktbuf_init(void)
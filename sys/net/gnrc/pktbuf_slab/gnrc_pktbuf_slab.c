@@ -0,0 +1,710 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_pktbuf
+ * @{
+ *
+ * @file
+ * @brief   Packet buffer with segregated size classes
+ *
+ * Packet snip descriptors and small headers are served in O(1) from pools of
+ * fixed-size blocks, so they do not cut holes into the memory used for
+ * payloads. Payloads are allocated best-fit from an address-ordered free list
+ * that is coalesced on every free.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "kernel_defines.h"
+#include "mutex.h"
+#include "utlist.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define _ALIGNMENT_MASK    (sizeof(_unused_t) - 1)
+#define _ALIGN(size)       (((size) + _ALIGNMENT_MASK) & ~(_ALIGNMENT_MASK))
+
+#define _SNIP_BLOCK        _ALIGN(sizeof(gnrc_pktsnip_t))
+#define _SMALL_BLOCK       _ALIGN(GNRC_PKTBUF_SLAB_SMALL_SIZE)
+#define _SMALL_OFFSET      (GNRC_PKTBUF_SLAB_SNIP_NUMOF * _SNIP_BLOCK)
+#define _ARENA_OFFSET      (_SMALL_OFFSET + \
+                            (GNRC_PKTBUF_SLAB_SMALL_NUMOF * _SMALL_BLOCK))
+#define _ARENA_SIZE        ((GNRC_PKTBUF_SIZE - _ARENA_OFFSET) & \
+                            ~(_ALIGNMENT_MASK))
+
+typedef struct _unused {
+    struct _unused *next;
+    unsigned int size;
+} _unused_t;
+
+typedef struct {
+    _unused_t *free;            /* free blocks, only next is used */
+    uint8_t *start;             /* first block of the pool */
+    uint16_t block_size;
+    uint16_t numof;
+#ifdef DEVELHELP
+    uint16_t used;
+    uint16_t max_used;
+    uint16_t overflows;         /* allocations that went to the arena */
+#endif
+} _class_t;
+
+enum {
+    _CLASS_SNIP = 0,
+    _CLASS_SMALL,
+    _CLASS_NUMOF,
+};
+
+static mutex_t _mutex = MUTEX_INIT;
+static uint8_t _pktbuf[GNRC_PKTBUF_SIZE] __attribute__((aligned(sizeof(_unused_t))));
+static _class_t _classes[_CLASS_NUMOF];
+static _unused_t *_first_unused;
+
+#ifdef DEVELHELP
+/* bytes currently and at most used in the arena */
+static unsigned _arena_used = 0;
+static unsigned _arena_max_used = 0;
+/* number of allocations that failed */
+static unsigned _fails = 0;
+#endif
+
+/* internal gnrc_pktbuf functions */
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                    gnrc_nettype_t type);
+static void *_snip_alloc(void);
+static void *_data_alloc(size_t size);
+static void _pktbuf_free(void *data, size_t size);
+
+static inline uint8_t *_arena(void)
+{
+    return &_pktbuf[_ARENA_OFFSET];
+}
+
+static inline bool _arena_contains(void *ptr)
+{
+    return (unsigned)((uint8_t *)ptr - _arena()) < _ARENA_SIZE;
+}
+
+static inline bool _pktbuf_contains(void *ptr)
+{
+    return (unsigned)((uint8_t *)ptr - _pktbuf) < (_ARENA_OFFSET + _ARENA_SIZE);
+}
+
+/* fits size to byte alignment */
+static inline size_t _align(size_t size)
+{
+    return _ALIGN(size);
+}
+
+/* returns the pool ptr was allocated from or NULL if it is not in a pool */
+static _class_t *_class_of(void *ptr)
+{
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        _class_t *c = &_classes[i];
+
+        if ((unsigned)((uint8_t *)ptr - c->start) <
+            ((unsigned)c->numof * c->block_size)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
+                                void *data, size_t size, gnrc_nettype_t type)
+{
+    pkt->next = next;
+    pkt->data = data;
+    pkt->size = size;
+    pkt->type = type;
+    pkt->users = 1;
+#ifdef MODULE_GNRC_NETERR
+    pkt->err_sub = KERNEL_PID_UNDEF;
+#endif
+#ifdef MODULE_GNRC_PKTTRACE
+    pkt->trace.valid = false;
+#endif
+}
+
+static void _class_init(_class_t *c, uint8_t *start, uint16_t block_size,
+                        uint16_t numof)
+{
+    c->free = NULL;
+    c->start = start;
+    c->block_size = block_size;
+    c->numof = numof;
+    /* push in reverse so blocks are handed out in address order */
+    for (unsigned i = numof; i > 0; i--) {
+        _unused_t *block = (_unused_t *)&start[(i - 1) * block_size];
+
+        block->next = c->free;
+        c->free = block;
+    }
+#ifdef DEVELHELP
+    c->used = 0;
+    c->max_used = 0;
+    c->overflows = 0;
+#endif
+}
+
+void gnrc_pktbuf_init(void)
+{
+    BUILD_BUG_ON(_ARENA_OFFSET + sizeof(_unused_t) > GNRC_PKTBUF_SIZE);
+    mutex_lock(&_mutex);
+    _class_init(&_classes[_CLASS_SNIP], &_pktbuf[0], _SNIP_BLOCK,
+                GNRC_PKTBUF_SLAB_SNIP_NUMOF);
+    _class_init(&_classes[_CLASS_SMALL], &_pktbuf[_SMALL_OFFSET], _SMALL_BLOCK,
+                GNRC_PKTBUF_SLAB_SMALL_NUMOF);
+    _first_unused = (_unused_t *)_arena();
+    _first_unused->next = NULL;
+    _first_unused->size = _ARENA_SIZE;
+#ifdef DEVELHELP
+    _arena_used = 0;
+    _arena_max_used = 0;
+    _fails = 0;
+#endif
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+
+    if (size > _ARENA_SIZE) {
+        DEBUG("pktbuf: size (%u) > arena size (%u)\n",
+              (unsigned)size, (unsigned)_ARENA_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(next, data, size, type);
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *marked_snip;
+    /* size required for chunk */
+    size_t required_new_size = _align(size);
+    void *new_data_marked;
+
+    mutex_lock(&_mutex);
+    if ((size == 0) || (pkt == NULL) || (size > pkt->size) || (pkt->data == NULL)) {
+        DEBUG("pktbuf: size == 0 (was %u) or pkt == NULL (was %p) or "
+              "size > pkt->size (was %u) or pkt->data == NULL (was %p)\n",
+              (unsigned)size, (void *)pkt, (pkt ? (unsigned)pkt->size : 0),
+              (pkt ? pkt->data : NULL));
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* create new snip descriptor for marked data */
+    marked_snip = _snip_alloc();
+    if (marked_snip == NULL) {
+        DEBUG("pktbuf: could not reallocate marked section.\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* blocks of a pool can not be split and marked data that would not fit
+     * an _unused_t marker could not be freed properly => move data around */
+    if ((pkt->size != size) &&
+        ((_class_of(pkt->data) != NULL) || (size < required_new_size))) {
+        void *new_data_rest;
+        new_data_marked = _data_alloc(size);
+        if (new_data_marked == NULL) {
+            DEBUG("pktbuf: could not reallocate marked section.\n");
+            _pktbuf_free(marked_snip, sizeof(gnrc_pktsnip_t));
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+        new_data_rest = _data_alloc(pkt->size - size);
+        if (new_data_rest == NULL) {
+            DEBUG("pktbuf: could not reallocate remaining section.\n");
+            _pktbuf_free(marked_snip, sizeof(gnrc_pktsnip_t));
+            _pktbuf_free(new_data_marked, size);
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+        memcpy(new_data_marked, pkt->data, size);
+        memcpy(new_data_rest, ((uint8_t *)pkt->data) + size, pkt->size - size);
+        _pktbuf_free(pkt->data, pkt->size);
+        marked_snip->data = new_data_marked;
+        pkt->data = new_data_rest;
+    }
+    else {
+        new_data_marked = pkt->data;
+        /* if (pkt->size - size) != 0 take remainder of data, otherwise set NULL */
+        pkt->data = (pkt->size != size) ? (((uint8_t *)pkt->data) + size) :
+                                          NULL;
+    }
+    pkt->size -= size;
+    _set_pktsnip(marked_snip, pkt->next, new_data_marked, size, type);
+    pkt->next = marked_snip;
+    mutex_unlock(&_mutex);
+    return marked_snip;
+}
+
+int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
+{
+    size_t aligned_size = _align(size);
+    _class_t *c;
+
+    mutex_lock(&_mutex);
+    assert(pkt != NULL);
+    assert(((pkt->size == 0) && (pkt->data == NULL)) ||
+           ((pkt->size > 0) && (pkt->data != NULL) && _pktbuf_contains(pkt->data)));
+    /* new size and old size are equal */
+    if (size == pkt->size) {
+        /* nothing to do */
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    c = (pkt->data != NULL) ? _class_of(pkt->data) : NULL;
+    /* new size is 0 and data pointer isn't already NULL */
+    if ((size == 0) && (pkt->data != NULL)) {
+        /* set data pointer to NULL */
+        _pktbuf_free(pkt->data, pkt->size);
+        pkt->data = NULL;
+    }
+    /* if new size is bigger than old size and does not fit the block */
+    else if ((size > pkt->size) && ((c == NULL) || (size > c->block_size))) {
+        void *new_data = _data_alloc(size);
+        if (new_data == NULL) {
+            DEBUG("pktbuf: error allocating new data section\n");
+            mutex_unlock(&_mutex);
+            return ENOMEM;
+        }
+        if (pkt->data != NULL) {            /* if old data exist */
+            memcpy(new_data, pkt->data, (pkt->size < size) ? pkt->size : size);
+        }
+        _pktbuf_free(pkt->data, pkt->size);
+        pkt->data = new_data;
+    }
+    /* blocks of a pool are kept as a whole, so only shrink in the arena */
+    else if ((c == NULL) && (_align(pkt->size) > aligned_size)) {
+        _pktbuf_free(((uint8_t *)pkt->data) + aligned_size,
+                     pkt->size - aligned_size);
+    }
+    pkt->size = size;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        pkt->users += num;
+        pkt = pkt->next;
+    }
+    mutex_unlock(&_mutex);
+}
+
+static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    while (pkt) {
+        gnrc_pktsnip_t *tmp;
+        assert(_pktbuf_contains(pkt));
+        assert(pkt->users > 0);
+        tmp = pkt->next;
+        if (pkt->users == 1) {
+            pkt->users = 0; /* not necessary but to be on the safe side */
+            _pktbuf_free(pkt->data, pkt->size);
+            _pktbuf_free(pkt, sizeof(gnrc_pktsnip_t));
+        }
+        else {
+            pkt->users--;
+        }
+        DEBUG("pktbuf: report status code %" PRIu32 "\n", err);
+        gnrc_neterr_report(pkt, err);
+        pkt = tmp;
+    }
+}
+
+void gnrc_pktbuf_release_error(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    mutex_lock(&_mutex);
+    _release_error_locked(pkt, err);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    if ((pkt == NULL) || (pkt->size == 0)) {
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->users > 1) {
+        gnrc_pktsnip_t *new;
+        new = _create_snip(pkt->next, pkt->data, pkt->size, pkt->type);
+        if (new != NULL) {
+            pkt->users--;
+        }
+        mutex_unlock(&_mutex);
+        return new;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+#ifdef DEVELHELP
+void gnrc_pktbuf_stats(void)
+{
+    static const char *names[] = { "snip", "small" };
+    unsigned free_bytes = 0, largest = 0, chunks = 0;
+
+    mutex_lock(&_mutex);
+    printf("packet buffer: first byte: %p, last byte: %p (size: %u)\n",
+           (void *)&_pktbuf[0], (void *)&_pktbuf[GNRC_PKTBUF_SIZE], GNRC_PKTBUF_SIZE);
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        _class_t *c = &_classes[i];
+
+        printf("  %-5s pool: %2u x %3u B (used: %2u, max: %2u, overflows: %u)\n",
+               names[i], (unsigned)c->numof, (unsigned)c->block_size,
+               (unsigned)c->used, (unsigned)c->max_used,
+               (unsigned)c->overflows);
+    }
+    for (_unused_t *ptr = _first_unused; ptr != NULL; ptr = ptr->next) {
+        free_bytes += ptr->size;
+        if (ptr->size > largest) {
+            largest = ptr->size;
+        }
+        chunks++;
+    }
+    printf("  arena: %u B (used: %u, max: %u)\n", (unsigned)_ARENA_SIZE,
+           (unsigned)_arena_used, (unsigned)_arena_max_used);
+    /* fragmentation: share of free memory not usable for the largest
+     * possible allocation */
+    printf("  free chunks: %u, largest: %u B, fragmentation: %u%%\n",
+           chunks, largest,
+           (free_bytes > 0) ? (100U - ((largest * 100U) / free_bytes)) : 0U);
+    printf("  failed allocations: %u\n", (unsigned)_fails);
+    mutex_unlock(&_mutex);
+}
+#endif
+
+#ifdef TEST_SUITES
+static unsigned _class_free_numof(const _class_t *c)
+{
+    unsigned numof = 0;
+
+    for (_unused_t *ptr = c->free; ptr != NULL; ptr = ptr->next) {
+        numof++;
+    }
+    return numof;
+}
+
+bool gnrc_pktbuf_is_empty(void)
+{
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        if (_class_free_numof(&_classes[i]) != _classes[i].numof) {
+            return false;
+        }
+    }
+    return (_first_unused == (_unused_t *)_arena()) &&
+           (_first_unused->size == _ARENA_SIZE);
+}
+
+bool gnrc_pktbuf_is_sane(void)
+{
+    _unused_t *ptr = _first_unused;
+
+    /* Invariants of this implementation:
+     *  - forall pools: free blocks lie on a block boundary of the pool and
+     *    there are at most numof of them
+     *  - forall ptr in _unused_t list: ptr is in the arena
+     *  - forall ptr in _unused_t list: ptr->size is aligned and > 0
+     *  - forall ptr in _unused_t list: ptr->next == NULL || ptr + ptr->size < ptr->next
+     *    (adjacent free chunks are always merged)
+     *  - forall ptr in _unused_t list: ptr + ptr->size <= end of arena
+     */
+    for (unsigned i = 0; i < _CLASS_NUMOF; i++) {
+        _class_t *c = &_classes[i];
+        unsigned numof = 0;
+
+        for (_unused_t *block = c->free; block != NULL; block = block->next) {
+            unsigned offset = (uint8_t *)block - c->start;
+
+            if ((_class_of(block) != c) || ((offset % c->block_size) != 0) ||
+                (++numof > c->numof)) {
+                return false;
+            }
+        }
+    }
+    while (ptr) {
+        uint8_t *end = ((uint8_t *)ptr) + ptr->size;
+
+        if (!_arena_contains(ptr)) {
+            return false;
+        }
+        if ((ptr->size == 0) || ((ptr->size & _ALIGNMENT_MASK) != 0)) {
+            return false;
+        }
+        if (end > (_arena() + _ARENA_SIZE)) {
+            return false;
+        }
+        if ((ptr->next != NULL) && (end >= (uint8_t *)ptr->next)) {
+            return false;
+        }
+        ptr = ptr->next;
+    }
+
+    return true;
+}
+#endif
+
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, const void *data, size_t size,
+                                    gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = _snip_alloc();
+    void *_data = NULL;
+
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        return NULL;
+    }
+    if (size > 0) {
+        _data = _data_alloc(size);
+        if (_data == NULL) {
+            DEBUG("pktbuf: error allocating data for new packet snip\n");
+            _pktbuf_free(pkt, sizeof(gnrc_pktsnip_t));
+            return NULL;
+        }
+    }
+    _set_pktsnip(pkt, next, _data, size, type);
+    if (data != NULL) {
+        memcpy(_data, data, size);
+    }
+    return pkt;
+}
+
+static void *_class_alloc(_class_t *c)
+{
+    _unused_t *block = c->free;
+
+    if (block != NULL) {
+        c->free = block->next;
+#ifdef DEVELHELP
+        if (++c->used > c->max_used) {
+            c->max_used = c->used;
+        }
+#endif
+    }
+    return block;
+}
+
+static void _class_free(_class_t *c, void *data)
+{
+    _unused_t *block = (_unused_t *)(c->start +
+                                     ((((uint8_t *)data) - c->start) /
+                                      c->block_size) * c->block_size);
+
+    block->next = c->free;
+    c->free = block;
+#ifdef DEVELHELP
+    c->used--;
+#endif
+}
+
+static void *_arena_alloc(size_t size)
+{
+    _unused_t *prev = NULL, *ptr = _first_unused;
+    _unused_t *best_prev = NULL, *best = NULL;
+
+    size = _align(size);
+    /* best fit: find the smallest chunk that fits, stop on an exact fit */
+    while (ptr) {
+        if ((ptr->size >= size) &&
+            ((best == NULL) || (ptr->size < best->size))) {
+            best_prev = prev;
+            best = ptr;
+            if (ptr->size == size) {
+                break;
+            }
+        }
+        prev = ptr;
+        ptr = ptr->next;
+    }
+    if (best == NULL) {
+        DEBUG("pktbuf: no space left in packet buffer\n");
+        return NULL;
+    }
+    /* all chunk sizes are aligned, so a remainder always fits an _unused_t */
+    if (best->size == size) {
+        ptr = best->next;
+    }
+    else {
+        ptr = (_unused_t *)(((uint8_t *)best) + size);
+        ptr->next = best->next;
+        ptr->size = best->size - size;
+    }
+    if (best_prev == NULL) { /* best was _first_unused */
+        _first_unused = ptr;
+    }
+    else {
+        best_prev->next = ptr;
+    }
+#ifdef DEVELHELP
+    _arena_used += size;
+    if (_arena_used > _arena_max_used) {
+        _arena_max_used = _arena_used;
+    }
+#endif
+    return (void *)best;
+}
+
+static void _arena_free(void *data, size_t size)
+{
+    _unused_t *new = (_unused_t *)data, *prev = NULL, *ptr = _first_unused;
+
+    while (ptr && (((void *)ptr) < data)) {
+        prev = ptr;
+        ptr = ptr->next;
+    }
+    new->next = ptr;
+    new->size = _align(size);
+#ifdef DEVELHELP
+    _arena_used -= new->size;
+#endif
+    if ((ptr != NULL) && ((((uint8_t *)new) + new->size) == (uint8_t *)ptr)) {
+        new->next = ptr->next;
+        new->size += ptr->size;
+    }
+    if (prev == NULL) { /* data is before _first_unused */
+        _first_unused = new;
+    }
+    else if ((((uint8_t *)prev) + prev->size) == (uint8_t *)new) {
+        prev->next = new->next;
+        prev->size += new->size;
+    }
+    else {
+        prev->next = new;
+    }
+}
+
+static void *_snip_alloc(void)
+{
+    void *ptr = _class_alloc(&_classes[_CLASS_SNIP]);
+
+    if (ptr == NULL) {
+        DEBUG("pktbuf: snip pool exhausted, falling back to arena\n");
+#ifdef DEVELHELP
+        _classes[_CLASS_SNIP].overflows++;
+#endif
+        ptr = _arena_alloc(sizeof(gnrc_pktsnip_t));
+    }
+#ifdef DEVELHELP
+    if (ptr == NULL) {
+        _fails++;
+    }
+#endif
+    return ptr;
+}
+
+static void *_data_alloc(size_t size)
+{
+    void *ptr = NULL;
+
+    if (size <= GNRC_PKTBUF_SLAB_SMALL_SIZE) {
+        ptr = _class_alloc(&_classes[_CLASS_SMALL]);
+        if (ptr != NULL) {
+            return ptr;
+        }
+        DEBUG("pktbuf: small pool exhausted, falling back to arena\n");
+#ifdef DEVELHELP
+        _classes[_CLASS_SMALL].overflows++;
+#endif
+    }
+    ptr = _arena_alloc(size);
+#ifdef DEVELHELP
+    if (ptr == NULL) {
+        _fails++;
+    }
+#endif
+    return ptr;
+}
+
+static void _pktbuf_free(void *data, size_t size)
+{
+    _class_t *c;
+
+    if (!_pktbuf_contains(data)) {
+        return;
+    }
+    c = _class_of(data);
+    if (c != NULL) {
+        _class_free(c, data);
+    }
+    else {
+        _arena_free(data, size);
+    }
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_duplicate_upto(gnrc_pktsnip_t *pkt, gnrc_nettype_t type)
+{
+    mutex_lock(&_mutex);
+
+    bool is_shared = pkt->users > 1;
+    size_t size = gnrc_pkt_len_upto(pkt, type);
+
+    DEBUG("ipv6_ext: duplicating %d octets\n", (int) size);
+
+    gnrc_pktsnip_t *tmp;
+    gnrc_pktsnip_t *target = gnrc_pktsnip_search_type(pkt, type);
+    gnrc_pktsnip_t *next = (target == NULL) ? NULL : target->next;
+    gnrc_pktsnip_t *new = _create_snip(next, NULL, size, type);
+
+    if (new == NULL) {
+        mutex_unlock(&_mutex);
+
+        return NULL;
+    }
+
+    /* copy payloads */
+    for (tmp = pkt; tmp != NULL; tmp = tmp->next) {
+        uint8_t *dest = ((uint8_t *)new->data) + (size - tmp->size);
+
+        memcpy(dest, tmp->data, tmp->size);
+
+        size -= tmp->size;
+
+        if (tmp->type == type) {
+            break;
+        }
+    }
+
+    /* decrements reference counters */
+
+    if (target != NULL) {
+        target->next = NULL;
+    }
+
+    _release_error_locked(pkt, GNRC_NETERR_SUCCESS);
+
+    if (is_shared && (target != NULL)) {
+        target->next = next;
+    }
+
+    mutex_unlock(&_mutex);
+
+    return new;
+}
+
+/** @} */
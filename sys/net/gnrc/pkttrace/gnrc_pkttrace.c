@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bitarithm.h"
+#include "irq.h"
+#include "xtimer.h"
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/pkttrace.h"
+
+#define LAYER_FIRST     (GNRC_NETTYPE_IOVEC)
+#define LAYERS          (GNRC_NETTYPE_NUMOF - LAYER_FIRST)
+
+/* layers may share a thread or be spread over several ones */
+static gnrc_pkttrace_stats_t _stats[LAYERS];
+
+static inline bool _layer_is_valid(int layer)
+{
+    return (layer >= LAYER_FIRST) && (layer < GNRC_NETTYPE_NUMOF);
+}
+
+static const char *_name(int layer)
+{
+    switch (layer) {
+        case GNRC_NETTYPE_NETIF:
+            return "netif";
+#ifdef MODULE_GNRC_SIXLOWPAN
+        case GNRC_NETTYPE_SIXLOWPAN:
+            return "6lo";
+#endif
+#ifdef MODULE_GNRC_IPV6
+        case GNRC_NETTYPE_IPV6:
+            return "ipv6";
+#endif
+#ifdef MODULE_GNRC_ICMPV6
+        case GNRC_NETTYPE_ICMPV6:
+            return "icmpv6";
+#endif
+#ifdef MODULE_GNRC_TCP
+        case GNRC_NETTYPE_TCP:
+            return "tcp";
+#endif
+#ifdef MODULE_GNRC_UDP
+        case GNRC_NETTYPE_UDP:
+            return "udp";
+#endif
+#ifdef MODULE_CCN_LITE
+        case GNRC_NETTYPE_CCN:
+            return "ccn";
+#endif
+        default:
+            return "-";
+    }
+}
+
+static unsigned _bucket(uint32_t latency)
+{
+    unsigned bucket = (latency > 1) ? bitarithm_msb(latency) : 0;
+
+    return (bucket < GNRC_PKTTRACE_BUCKETS) ? bucket : GNRC_PKTTRACE_BUCKETS - 1;
+}
+
+static void _account(int layer, uint32_t latency)
+{
+    gnrc_pkttrace_stats_t *stats = &_stats[layer - LAYER_FIRST];
+    /* the threads of several layers may account concurrently */
+    unsigned state = irq_disable();
+
+    stats->count++;
+    stats->sum += latency;
+    if (latency > stats->max) {
+        stats->max = latency;
+    }
+    stats->hist[_bucket(latency)]++;
+    irq_restore(state);
+}
+
+void gnrc_pkttrace_start(gnrc_pktsnip_t *pkt, uint32_t time,
+                         gnrc_nettype_t layer)
+{
+    pkt->trace.time = time;
+    pkt->trace.layer = layer;
+    pkt->trace.valid = true;
+}
+
+void gnrc_pkttrace_stamp(gnrc_pktsnip_t *pkt, gnrc_nettype_t layer)
+{
+    uint32_t now = xtimer_now_usec();
+    bool found = false;
+
+    /* headers may have been removed or marked since the last stamp, so the
+     * stamp can be on any snip of the packet. The latest one is the first. */
+    for (gnrc_pktsnip_t *snip = pkt; snip != NULL; snip = snip->next) {
+        if (snip->trace.valid) {
+            if (!found && _layer_is_valid(snip->trace.layer)) {
+                _account(snip->trace.layer, now - snip->trace.time);
+            }
+            found = true;
+            /* other receivers of a shared snip still need its stamp */
+            if (snip->users == 1) {
+                snip->trace.valid = false;
+            }
+        }
+    }
+    if (pkt->users == 1) {
+        gnrc_pkttrace_start(pkt, now, layer);
+    }
+}
+
+const gnrc_pkttrace_stats_t *gnrc_pkttrace_get(gnrc_nettype_t layer)
+{
+    return _layer_is_valid(layer) ? &_stats[layer - LAYER_FIRST] : NULL;
+}
+
+void gnrc_pkttrace_reset(void)
+{
+    memset(_stats, 0, sizeof(_stats));
+}
+
+void gnrc_pkttrace_print(void)
+{
+    for (int layer = LAYER_FIRST; layer < GNRC_NETTYPE_NUMOF; layer++) {
+        const gnrc_pkttrace_stats_t *stats = &_stats[layer - LAYER_FIRST];
+
+        if (stats->count == 0) {
+            continue;
+        }
+        printf("%3d %-8s packets: %" PRIu32 ", avg: %" PRIu32
+               " us, max: %" PRIu32 " us\n", layer, _name(layer),
+               stats->count, stats->sum / stats->count, stats->max);
+        for (unsigned i = 0; i < GNRC_PKTTRACE_BUCKETS; i++) {
+            if (stats->hist[i] == 0) {
+                continue;
+            }
+            if (i == (GNRC_PKTTRACE_BUCKETS - 1)) {
+                printf("    >= %6lu us: %" PRIu32 "\n", 1LU << i, stats->hist[i]);
+            }
+            else {
+                printf("    < %7lu us: %" PRIu32 "\n", 2LU << i, stats->hist[i]);
+            }
+        }
+    }
+}
+
+/** @} */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+
+#include "irq.h"
+#include "thread_flags.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "net/gnrc/single_thread.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if ENABLE_DEBUG
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
+#else
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE];
+#endif
+
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static event_queue_t _queue;
+static gnrc_single_thread_layer_t *_layers = NULL;
+
+static void _handle(gnrc_single_thread_layer_t *layer, msg_t *msg)
+{
+    layer->busy = true;
+    layer->handler(msg);
+    layer->busy = false;
+}
+
+/* handles the commands queued for a layer */
+static void _drain(event_t *event)
+{
+    gnrc_single_thread_layer_t *layer = (gnrc_single_thread_layer_t *)event;
+
+    while (1) {
+        unsigned state = irq_disable();
+        int idx = cib_get(&layer->cib);
+        msg_t msg;
+
+        if (idx < 0) {
+            irq_restore(state);
+            break;
+        }
+        msg = layer->queue[idx];
+        irq_restore(state);
+        _handle(layer, &msg);
+    }
+}
+
+static void _cb(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    gnrc_single_thread_layer_t *layer = ctx;
+    msg_t msg = { .type = cmd, .content = { .ptr = pkt } };
+    unsigned state;
+    int idx;
+
+    if ((sched_active_pid == _pid) && !layer->busy &&
+        (cib_avail(&layer->cib) == 0)) {
+        /* keep the order of queued commands and don't re-enter a layer */
+        _handle(layer, &msg);
+        return;
+    }
+    state = irq_disable();
+    idx = cib_put(&layer->cib);
+    if (idx < 0) {
+        irq_restore(state);
+        DEBUG("gnrc_single_thread: queue of layer %p full\n", (void *)layer);
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    layer->queue[idx] = msg;
+    irq_restore(state);
+    /* does nothing if the layer is already posted */
+    event_post(&_queue, &layer->super);
+}
+
+static gnrc_single_thread_layer_t *_layer_of(uint16_t type)
+{
+    for (gnrc_single_thread_layer_t *layer = _layers; layer != NULL;
+         layer = layer->next) {
+        if ((type >= layer->msg_first) && (type <= layer->msg_last)) {
+            return layer;
+        }
+        if ((type >= GNRC_NETAPI_MSG_TYPE_RCV) &&
+            (type <= GNRC_NETAPI_MSG_TYPE_GET) &&
+            (layer->type == GNRC_NETTYPE_IPV6)) {
+            return layer;
+        }
+    }
+    return NULL;
+}
+
+static void _handle_msg(msg_t *msg)
+{
+    gnrc_single_thread_layer_t *layer = _layer_of(msg->type);
+
+    if (layer != NULL) {
+        _handle(layer, msg);
+    }
+    else if ((msg->type == GNRC_NETAPI_MSG_TYPE_SET) ||
+             (msg->type == GNRC_NETAPI_MSG_TYPE_GET)) {
+        msg_t reply = { .type = GNRC_NETAPI_MSG_TYPE_ACK,
+                        .content = { .value = (uint32_t)-ENOTSUP } };
+
+        msg_reply(msg, &reply);
+    }
+    else if ((msg->type == GNRC_NETAPI_MSG_TYPE_RCV) ||
+             (msg->type == GNRC_NETAPI_MSG_TYPE_SND)) {
+        gnrc_pktbuf_release(msg->content.ptr);
+    }
+    else {
+        DEBUG("gnrc_single_thread: received unidentified message\n");
+    }
+}
+
+static void *_event_loop(void *arg)
+{
+    msg_t msg_queue[GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE);
+    while (1) {
+        event_t *event;
+        msg_t msg;
+
+        thread_flags_wait_any(THREAD_FLAG_EVENT | THREAD_FLAG_MSG_WAITING);
+        while (msg_try_receive(&msg) == 1) {
+            _handle_msg(&msg);
+        }
+        while ((event = event_get(&_queue)) != NULL) {
+            event->handler(event);
+        }
+    }
+    /* never reached */
+    return NULL;
+}
+
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer,
+                                    gnrc_nettype_t type,
+                                    gnrc_single_thread_handler_t handler,
+                                    uint16_t msg_first, uint16_t msg_last)
+{
+    assert((layer != NULL) && (handler != NULL));
+
+    if (_pid == KERNEL_PID_UNDEF) {
+        _pid = thread_create(_stack, sizeof(_stack), GNRC_SINGLE_THREAD_PRIO,
+                             THREAD_CREATE_STACKTEST, _event_loop, NULL,
+                             "gnrc");
+        if (_pid <= KERNEL_PID_UNDEF) {
+            return _pid;
+        }
+        _queue.waiter = (thread_t *)thread_get(_pid);
+    }
+    layer->super.list_node.next = NULL;
+    layer->super.handler = _drain;
+    layer->handler = handler;
+    layer->type = type;
+    layer->msg_first = msg_first;
+    layer->msg_last = msg_last;
+    cib_init(&layer->cib, GNRC_SINGLE_THREAD_LAYER_QUEUE_SIZE);
+    layer->busy = false;
+    layer->cbd.cb = _cb;
+    layer->cbd.ctx = layer;
+    gnrc_netreg_entry_init_cb(&layer->entry, GNRC_NETREG_DEMUX_CTX_ALL,
+                              &layer->cbd);
+    unsigned state = irq_disable();
+    layer->next = _layers;
+    _layers = layer;
+    irq_restore(state);
+    gnrc_netreg_register(type, &layer->entry);
+    return _pid;
+}
+
+/** @} */
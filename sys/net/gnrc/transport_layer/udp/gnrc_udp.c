@@ -38,6 +38,14 @@
  */
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+
+/**
+ * @brief   UDP's layer in the shared thread
+ */
+static gnrc_single_thread_layer_t _layer;
+#else
 /**
  * @brief   Allocate memory for the UDP thread's stack
  */
@@ -46,6 +54,7 @@ static char _stack[GNRC_UDP_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_UDP_STACK_SIZE];
 #endif
+#endif
 
 /**
  * @brief   Calculate the UDP checksum dependent on the network protocol
@@ -217,16 +226,39 @@ static void _send(gnrc_pktsnip_t *pkt)
     }
 }
 
+static void _handle_msg(msg_t *msg)
+{
+    msg_t reply;
+
+    switch (msg->type) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("udp: GNRC_NETAPI_MSG_TYPE_RCV\n");
+            _receive(msg->content.ptr);
+            break;
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("udp: GNRC_NETAPI_MSG_TYPE_SND\n");
+            _send(msg->content.ptr);
+            break;
+        case GNRC_NETAPI_MSG_TYPE_SET:
+        case GNRC_NETAPI_MSG_TYPE_GET:
+            reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+            reply.content.value = (uint32_t)-ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
+        default:
+            DEBUG("udp: received unidentified message\n");
+            break;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *arg)
 {
     (void)arg;
-    msg_t msg, reply;
+    msg_t msg;
     msg_t msg_queue[GNRC_UDP_MSG_QUEUE_SIZE];
     gnrc_netreg_entry_t netreg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
-    /* preset reply message */
-    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
-    reply.content.value = (uint32_t)-ENOTSUP;
     /* initialize message queue */
     msg_init_queue(msg_queue, GNRC_UDP_MSG_QUEUE_SIZE);
     /* register UPD at netreg */
@@ -235,28 +267,13 @@ static void *_event_loop(void *arg)
     /* dispatch NETAPI messages */
     while (1) {
         msg_receive(&msg);
-        switch (msg.type) {
-            case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("udp: GNRC_NETAPI_MSG_TYPE_RCV\n");
-                _receive(msg.content.ptr);
-                break;
-            case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("udp: GNRC_NETAPI_MSG_TYPE_SND\n");
-                _send(msg.content.ptr);
-                break;
-            case GNRC_NETAPI_MSG_TYPE_SET:
-            case GNRC_NETAPI_MSG_TYPE_GET:
-                msg_reply(&msg, &reply);
-                break;
-            default:
-                DEBUG("udp: received unidentified message\n");
-                break;
-        }
+        _handle_msg(&msg);
     }
 
     /* never reached */
     return NULL;
 }
+#endif
 
 int gnrc_udp_calc_csum(gnrc_pktsnip_t *hdr, gnrc_pktsnip_t *pseudo_hdr)
 {
@@ -300,9 +317,14 @@ int gnrc_udp_init(void)
 {
     /* check if thread is already running */
     if (_pid == KERNEL_PID_UNDEF) {
+#ifdef MODULE_GNRC_SINGLE_THREAD
+        _pid = gnrc_single_thread_add(&_layer, GNRC_NETTYPE_UDP, _handle_msg,
+                                      1, 0);
+#else
         /* start UDP thread */
         _pid = thread_create(_stack, sizeof(_stack), GNRC_UDP_PRIO,
                              THREAD_CREATE_STACKTEST, _event_loop, NULL, "udp");
+#endif
     }
     return _pid;
 }
@@ -48,6 +48,29 @@ void sixlowpan_print(uint8_t *data, size_t size)
         sixlowpan_print(data + sizeof(sixlowpan_frag_t),
                            size - sizeof(sixlowpan_frag_t));
     }
+    else if (sixlowpan_sfr_rfrag_is((sixlowpan_sfr_t *)data)) {
+        sixlowpan_sfr_rfrag_t *hdr = (sixlowpan_sfr_rfrag_t *)data;
+
+        puts("Recoverable Fragment Header");
+        printf("tag: 0x%02x\n", (unsigned)hdr->base.tag);
+        printf("sequence: %u%s\n", sixlowpan_sfr_rfrag_get_seq(hdr),
+               (sixlowpan_sfr_rfrag_ack_req(hdr)) ? " (ack requested)" : "");
+        printf("fragment size: %u\n", sixlowpan_sfr_rfrag_get_frag_size(hdr));
+        printf("%s: %u\n",
+               (sixlowpan_sfr_rfrag_get_seq(hdr) == 0) ? "datagram size"
+                                                        : "offset",
+               (unsigned)byteorder_ntohs(hdr->offset));
+        od_hex_dump(data + sizeof(sixlowpan_sfr_rfrag_t),
+                    size - sizeof(sixlowpan_sfr_rfrag_t), OD_WIDTH_DEFAULT);
+    }
+    else if (sixlowpan_sfr_ack_is((sixlowpan_sfr_t *)data)) {
+        sixlowpan_sfr_ack_t *hdr = (sixlowpan_sfr_ack_t *)data;
+
+        puts("Recoverable Fragment Acknowledgment Header");
+        printf("tag: 0x%02x\n", (unsigned)hdr->base.tag);
+        printf("bitmap: %02x%02x%02x%02x\n", hdr->bitmap[0], hdr->bitmap[1],
+               hdr->bitmap[2], hdr->bitmap[3]);
+    }
     else if ((data[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_N_DISP) {
         sixlowpan_frag_n_t *hdr = (sixlowpan_frag_n_t *)data;
 
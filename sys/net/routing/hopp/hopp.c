@@ -8,6 +8,10 @@
 
 #include <stdio.h>
 
+#include "bitfield.h"
+#include "bloom.h"
+#include "hashes.h"
+#include "mutex.h"
 #include "xtimer.h"
 #include "evtimer.h"
 #include "evtimer_msg.h"
@@ -26,6 +30,7 @@
 #include "compas/trickle.h"
 
 #include "net/hopp/hopp.h"
+#include "net/hopp/nam_idx.h"
 
 #ifdef MODULE_PKTCNT_FAST
 #include "pktcnt.h"
@@ -33,42 +38,226 @@
 
 #define CCNL_ENC_HOPP (0x08)
 
-char hopp_stack[HOPP_STACKSZ];
-gnrc_netif_t *hopp_netif;
-kernel_pid_t hopp_pid;
+#define HOPP_NAM_WHEEL_NONE         (UINT16_MAX)
 
-static unsigned char _out[CCNL_MAX_PACKET_SIZE];
+#if HOPP_NAM_WHEEL_SLOTS > UINT8_MAX
+#error "HOPP_NAM_WHEEL_SLOTS must fit into uint8_t"
+#endif
 
 extern kernel_pid_t _ccnl_event_loop_pid;
 
-static struct ccnl_face_s *loopback_face;
-static msg_t hopp_q[HOPP_QSZ];
-static evtimer_msg_t evtimer;
-compas_dodag_t dodag;
-static evtimer_msg_event_t sol_msg_evt = { .msg.type = HOPP_SOL_MSG };
-static evtimer_msg_event_t pam_msg_evt = { .msg.type = HOPP_PAM_MSG };
-//static evtimer_msg_event_t nam_msg_evt = { .msg.type = HOPP_NAM_MSG };
-static evtimer_msg_event_t pto_msg_evt = { .msg.type = HOPP_PARENT_TIMEOUT_MSG };
-static uint32_t nce_times[COMPAS_NAM_CACHE_LEN];
-static evtimer_msg_event_t nam_msg_evts[COMPAS_NAM_CACHE_LEN];
+/* content store membership: a counting Bloom filter over the names of all
+ * contents HoPP handed to or saw arriving at the content store, so check_nce()
+ * only asks the CCN-lite thread about names that may be cached */
+static uint8_t _cs_filter_cnt[HOPP_CS_FILTER_LEN];
+static hashfp_t _cs_filter_hashes[] = {
+    (hashfp_t) fnv_hash,
+    (hashfp_t) sdbm_hash,
+    (hashfp_t) djb2_hash,
+};
+static bloom_cnt_t _cs_filter = {
+    .m = HOPP_CS_FILTER_LEN,
+    .k = sizeof(_cs_filter_hashes) / sizeof(_cs_filter_hashes[0]),
+    .c = _cs_filter_cnt,
+    .hash = _cs_filter_hashes,
+};
+/* serializes writers, readers do not lock */
+static mutex_t _cs_filter_lock = MUTEX_INIT;
+
+/* running instances, searched by the CCN-lite callbacks */
+static hopp_t *_instances = NULL;
+static mutex_t _instances_lock = MUTEX_INIT;
+/* CCN-lite dispatches the HoPP frames of all interfaces with
+ * GNRC_NETREG_DEMUX_CTX_ALL, so only the first running instance registers
+ * and hands frames of other interfaces over to their instance */
+static gnrc_netreg_entry_t _netreg;
+
+void hopp_cs_add(const char *name, size_t name_len)
+{
+    mutex_lock(&_cs_filter_lock);
+    bloom_cnt_add(&_cs_filter, (const uint8_t *)name, name_len);
+    mutex_unlock(&_cs_filter_lock);
+}
+
+void hopp_cs_remove(const char *name, size_t name_len)
+{
+    mutex_lock(&_cs_filter_lock);
+    bloom_cnt_remove(&_cs_filter, (const uint8_t *)name, name_len);
+    mutex_unlock(&_cs_filter_lock);
+}
 
-static hopp_cb_published cb_published = NULL;
+static bool hopp_cs_check(const compas_name_t *name)
+{
+    return bloom_cnt_check(&_cs_filter, (const uint8_t *)name->name,
+                           name->name_len);
+}
 
-void hopp_set_cb_published(hopp_cb_published cb)
+void hopp_set_cb_published(hopp_t *hopp, hopp_cb_published cb)
 {
-    cb_published = cb;
+    hopp->cb_published = cb;
 }
 
-static void hopp_parent_timeout(compas_dodag_t *dodag)
+static void hopp_parent_timeout(hopp_t *hopp)
 {
-    evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pto_msg_evt);
-    evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&sol_msg_evt);
-    dodag->parent.alive = false;
+    evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pto_msg_evt);
+    evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->sol_msg_evt);
+    hopp->dodag.parent.alive = false;
     msg_t m = { .type = HOPP_SOL_MSG, .content.value = 0 };
-    msg_try_send(&m, hopp_pid);
+    msg_try_send(&m, hopp->pid);
+}
+
+static void hopp_nam_wheel_init(hopp_t *hopp)
+{
+    memset(&hopp->nam_wheel, 0, sizeof(hopp->nam_wheel));
+    for (unsigned i = 0; i < HOPP_NAM_WHEEL_SLOTS; i++) {
+        hopp->nam_wheel.head[i] = HOPP_NAM_WHEEL_NONE;
+    }
+    for (unsigned i = 0; i < COMPAS_NAM_CACHE_LEN; i++) {
+        hopp->nam_wheel.bucket[i] = HOPP_NAM_WHEEL_SLOTS;
+    }
+}
+
+static void hopp_nam_wheel_cancel(hopp_t *hopp, uint16_t pos)
+{
+    uint8_t bucket = hopp->nam_wheel.bucket[pos];
+
+    if (bucket == HOPP_NAM_WHEEL_SLOTS) {
+        return;
+    }
+    if (hopp->nam_wheel.prev[pos] == HOPP_NAM_WHEEL_NONE) {
+        hopp->nam_wheel.head[bucket] = hopp->nam_wheel.next[pos];
+    }
+    else {
+        hopp->nam_wheel.next[hopp->nam_wheel.prev[pos]] = hopp->nam_wheel.next[pos];
+    }
+    if (hopp->nam_wheel.next[pos] != HOPP_NAM_WHEEL_NONE) {
+        hopp->nam_wheel.prev[hopp->nam_wheel.next[pos]] = hopp->nam_wheel.prev[pos];
+    }
+    hopp->nam_wheel.bucket[pos] = HOPP_NAM_WHEEL_SLOTS;
+    hopp->nam_wheel.armed--;
+}
+
+static void hopp_nam_wheel_arm(hopp_t *hopp, uint16_t pos, uint32_t offset)
+{
+    uint32_t ticks = (offset + HOPP_NAM_WHEEL_TICK - 1) / HOPP_NAM_WHEEL_TICK;
+
+    /* offsets beyond the wheel span are cut short: a NAM is rather sent early
+     * than dropped */
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    else if (ticks >= HOPP_NAM_WHEEL_SLOTS) {
+        ticks = HOPP_NAM_WHEEL_SLOTS - 1;
+    }
+
+    hopp_nam_wheel_cancel(hopp, pos);
+    uint8_t bucket = (hopp->nam_wheel.cur + ticks) % HOPP_NAM_WHEEL_SLOTS;
+    hopp->nam_wheel.prev[pos] = HOPP_NAM_WHEEL_NONE;
+    hopp->nam_wheel.next[pos] = hopp->nam_wheel.head[bucket];
+    if (hopp->nam_wheel.head[bucket] != HOPP_NAM_WHEEL_NONE) {
+        hopp->nam_wheel.prev[hopp->nam_wheel.head[bucket]] = pos;
+    }
+    hopp->nam_wheel.head[bucket] = pos;
+    hopp->nam_wheel.bucket[pos] = bucket;
+    hopp->nam_wheel.armed++;
+
+    if (!hopp->nam_wheel.running) {
+        hopp->nam_wheel.running = true;
+        ((evtimer_event_t *)&hopp->nam_wheel_evt)->offset = HOPP_NAM_WHEEL_TICK;
+        evtimer_add_msg(&hopp->evtimer, &hopp->nam_wheel_evt, hopp->pid);
+    }
 }
 
-static bool hopp_send(gnrc_pktsnip_t *pkt, uint8_t *addr, uint8_t addr_len)
+static inline bool hopp_nam_wheel_armed(hopp_t *hopp, uint16_t pos)
+{
+    return (hopp->nam_wheel.bucket[pos] != HOPP_NAM_WHEEL_SLOTS);
+}
+
+/* removes and returns the next expired slot of the current bucket */
+static uint16_t hopp_nam_wheel_pop(hopp_t *hopp)
+{
+    uint16_t pos = hopp->nam_wheel.head[hopp->nam_wheel.cur];
+
+    if (pos != HOPP_NAM_WHEEL_NONE) {
+        hopp_nam_wheel_cancel(hopp, pos);
+    }
+    return pos;
+}
+
+static void hopp_nam_wheel_tick(hopp_t *hopp)
+{
+    hopp->nam_wheel.cur = (hopp->nam_wheel.cur + 1) % HOPP_NAM_WHEEL_SLOTS;
+}
+
+static void hopp_nam_wheel_reschedule(hopp_t *hopp)
+{
+    if (hopp->nam_wheel.armed > 0) {
+        ((evtimer_event_t *)&hopp->nam_wheel_evt)->offset = HOPP_NAM_WHEEL_TICK;
+        evtimer_add_msg(&hopp->evtimer, &hopp->nam_wheel_evt, hopp->pid);
+    }
+    else {
+        hopp->nam_wheel.running = false;
+    }
+}
+
+static compas_nam_cache_entry_t *hopp_nce_find(hopp_t *hopp,
+                                               const compas_name_t *name)
+{
+    mutex_lock(&hopp->lock);
+    compas_nam_cache_entry_t *nce = hopp_nam_idx_find(&hopp->nam_idx, name);
+    mutex_unlock(&hopp->lock);
+    return nce;
+}
+
+static compas_nam_cache_entry_t *hopp_nce_add(hopp_t *hopp,
+                                              compas_name_t *name,
+                                              compas_face_t *face)
+{
+    mutex_lock(&hopp->lock);
+    compas_nam_cache_entry_t *nce = compas_nam_cache_add(&hopp->dodag, name, face);
+
+    /* compas may hand out an entry that is already indexed */
+    if (nce && (hopp_nam_idx_find(&hopp->nam_idx, &nce->name) != nce)) {
+        if (hopp_nam_idx_add(&hopp->nam_idx, nce - hopp->dodag.nam_cache) < 0) {
+            memset(nce, 0, sizeof(*nce));
+            nce = NULL;
+        }
+    }
+    mutex_unlock(&hopp->lock);
+    return nce;
+}
+
+/* marks an entry for announcement, may be called by any thread */
+static void hopp_nce_set_requested(hopp_t *hopp, compas_nam_cache_entry_t *nce)
+{
+    mutex_lock(&hopp->lock);
+    nce->flags |= COMPAS_NAM_CACHE_FLAGS_REQUESTED;
+    nce->retries = COMPAS_NAM_CACHE_RETRIES;
+    mutex_unlock(&hopp->lock);
+}
+
+/* removes an entry that was never scheduled, may be called by any thread */
+static void hopp_nce_drop(hopp_t *hopp, compas_nam_cache_entry_t *nce)
+{
+    mutex_lock(&hopp->lock);
+    if (nce->in_use) {
+        hopp_nam_idx_del(&hopp->nam_idx, nce - hopp->dodag.nam_cache);
+    }
+    memset(nce, 0, sizeof(*nce));
+    mutex_unlock(&hopp->lock);
+}
+
+static void hopp_nce_del(hopp_t *hopp, compas_nam_cache_entry_t *nce)
+{
+    unsigned pos = nce - hopp->dodag.nam_cache;
+    hopp_nam_wheel_cancel(hopp, pos);
+#ifdef MODULE_HOPP_NAM_AGGR
+    bf_unset(hopp->nam_pending, pos);
+#endif
+    hopp_nce_drop(hopp, nce);
+}
+
+static bool hopp_send(hopp_t *hopp, gnrc_pktsnip_t *pkt, uint8_t *addr, uint8_t addr_len)
 {
     gnrc_pktsnip_t *hdr = gnrc_netif_hdr_build(NULL, 0, addr, addr_len);
 
@@ -85,7 +274,7 @@ static bool hopp_send(gnrc_pktsnip_t *pkt, uint8_t *addr, uint8_t addr_len)
         nethdr->flags = GNRC_NETIF_HDR_FLAGS_BROADCAST;
     }
 
-    if (gnrc_netapi_send(hopp_netif->pid, pkt) < 1) {
+    if (gnrc_netapi_send(hopp->netif->pid, pkt) < 1) {
         puts("error: unable to send");
         gnrc_pktbuf_release(pkt);
         return false;
@@ -93,8 +282,10 @@ static bool hopp_send(gnrc_pktsnip_t *pkt, uint8_t *addr, uint8_t addr_len)
     return true;
 }
 
-static void hopp_send_pam(compas_dodag_t *dodag, uint8_t *dst_addr, uint8_t dst_addr_len, bool redun)
+static void hopp_send_pam(hopp_t *hopp, uint8_t *dst_addr, uint8_t dst_addr_len, bool redun)
 {
+    compas_dodag_t *dodag = &hopp->dodag;
+
     if (redun && (dodag->trickle.c >= dodag->trickle.k)) {
         return;
     }
@@ -110,13 +301,14 @@ static void hopp_send_pam(compas_dodag_t *dodag, uint8_t *dst_addr, uint8_t dst_
     ((uint8_t *) pkt->data)[1] = CCNL_ENC_HOPP;
     compas_pam_create(dodag, (compas_pam_t *) (((uint8_t *) pkt->data) + 2));
 #ifdef MODULE_PKTCNT_FAST
-    tx_pam++;
+    atomic_fetch_add(&tx_pam, 1);
 #endif
-    hopp_send(pkt, dst_addr, dst_addr_len);
+    hopp_send(hopp, pkt, dst_addr, dst_addr_len);
 }
 
-static void hopp_send_sol(compas_dodag_t *dodag, bool force_bcast)
+static void hopp_send_sol(hopp_t *hopp, bool force_bcast)
 {
+    compas_dodag_t *dodag = &hopp->dodag;
     gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, compas_sol_len() + 2, GNRC_NETTYPE_CCN);
     if (pkt == NULL) {
         puts("send_sol: packet buffer full");
@@ -143,7 +335,7 @@ static void hopp_send_sol(compas_dodag_t *dodag, bool force_bcast)
             }
             */
             if (dodag->parent.alive) {
-                hopp_parent_timeout(dodag);
+                hopp_parent_timeout(hopp);
             }
         }
         dodag->sol_num++;
@@ -151,14 +343,109 @@ static void hopp_send_sol(compas_dodag_t *dodag, bool force_bcast)
 
     compas_sol_create((compas_sol_t *) (((uint8_t *) pkt->data) + 2), flags);
 #ifdef MODULE_PKTCNT_FAST
-    tx_sol++;
+    atomic_fetch_add(&tx_sol, 1);
 #endif
-    hopp_send(pkt, addr, addr_len);
+    hopp_send(hopp, pkt, addr, addr_len);
+
+}
 
+#ifdef MODULE_HOPP_NAM_AGGR
+static uint16_t hopp_nam_aggr_max_len(hopp_t *hopp)
+{
+    if (hopp->nam_aggr_max_len == 0) {
+        uint16_t max_len;
+        if ((gnrc_netapi_get(hopp->netif->pid, NETOPT_MAX_PACKET_SIZE, 0,
+                             &max_len, sizeof(max_len)) == sizeof(max_len)) &&
+            (max_len > 0)) {
+            hopp->nam_aggr_max_len = max_len;
+        }
+        else {
+            hopp->nam_aggr_max_len = HOPP_NAM_AGGR_MAX_LEN;
+        }
+    }
+    return hopp->nam_aggr_max_len;
 }
 
-static void hopp_send_nam(compas_dodag_t *dodag, compas_nam_cache_entry_t *nce)
+static void hopp_nam_aggr_add(hopp_t *hopp, compas_nam_cache_entry_t *nce)
+{
+    bf_set(hopp->nam_pending, nce - hopp->dodag.nam_cache);
+    if (!hopp->nam_aggr_armed) {
+        hopp->nam_aggr_armed = true;
+        ((evtimer_event_t *)&hopp->nam_aggr_evt)->offset = HOPP_NAM_AGGR_WINDOW;
+        evtimer_add_msg(&hopp->evtimer, &hopp->nam_aggr_evt, hopp->pid);
+    }
+}
+
+static void hopp_nam_aggr_flush(hopp_t *hopp)
+{
+    compas_dodag_t *dodag = &hopp->dodag;
+    size_t max_len = hopp_nam_aggr_max_len(hopp);
+    size_t i = 0;
+
+    hopp->nam_aggr_armed = false;
+
+    if (dodag->rank == COMPAS_DODAG_UNDEF) {
+        puts("send_nam: not part of a DODAG");
+        memset(hopp->nam_pending, 0, sizeof(hopp->nam_pending));
+        return;
+    }
+
+    while (i < COMPAS_NAM_CACHE_LEN) {
+        size_t len = 2 + sizeof(compas_nam_t);
+        size_t end;
+        uint32_t names = 0;
+
+        /* collect as many pending names as fit into one frame */
+        for (end = i; end < COMPAS_NAM_CACHE_LEN; end++) {
+            if (!bf_isset(hopp->nam_pending, end)) {
+                continue;
+            }
+            size_t tlv_len = sizeof(compas_tlv_t) + dodag->nam_cache[end].name.name_len;
+            if ((names > 0) && ((len + tlv_len) > max_len)) {
+                break;
+            }
+            len += tlv_len;
+            names++;
+        }
+
+        if (names == 0) {
+            break;
+        }
+
+        gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, len, GNRC_NETTYPE_CCN);
+
+        if (pkt == NULL) {
+            puts("send_nam: packet buffer full");
+            break;
+        }
+
+        ((uint8_t *) pkt->data)[0] = 0x80;
+        ((uint8_t *) pkt->data)[1] = CCNL_ENC_HOPP;
+        compas_nam_t *nam = (compas_nam_t *)(((uint8_t *) pkt->data) + 2);
+        compas_nam_create(nam);
+        for (; i < end; i++) {
+            if (bf_isset(hopp->nam_pending, i)) {
+                compas_nam_tlv_add_name(nam, &dodag->nam_cache[i].name);
+                bf_unset(hopp->nam_pending, i);
+            }
+        }
+
+#ifdef MODULE_PKTCNT_FAST
+        atomic_fetch_add(&tx_nam, 1);
+        atomic_fetch_add(&tx_nam_names, names);
+#endif
+        hopp_send(hopp, pkt, dodag->parent.face.face_addr, dodag->parent.face.face_addr_len);
+    }
+
+    /* names left over after an allocation failure are retransmitted by their
+     * own NAM timers */
+    memset(hopp->nam_pending, 0, sizeof(hopp->nam_pending));
+}
+#else
+static void hopp_send_nam(hopp_t *hopp, compas_nam_cache_entry_t *nce)
 {
+    compas_dodag_t *dodag = &hopp->dodag;
+
     if (dodag->rank == COMPAS_DODAG_UNDEF) {
         puts("send_nam: not part of a DODAG");
         return;
@@ -180,15 +467,18 @@ static void hopp_send_nam(compas_dodag_t *dodag, compas_nam_cache_entry_t *nce)
     compas_nam_tlv_add_name(nam, &nce->name);
 
 #ifdef MODULE_PKTCNT_FAST
-    tx_nam++;
+    atomic_fetch_add(&tx_nam, 1);
+    atomic_fetch_add(&tx_nam_names, 1);
 #endif
-    hopp_send(pkt, dodag->parent.face.face_addr, dodag->parent.face.face_addr_len);
+    hopp_send(hopp, pkt, dodag->parent.face.face_addr, dodag->parent.face.face_addr_len);
 }
+#endif
 
-static void hopp_handle_pam(struct ccnl_relay_s *relay,
-                            compas_dodag_t *dodag, compas_pam_t *pam,
+static void hopp_handle_pam(hopp_t *hopp, compas_pam_t *pam,
                             uint8_t *src_addr, uint8_t src_addr_len)
 {
+    struct ccnl_relay_s *relay = hopp->relay;
+    compas_dodag_t *dodag = &hopp->dodag;
     uint16_t old_rank = dodag->rank;
 
     int state = compas_pam_parse(dodag, pam, src_addr, src_addr_len);
@@ -203,12 +493,12 @@ static void hopp_handle_pam(struct ccnl_relay_s *relay,
             /*
             trickle_init(&dodag->trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
             uint64_t trickle_int = trickle_next(&dodag->trickle);
-            evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pam_msg_evt);
-            ((evtimer_event_t *)&pam_msg_evt)->offset = trickle_int;
-            evtimer_add_msg(&evtimer, &pam_msg_evt, hopp_pid);
+            evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pam_msg_evt);
+            ((evtimer_event_t *)&hopp->pam_msg_evt)->offset = trickle_int;
+            evtimer_add_msg(&hopp->evtimer, &hopp->pam_msg_evt, hopp->pid);
             */
-            hopp_send_sol(dodag, true);
-            hopp_send_pam(dodag, NULL, 0, false);
+            hopp_send_sol(hopp, true);
+            hopp_send_pam(hopp, NULL, 0, false);
         }
 
         char dodag_prfx[COMPAS_PREFIX_LEN + 1];
@@ -236,11 +526,7 @@ static void hopp_handle_pam(struct ccnl_relay_s *relay,
                 if (nce->in_use && compas_nam_cache_requested(nce->flags)) {
                     unsigned pos = nce - dodag->nam_cache;
                     nce->retries = COMPAS_NAM_CACHE_RETRIES;
-                    nam_msg_evts->msg.type = HOPP_NAM_MSG;
-                    nam_msg_evts->msg.content.ptr = nce;
-                    evtimer_del(&evtimer, (evtimer_event_t *)&nam_msg_evts[pos]);
-                    ((evtimer_event_t *)&nam_msg_evts[pos])->offset = HOPP_NAM_PERIOD;
-                    evtimer_add_msg(&evtimer, &nam_msg_evts[pos], hopp_pid);
+                    hopp_nam_wheel_arm(hopp, pos, HOPP_NAM_PERIOD);
                 }
             }
         }
@@ -255,15 +541,15 @@ static void hopp_handle_pam(struct ccnl_relay_s *relay,
             hopp_send_sol(dodag);
             dodag->sol_num = 0x0;
             */
-            hopp_parent_timeout(dodag);
+            hopp_parent_timeout(hopp);
             return;
         }
 
-        evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&sol_msg_evt);
+        evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->sol_msg_evt);
 
-        evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pto_msg_evt);
-        ((evtimer_event_t *)&pto_msg_evt)->offset = HOPP_PARENT_TIMEOUT_PERIOD;
-        evtimer_add_msg(&evtimer, &pto_msg_evt, hopp_pid);
+        evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pto_msg_evt);
+        ((evtimer_event_t *)&hopp->pto_msg_evt)->offset = HOPP_PARENT_TIMEOUT_PERIOD;
+        evtimer_add_msg(&hopp->evtimer, &hopp->pto_msg_evt, hopp->pid);
 
         return;
     }
@@ -277,7 +563,7 @@ static void hopp_handle_pam(struct ccnl_relay_s *relay,
 
 void hopp_request(struct ccnl_relay_s *relay, compas_nam_cache_entry_t *nce)
 {
-    static unsigned char int_buf[HOPP_INTEREST_BUFSIZE];
+    unsigned char int_buf[HOPP_INTEREST_BUFSIZE];
     char name[COMPAS_NAME_LEN + 1];
     memcpy(name, nce->name.name, nce->name.name_len);
     name[nce->name.name_len] = '\0';
@@ -301,9 +587,10 @@ void hopp_request(struct ccnl_relay_s *relay, compas_nam_cache_entry_t *nce)
     ccnl_prefix_free(prefix);
 }
 
-static void hopp_handle_nam(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
-                            compas_nam_t *nam, uint8_t *src_addr, uint8_t src_addr_len)
+static void hopp_handle_nam(hopp_t *hopp, compas_nam_t *nam,
+                            uint8_t *src_addr, uint8_t src_addr_len)
 {
+    compas_dodag_t *dodag = &hopp->dodag;
     uint16_t offset = 0;
     compas_tlv_t *tlv = NULL;
 
@@ -318,19 +605,18 @@ static void hopp_handle_nam(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
             char name[COMPAS_NAME_LEN + 1];
             memcpy(name, cname.name, cname.name_len);
             name[cname.name_len] = '\0';
-            compas_nam_cache_entry_t *n = compas_nam_cache_find(dodag, &cname);
+            compas_nam_cache_entry_t *n = hopp_nce_find(hopp, &cname);
             if (!n) {
-                n = compas_nam_cache_add(dodag, &cname, &face);
+                n = hopp_nce_add(hopp, &cname, &face);
                 if (!n) {
                     uint32_t now = xtimer_now_usec();
                     for (size_t i = 0; i < COMPAS_NAM_CACHE_LEN; i++) {
                         compas_nam_cache_entry_t *nce = &dodag->nam_cache[i];
                         unsigned pos = nce - dodag->nam_cache;
-                        unsigned time = now - nce_times[pos];
+                        unsigned time = now - hopp->nce_times[pos];
                         if (nce->in_use && !compas_nam_cache_requested(nce->flags) && (time > HOPP_NAM_STALE_TIME)) {
-                            evtimer_del(&evtimer, (evtimer_event_t *)&nam_msg_evts[pos]);
-                            memset(nce, 0, sizeof(*nce));
-                            n = compas_nam_cache_add(dodag, &cname, &face);
+                            hopp_nce_del(hopp, nce);
+                            n = hopp_nce_add(hopp, &cname, &face);
                             break;
                         }
                     }
@@ -338,11 +624,10 @@ static void hopp_handle_nam(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
                         for (size_t i = 0; i < COMPAS_NAM_CACHE_LEN; i++) {
                             compas_nam_cache_entry_t *nce = &dodag->nam_cache[i];
                             unsigned pos = nce - dodag->nam_cache;
-                            unsigned time = now - nce_times[pos];
+                            unsigned time = now - hopp->nce_times[pos];
                             if (nce->in_use && (time > HOPP_NAM_STALE_TIME)) {
-                                evtimer_del(&evtimer, (evtimer_event_t *)&nam_msg_evts[pos]);
-                                memset(nce, 0, sizeof(*nce));
-                                n = compas_nam_cache_add(dodag, &cname, &face);
+                                hopp_nce_del(hopp, nce);
+                                n = hopp_nce_add(hopp, &cname, &face);
                                 break;
                             }
                         }
@@ -354,11 +639,11 @@ static void hopp_handle_nam(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
                 }
             }
             if (n) {
-                nce_times[n - dodag->nam_cache] = xtimer_now_usec();
-                hopp_request(relay, n);
+                hopp->nce_times[n - dodag->nam_cache] = xtimer_now_usec();
+                hopp_request(hopp->relay, n);
 #if 0
                 msg_t msg = { .type = HOPP_NAM_MSG, .content.ptr = n };
-                msg_try_send(&msg, hopp_pid);
+                msg_try_send(&msg, hopp->pid);
 #endif
             }
         }
@@ -367,9 +652,11 @@ static void hopp_handle_nam(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
     return;
 }
 
-static void hopp_handle_sol(compas_dodag_t *dodag, compas_sol_t *sol,
+static void hopp_handle_sol(hopp_t *hopp, compas_sol_t *sol,
                             uint8_t *dst_addr, uint8_t dst_addr_len)
 {
+    compas_dodag_t *dodag = &hopp->dodag;
+
     if ((dodag->rank == COMPAS_DODAG_UNDEF) || (compas_dodag_floating(dodag->flags))) {
         return;
     }
@@ -390,23 +677,21 @@ static void hopp_handle_sol(compas_dodag_t *dodag, compas_sol_t *sol,
     if (compas_sol_reset_trickle(sol->flags)) {
         trickle_init(&dodag->trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
         uint64_t trickle_int = trickle_next(&dodag->trickle);
-        evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pam_msg_evt);
-        ((evtimer_event_t *)&pam_msg_evt)->offset = trickle_int;
-        evtimer_add_msg(&evtimer, &pam_msg_evt, hopp_pid);
+        evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pam_msg_evt);
+        ((evtimer_event_t *)&hopp->pam_msg_evt)->offset = trickle_int;
+        evtimer_add_msg(&hopp->evtimer, &hopp->pam_msg_evt, hopp->pid);
     }
     else {
-        hopp_send_pam(dodag, dst_addr, dst_addr_len, false);
+        hopp_send_pam(hopp, dst_addr, dst_addr_len, false);
     }
 
     return;
 }
 
-static void hopp_dispatcher(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
-                            uint8_t *data, size_t data_len, uint8_t *src_addr,
-                            uint8_t src_addr_len, uint8_t *dst_addr,
-                            uint8_t dst_addr_len)
+static void hopp_dispatcher(hopp_t *hopp, uint8_t *data, size_t data_len,
+                            uint8_t *src_addr, uint8_t src_addr_len,
+                            uint8_t *dst_addr, uint8_t dst_addr_len)
 {
-    (void) relay;
     (void) dst_addr;
     (void) dst_addr_len;
     (void) data_len;
@@ -416,123 +701,261 @@ static void hopp_dispatcher(struct ccnl_relay_s *relay, compas_dodag_t *dodag,
     switch (data[2]) {
         case COMPAS_MSG_TYPE_SOL:
 #ifdef MODULE_PKTCNT_FAST
-            rx_sol++;
+            atomic_fetch_add(&rx_sol, 1);
 #endif
-            hopp_handle_sol(dodag, (compas_sol_t *) (data + 2),
+            hopp_handle_sol(hopp, (compas_sol_t *) (data + 2),
                             src_addr, src_addr_len);
             break;
         case COMPAS_MSG_TYPE_PAM:
 #ifdef MODULE_PKTCNT_FAST
-            rx_pam++;
+            atomic_fetch_add(&rx_pam, 1);
 #endif
-            hopp_handle_pam(relay, dodag, (compas_pam_t *) (data + 2),
+            hopp_handle_pam(hopp, (compas_pam_t *) (data + 2),
                             src_addr, src_addr_len);
             break;
         case COMPAS_MSG_TYPE_NAM:
 #ifdef MODULE_PKTCNT_FAST
-            rx_nam++;
+            atomic_fetch_add(&rx_nam, 1);
 #endif
-            hopp_handle_nam(relay, dodag, (compas_nam_t *) (data + 2),
-                              src_addr, src_addr_len);
+            hopp_handle_nam(hopp, (compas_nam_t *) (data + 2),
+                            src_addr, src_addr_len);
             break;
         default:
             break;
     }
 }
 
-static void hopp_nce_del(compas_dodag_t *dodag, compas_nam_cache_entry_t *nce)
-{
-    unsigned pos = nce - dodag->nam_cache;
-    evtimer_del(&evtimer, (evtimer_event_t *)&nam_msg_evts[pos]);
-    memset(nce, 0, sizeof(*nce));
-}
-
-static bool check_nce(compas_dodag_t *dodag, compas_nam_cache_entry_t *nce)
+static bool check_nce(hopp_t *hopp, compas_nam_cache_entry_t *nce)
 {
     if (nce->in_use && compas_nam_cache_requested(nce->flags)) {
-        if (nce->retries > 0) {
+        mutex_lock(&hopp->lock);
+        bool retry = (nce->retries > 0);
+        if (retry) {
             nce->retries--;
-            hopp_send_nam(dodag, nce);
+        }
+        mutex_unlock(&hopp->lock);
+        if (retry) {
+#ifdef MODULE_HOPP_NAM_AGGR
+            hopp_nam_aggr_add(hopp, nce);
+#else
+            hopp_send_nam(hopp, nce);
+#endif
             return true;
         }
         else {
-            msg_t mr, ms = { .type = CCNL_MSG_IN_CS, .content.ptr = nce->name.name };
-            msg_send_receive(&ms, &mr, _ccnl_event_loop_pid);
-            if (!mr.content.value) {
-                hopp_nce_del(dodag, nce);
+            /* only names that may be cached need the exact answer of the
+             * CCN-lite thread */
+            bool in_cs = hopp_cs_check(&nce->name);
+            if (in_cs) {
+                msg_t mr, ms = { .type = CCNL_MSG_IN_CS, .content.ptr = nce->name.name };
+                msg_send_receive(&ms, &mr, _ccnl_event_loop_pid);
+                in_cs = mr.content.value;
             }
-            dodag->sol_num = 0xFF;
-            hopp_parent_timeout(dodag);
+            if (!in_cs) {
+                hopp_nce_del(hopp, nce);
+            }
+            hopp->dodag.sol_num = 0xFF;
+            hopp_parent_timeout(hopp);
         }
     }
 
     return false;
 }
 
+/**
+ * @brief   Writes the URI of @p pfx to @p buf like ccnl_prefix_to_path()
+ *          does for NDN TLV prefixes, but without heap allocation
+ *
+ * @return  length of the URI in @p buf
+ * @return  -1 if the URI does not fit into @p buf_len bytes
+ */
+static int hopp_prefix_to_name(const struct ccnl_prefix_s *pfx, char *buf,
+                               size_t buf_len)
+{
+    size_t len = 0;
+
+    for (int i = 0; i < pfx->compcnt; i++) {
+        size_t comp_len = pfx->complen[i];
+        if ((len + 1 + comp_len) > buf_len) {
+            return -1;
+        }
+        buf[len++] = '/';
+        memcpy(&buf[len], pfx->comp[i], comp_len);
+        len += comp_len;
+    }
+    return len;
+}
+
+static bool hopp_prefix_to_cname(const struct ccnl_prefix_s *pfx,
+                                 compas_name_t *cname)
+{
+    char name[COMPAS_NAME_LEN];
+    int name_len = hopp_prefix_to_name(pfx, name, sizeof(name));
+
+    /* names longer than COMPAS_NAME_LEN can not be in the NAM cache */
+    if (name_len < 0) {
+        return false;
+    }
+    compas_name_init(cname, name, name_len);
+    return true;
+}
+
+static void hopp_cs_add_prefix(const struct ccnl_prefix_s *pfx)
+{
+    char name[COMPAS_NAME_LEN];
+    int name_len = hopp_prefix_to_name(pfx, name, sizeof(name));
+
+    /* longer names are never looked up in the filter */
+    if (name_len >= 0) {
+        hopp_cs_add(name, name_len);
+    }
+}
+
+static void hopp_nam_due(hopp_t *hopp, compas_nam_cache_entry_t *nce)
+{
+    compas_dodag_t *dodag = &hopp->dodag;
+    unsigned pos = nce - dodag->nam_cache;
+
+    hopp_nam_wheel_cancel(hopp, pos);
+    if (dodag->rank != COMPAS_DODAG_UNDEF) {
+        if ((dodag->parent.alive || dodag->rank == COMPAS_DODAG_ROOT_RANK) &&
+             check_nce(hopp, nce)) {
+            hopp_nam_wheel_arm(hopp, pos, HOPP_NAM_PERIOD);
+        }
+    }
+}
+
 static int content_send(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt) {
     (void) relay;
     compas_name_t cname;
-    char *s = ccnl_prefix_to_path(pkt->pfx);
-    compas_name_init(&cname, s, strlen(s));
-    ccnl_free(s);
-    compas_nam_cache_entry_t *n = compas_nam_cache_find(&dodag, &cname);
 
-    if (n) {
-        msg_t msg = { .type = HOPP_NAM_DEL_MSG, .content.ptr = n };
-        msg_try_send(&msg, hopp_pid);
+    if (!hopp_prefix_to_cname(pkt->pfx, &cname)) {
+        return 1;
+    }
+
+    mutex_lock(&_instances_lock);
+    for (hopp_t *hopp = _instances; hopp != NULL; hopp = hopp->next) {
+        compas_nam_cache_entry_t *n = hopp_nce_find(hopp, &cname);
+
+        if (n) {
+            msg_t msg = { .type = HOPP_NAM_DEL_MSG, .content.ptr = n };
+            msg_try_send(&msg, hopp->pid);
+        }
     }
+    mutex_unlock(&_instances_lock);
     return 1;
 }
 
 static int content_requested(struct ccnl_relay_s *relay, struct ccnl_pkt_s *p,
                              struct ccnl_face_s *from)
 {
-    (void) relay;
-    (void) from;
-    char *s = ccnl_prefix_to_path(p->pfx);
-
     compas_name_t cname;
-    compas_name_init(&cname, s, strlen(s));
-    compas_nam_cache_entry_t *n = compas_nam_cache_find(&dodag, &cname);
 
-    if (n) {
-        if (cb_published) {
-            cb_published(relay, p, from);
-        }
+    /* received content goes to the content store */
+    hopp_cs_add_prefix(p->pfx);
 
-        msg_t msg = { .content.ptr = n };
-        if ((dodag.rank == COMPAS_DODAG_ROOT_RANK)) {
-            msg.type = HOPP_NAM_DEL_MSG;
-        }
-        else {
+    if (!hopp_prefix_to_cname(p->pfx, &cname)) {
+        return 1;
+    }
+
+    mutex_lock(&_instances_lock);
+    for (hopp_t *hopp = _instances; hopp != NULL; hopp = hopp->next) {
+        msg_t msg = { .type = HOPP_NAM_DEL_MSG };
+
+        /* the lock keeps the HoPP thread from removing the entry while it
+         * is updated */
+        mutex_lock(&hopp->lock);
+        compas_nam_cache_entry_t *n = hopp_nam_idx_find(&hopp->nam_idx, &cname);
+        if (n && (hopp->dodag.rank != COMPAS_DODAG_ROOT_RANK)) {
             n->flags |= COMPAS_NAM_CACHE_FLAGS_REQUESTED;
             n->retries = COMPAS_NAM_CACHE_RETRIES;
             msg.type = HOPP_NAM_MSG;
         }
-        msg_try_send(&msg, hopp_pid);
+        mutex_unlock(&hopp->lock);
+
+        if (n) {
+            if (hopp->cb_published) {
+                hopp->cb_published(relay, p, from);
+            }
+            msg.content.ptr = n;
+            msg_try_send(&msg, hopp->pid);
+        }
     }
+    mutex_unlock(&_instances_lock);
 
-    ccnl_free(s);
     return 1;
 }
 
-void *hopp(void *arg)
+static void _instances_add(hopp_t *hopp)
 {
-    struct ccnl_relay_s *relay = (struct ccnl_relay_s *) arg;
-    (void) relay;
+    mutex_lock(&_instances_lock);
+    if (_instances == NULL) {
+        gnrc_netreg_entry_init_pid(&_netreg, GNRC_NETREG_DEMUX_CTX_ALL,
+                                   hopp->pid);
+        gnrc_netreg_register(GNRC_NETTYPE_CCN_HOPP, &_netreg);
+    }
+    hopp->next = _instances;
+    _instances = hopp;
+    mutex_unlock(&_instances_lock);
+}
 
-    msg_init_queue(hopp_q, HOPP_QSZ);
-    evtimer_init_msg(&evtimer);
+/* returns true if hopp was the last running instance */
+static bool _instances_remove(hopp_t *hopp)
+{
+    mutex_lock(&_instances_lock);
+    for (hopp_t **ptr = &_instances; *ptr != NULL; ptr = &(*ptr)->next) {
+        if (*ptr == hopp) {
+            *ptr = hopp->next;
+            break;
+        }
+    }
+    bool last = (_instances == NULL);
+    if (_netreg.target.pid == hopp->pid) {
+        /* hand the registration over to a remaining instance */
+        gnrc_netreg_unregister(GNRC_NETTYPE_CCN_HOPP, &_netreg);
+        if (!last) {
+            gnrc_netreg_entry_init_pid(&_netreg, GNRC_NETREG_DEMUX_CTX_ALL,
+                                       _instances->pid);
+            gnrc_netreg_register(GNRC_NETTYPE_CCN_HOPP, &_netreg);
+        }
+    }
+    mutex_unlock(&_instances_lock);
+    return last;
+}
+
+/* hands pkt over to the instance running on if_pid, consumes pkt */
+static void _instances_forward(kernel_pid_t if_pid, gnrc_pktsnip_t *pkt)
+{
+    msg_t msg = { .type = GNRC_NETAPI_MSG_TYPE_RCV, .content.ptr = pkt };
+    kernel_pid_t pid = KERNEL_PID_UNDEF;
 
-    memset(&dodag, 0, sizeof(dodag));
+    mutex_lock(&_instances_lock);
+    for (hopp_t *hopp = _instances; hopp != NULL; hopp = hopp->next) {
+        if (hopp->netif->pid == if_pid) {
+            pid = hopp->pid;
+            break;
+        }
+    }
+    mutex_unlock(&_instances_lock);
+    if ((pid == KERNEL_PID_UNDEF) || (msg_try_send(&msg, pid) < 1)) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static void *_hopp_thread(void *arg)
+{
+    hopp_t *hopp = (hopp_t *) arg;
+    compas_dodag_t *dodag = &hopp->dodag;
 
-    ((evtimer_event_t *)&sol_msg_evt)->offset = HOPP_SOL_PERIOD;
-    evtimer_add_msg(&evtimer, &sol_msg_evt, sched_active_pid);
+    hopp->pid = thread_getpid();
+    msg_init_queue(hopp->q, HOPP_QSZ);
 
-    gnrc_netreg_entry_t _ne = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, sched_active_pid);
-    gnrc_netreg_register(GNRC_NETTYPE_CCN_HOPP, &_ne);
-    loopback_face = ccnl_get_face_or_create(&ccnl_relay, -1, NULL, 0);
+    ((evtimer_event_t *)&hopp->sol_msg_evt)->offset = HOPP_SOL_PERIOD;
+    evtimer_add_msg(&hopp->evtimer, &hopp->sol_msg_evt, hopp->pid);
 
+    hopp->loopback_face = ccnl_get_face_or_create(hopp->relay, -1, NULL, 0);
+
+    _instances_add(hopp);
     ccnl_callback_set_data_send(content_send);
     ccnl_callback_set_data_received(content_requested);
 
@@ -546,62 +969,87 @@ void *hopp(void *arg)
 
         switch (msg.type) {
             case HOPP_SOL_MSG:
-                if ((dodag.rank != COMPAS_DODAG_ROOT_RANK) &&
-                    (dodag.rank == COMPAS_DODAG_UNDEF || !dodag.parent.alive)) {
-                    hopp_send_sol(&dodag, false);
-                    ((evtimer_event_t *)&sol_msg_evt)->offset = HOPP_SOL_PERIOD;
-                    evtimer_add_msg(&evtimer, &sol_msg_evt, sched_active_pid);
-                    if (dodag.sol_num == 3) {
-                        dodag.flags |= COMPAS_DODAG_FLAGS_FLOATING;
-                        trickle_init(&dodag.trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
-                        uint64_t trickle_int = trickle_next(&dodag.trickle);
-                        evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pam_msg_evt);
-                        ((evtimer_event_t *)&pam_msg_evt)->offset = trickle_int;
-                        evtimer_add_msg(&evtimer, &pam_msg_evt, sched_active_pid);
+                if ((dodag->rank != COMPAS_DODAG_ROOT_RANK) &&
+                    (dodag->rank == COMPAS_DODAG_UNDEF || !dodag->parent.alive)) {
+                    hopp_send_sol(hopp, false);
+                    ((evtimer_event_t *)&hopp->sol_msg_evt)->offset = HOPP_SOL_PERIOD;
+                    evtimer_add_msg(&hopp->evtimer, &hopp->sol_msg_evt, hopp->pid);
+                    if (dodag->sol_num == 3) {
+                        dodag->flags |= COMPAS_DODAG_FLAGS_FLOATING;
+                        trickle_init(&dodag->trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
+                        uint64_t trickle_int = trickle_next(&dodag->trickle);
+                        evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pam_msg_evt);
+                        ((evtimer_event_t *)&hopp->pam_msg_evt)->offset = trickle_int;
+                        evtimer_add_msg(&hopp->evtimer, &hopp->pam_msg_evt, hopp->pid);
                     }
                 }
                 break;
             case HOPP_PAM_MSG:
-                if (dodag.rank != COMPAS_DODAG_UNDEF) {
-                    hopp_send_pam(&dodag, NULL, 0, true);
-                    uint64_t trickle_int = trickle_next(&dodag.trickle);
-                    evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pam_msg_evt);
-                    ((evtimer_event_t *)&pam_msg_evt)->offset = trickle_int;
-                    evtimer_add_msg(&evtimer, &pam_msg_evt, sched_active_pid);
+                if (dodag->rank != COMPAS_DODAG_UNDEF) {
+                    hopp_send_pam(hopp, NULL, 0, true);
+                    uint64_t trickle_int = trickle_next(&dodag->trickle);
+                    evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pam_msg_evt);
+                    ((evtimer_event_t *)&hopp->pam_msg_evt)->offset = trickle_int;
+                    evtimer_add_msg(&hopp->evtimer, &hopp->pam_msg_evt, hopp->pid);
                 }
                 break;
             case HOPP_NAM_MSG:
                 nce = (compas_nam_cache_entry_t *) msg.content.ptr;
-                pos = nce - dodag.nam_cache;
-                evtimer_del(&evtimer, (evtimer_event_t *)&nam_msg_evts[pos]);
-                if (dodag.rank != COMPAS_DODAG_UNDEF) {
-                    if ((dodag.parent.alive || dodag.rank == COMPAS_DODAG_ROOT_RANK) &&
-                         check_nce(&dodag, nce)) {
-                        nam_msg_evts[pos].msg.type = HOPP_NAM_MSG;
-                        nam_msg_evts[pos].msg.content.ptr = nce;
-                        ((evtimer_event_t *)&nam_msg_evts[pos])->offset = HOPP_NAM_PERIOD;
-                        evtimer_add_msg(&evtimer, &nam_msg_evts[pos], sched_active_pid);
+                hopp_nam_due(hopp, nce);
+                break;
+            case HOPP_NAM_TRIGGER_MSG:
+                /* announce all freshly published names that are not yet
+                 * scheduled for (re)transmission */
+                for (pos = 0; pos < COMPAS_NAM_CACHE_LEN; pos++) {
+                    nce = &dodag->nam_cache[pos];
+                    if (nce->in_use && compas_nam_cache_requested(nce->flags) &&
+                        (nce->retries > 0) && !hopp_nam_wheel_armed(hopp, pos)) {
+                        hopp_nam_due(hopp, nce);
                     }
                 }
-
                 break;
+            case HOPP_NAM_WHEEL_MSG:
+                hopp_nam_wheel_tick(hopp);
+                while ((pos = hopp_nam_wheel_pop(hopp)) != HOPP_NAM_WHEEL_NONE) {
+                    hopp_nam_due(hopp, &dodag->nam_cache[pos]);
+                }
+                hopp_nam_wheel_reschedule(hopp);
+                break;
+#ifdef MODULE_HOPP_NAM_AGGR
+            case HOPP_NAM_AGGR_MSG:
+                if (dodag->parent.alive || (dodag->rank == COMPAS_DODAG_ROOT_RANK)) {
+                    hopp_nam_aggr_flush(hopp);
+                }
+                else {
+                    memset(hopp->nam_pending, 0, sizeof(hopp->nam_pending));
+                    hopp->nam_aggr_armed = false;
+                }
+                break;
+#endif
             case HOPP_NAM_DEL_MSG:
                 nce = (compas_nam_cache_entry_t *) msg.content.ptr;
-                hopp_nce_del(&dodag, nce);
+                hopp_nce_del(hopp, nce);
                 break;
             case HOPP_PARENT_TIMEOUT_MSG:
-                hopp_parent_timeout(&dodag);
+                hopp_parent_timeout(hopp);
                 break;
             case HOPP_STOP_MSG:
-                ccnl_callback_set_data_send(NULL);
-                ccnl_callback_set_data_received(NULL);
+                if (_instances_remove(hopp)) {
+                    ccnl_callback_set_data_send(NULL);
+                    ccnl_callback_set_data_received(NULL);
+                }
                 return NULL;
             case GNRC_NETAPI_MSG_TYPE_RCV:
                 pkt = (gnrc_pktsnip_t *) msg.content.ptr;
                 netif_snip = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
                 if (netif_snip) {
                     netif_hdr = (gnrc_netif_hdr_t *) netif_snip->data;
-                    hopp_dispatcher(relay, &dodag, pkt->data, pkt->size,
+                    if (netif_hdr->if_pid != hopp->netif->pid) {
+                        /* received on the interface of another instance */
+                        _instances_forward(netif_hdr->if_pid, pkt);
+                        break;
+                    }
+                    hopp_dispatcher(hopp, pkt->data, pkt->size,
                                     gnrc_netif_hdr_get_src_addr(netif_hdr),
                                     netif_hdr->src_l2addr_len,
                                     gnrc_netif_hdr_get_dst_addr(netif_hdr),
@@ -617,52 +1065,192 @@ void *hopp(void *arg)
     return NULL;
 }
 
-void hopp_root_start(const char *prefix, size_t prefix_len)
+kernel_pid_t hopp_create(hopp_t *hopp, char *stack, int stacksize,
+                         char priority, const char *name, gnrc_netif_t *netif,
+                         struct ccnl_relay_s *relay)
+{
+    memset(hopp, 0, sizeof(*hopp));
+    hopp->netif = netif;
+    hopp->relay = relay;
+    hopp->pid = KERNEL_PID_UNDEF;
+    mutex_init(&hopp->lock);
+    hopp_nam_idx_init(&hopp->nam_idx, hopp->nam_idx_buckets, HOPP_NAM_IDX_LEN,
+                      hopp->dodag.nam_cache, COMPAS_NAM_CACHE_LEN);
+    hopp_nam_wheel_init(hopp);
+    evtimer_init_msg(&hopp->evtimer);
+    hopp->sol_msg_evt.msg.type = HOPP_SOL_MSG;
+    hopp->pam_msg_evt.msg.type = HOPP_PAM_MSG;
+    hopp->pto_msg_evt.msg.type = HOPP_PARENT_TIMEOUT_MSG;
+    hopp->nam_wheel_evt.msg.type = HOPP_NAM_WHEEL_MSG;
+#ifdef MODULE_HOPP_NAM_AGGR
+    hopp->nam_aggr_evt.msg.type = HOPP_NAM_AGGR_MSG;
+#endif
+
+    hopp->pid = thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                              _hopp_thread, hopp, name);
+    return hopp->pid;
+}
+
+void hopp_root_start(hopp_t *hopp, const char *prefix, size_t prefix_len)
 {
-    compas_dodag_init_root(&dodag, prefix, prefix_len);
-    compas_dodag_print(&dodag);
-    trickle_init(&dodag.trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
-    uint64_t trickle_int = trickle_next(&dodag.trickle);
-    evtimer_del((evtimer_t *)(&evtimer), (evtimer_event_t *)&pam_msg_evt);
-    ((evtimer_event_t *)&pam_msg_evt)->offset = trickle_int;
-    evtimer_add_msg(&evtimer, &pam_msg_evt, hopp_pid);
+    compas_dodag_t *dodag = &hopp->dodag;
+
+    mutex_lock(&hopp->lock);
+    compas_dodag_init_root(dodag, prefix, prefix_len);
+    hopp_nam_idx_rebuild(&hopp->nam_idx);
+    mutex_unlock(&hopp->lock);
+    compas_dodag_print(dodag);
+    trickle_init(&dodag->trickle, HOPP_TRICKLE_IMIN, HOPP_TRICKLE_IMAX, HOPP_TRICKLE_REDCONST);
+    uint64_t trickle_int = trickle_next(&dodag->trickle);
+    evtimer_del((evtimer_t *)(&hopp->evtimer), (evtimer_event_t *)&hopp->pam_msg_evt);
+    ((evtimer_event_t *)&hopp->pam_msg_evt)->offset = trickle_int;
+    evtimer_add_msg(&hopp->evtimer, &hopp->pam_msg_evt, hopp->pid);
+}
+
+/* length of the NDN TLV variable-length number n */
+static size_t hopp_ndntlv_varlen(size_t n)
+{
+    return (n < 253) ? 1 : ((n <= UINT16_MAX) ? 3 : 5);
+}
+
+/* length of a TLV with a single byte type and a value of len bytes */
+static size_t hopp_ndntlv_len(size_t len)
+{
+    return 1 + hopp_ndntlv_varlen(len) + len;
+}
+
+/* length of the data packet ccnl_ndntlv_prependContent() encodes for prefix
+ * and content_len bytes of content: an empty MetaInfo and a DigestSha256
+ * signature without value */
+static size_t hopp_ndntlv_data_len(const struct ccnl_prefix_s *prefix,
+                                   size_t content_len)
+{
+    size_t name_len = 0;
+
+    for (int i = 0; i < prefix->compcnt; i++) {
+        name_len += hopp_ndntlv_len(prefix->complen[i]);
+    }
+    return hopp_ndntlv_len(hopp_ndntlv_len(name_len) +
+                           hopp_ndntlv_len(0) +                 /* MetaInfo */
+                           hopp_ndntlv_len(content_len) +
+                           hopp_ndntlv_len(hopp_ndntlv_len(1)) + /* SignatureInfo */
+                           hopp_ndntlv_len(0));                 /* SignatureValue */
+}
+
+/* encodes the data packet into a buffer of its exact length and parses it
+ * with ccnl_ndntlv_bytes2pkt() like the "ccnl_cont" shell command does, so
+ * the packet is put together by CCN-lite itself. The buffer is not shared,
+ * so instances publish concurrently. */
+static struct ccnl_content_s *hopp_content_new(const compas_name_t *cname,
+                                               unsigned char *content,
+                                               size_t content_len)
+{
+    char prefix_n[COMPAS_NAME_LEN + 1];
+    memcpy(prefix_n, cname->name, cname->name_len);
+    prefix_n[cname->name_len] = '\0';
+    struct ccnl_prefix_s *prefix = ccnl_URItoPrefix(prefix_n, CCNL_SUITE_NDNTLV, NULL, NULL);
+    if (prefix == NULL) {
+        return NULL;
+    }
+    size_t buf_len = hopp_ndntlv_data_len(prefix, content_len);
+    unsigned char *buf = NULL;
+    if ((buf_len > CCNL_MAX_PACKET_SIZE) ||
+        ((buf = ccnl_malloc(buf_len)) == NULL)) {
+        ccnl_prefix_free(prefix);
+        return NULL;
+    }
+    int offs = buf_len;
+    int len = ccnl_ndntlv_prependContent(prefix, content, content_len,
+                                         NULL, NULL, &offs, buf);
+    ccnl_prefix_free(prefix);
+
+    struct ccnl_content_s *c = NULL;
+    unsigned char *data = buf + offs;
+    unsigned typ;
+    int tlv_len;
+    if ((len >= 0) &&
+        !ccnl_ndntlv_dehead(&data, &len, (int *) &typ, &tlv_len) &&
+        (typ == NDN_TLV_Data)) {
+        struct ccnl_pkt_s *pk = ccnl_ndntlv_bytes2pkt(typ, buf + offs, &data, &len);
+        if (pk != NULL) {
+            c = ccnl_content_new(&pk);
+            if (c == NULL) {
+                ccnl_pkt_free(pk);
+            }
+        }
+    }
+    ccnl_free(buf);
+    return c;
 }
 
-bool hopp_publish_content(const char *name, size_t name_len,
+bool hopp_publish_content(hopp_t *hopp, const char *name, size_t name_len,
                           unsigned char *content, size_t content_len)
 {
-    static compas_name_t cname;
+    compas_name_t cname;
     compas_name_init(&cname, name, name_len);
-    compas_nam_cache_entry_t *nce = compas_nam_cache_add(&dodag, &cname, NULL);
-
-    if (nce) {
-        nce->flags |= COMPAS_NAM_CACHE_FLAGS_REQUESTED;
-        static char prefix_n[COMPAS_NAME_LEN + 1];
-        memcpy(prefix_n, cname.name, cname.name_len);
-        prefix_n[cname.name_len] = '\0';
-        struct ccnl_prefix_s *prefix = ccnl_URItoPrefix(prefix_n, CCNL_SUITE_NDNTLV, NULL, NULL);
-        int offs = CCNL_MAX_PACKET_SIZE;
-        content_len = ccnl_ndntlv_prependContent(prefix, (unsigned char*) content, content_len, NULL, NULL, &offs, _out);
-        ccnl_prefix_free(prefix);
-        unsigned char *olddata;
-        unsigned char *data = olddata = _out + offs;
-        int len;
-        unsigned typ;
-        if (ccnl_ndntlv_dehead(&data, (int *)&content_len, (int*) &typ, &len) ||
-            typ != NDN_TLV_Data) {
-            return false;
+    bool fresh = (hopp_nce_find(hopp, &cname) == NULL);
+    compas_nam_cache_entry_t *nce = hopp_nce_add(hopp, &cname, NULL);
+
+    if (nce == NULL) {
+        return false;
+    }
+
+    struct ccnl_content_s *c = hopp_content_new(&cname, content, content_len);
+    if (c == NULL) {
+        if (fresh) {
+            hopp_nce_drop(hopp, nce);
         }
-        struct ccnl_pkt_s *pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, (int *)&content_len);
-        struct ccnl_content_s *c = ccnl_content_new(&pk);
+        return false;
+    }
 
-        msg_t ms = { .type = CCNL_MSG_ADD_CS, .content.ptr = c };
-        msg_send(&ms, _ccnl_event_loop_pid);
+    hopp_cs_add(cname.name, cname.name_len);
+    msg_t ms = { .type = CCNL_MSG_ADD_CS, .content.ptr = c };
+    msg_send(&ms, _ccnl_event_loop_pid);
 
-        msg_t msg = { .type = HOPP_NAM_MSG, .content.ptr = nce };
-        msg_try_send(&msg, hopp_pid);
+    hopp_nce_set_requested(hopp, nce);
+    msg_t msg = { .type = HOPP_NAM_MSG, .content.ptr = nce };
+    msg_try_send(&msg, hopp->pid);
 
-        return true;
+    return true;
+}
+
+size_t hopp_publish_contents(hopp_t *hopp, const hopp_publish_item_t *items,
+                             size_t items_numof)
+{
+    size_t i;
+
+    for (i = 0; i < items_numof; i++) {
+        compas_name_t cname;
+        compas_name_init(&cname, items[i].name, items[i].name_len);
+        /* the NAM cache entry comes first: a name that can not be announced
+         * must not end up in the content store filter */
+        bool fresh = (hopp_nce_find(hopp, &cname) == NULL);
+        compas_nam_cache_entry_t *nce = hopp_nce_add(hopp, &cname, NULL);
+        if (nce == NULL) {
+            break;
+        }
+
+        struct ccnl_content_s *c = hopp_content_new(&cname, items[i].content,
+                                                    items[i].content_len);
+        msg_t ms = { .type = CCNL_MSG_ADD_CS, .content.ptr = c };
+        if ((c == NULL) || (msg_try_send(&ms, _ccnl_event_loop_pid) != 1)) {
+            if (c != NULL) {
+                ccnl_content_free(c);
+            }
+            if (fresh) {
+                hopp_nce_drop(hopp, nce);
+            }
+            break;
+        }
+        hopp_cs_add(cname.name, cname.name_len);
+        hopp_nce_set_requested(hopp, nce);
     }
 
-    return false;
+    if (i > 0) {
+        /* one trigger announces all names published above */
+        msg_t msg = { .type = HOPP_NAM_TRIGGER_MSG };
+        msg_try_send(&msg, hopp->pid);
+    }
+
+    return i;
 }
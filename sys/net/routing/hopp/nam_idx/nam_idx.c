@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "hashes.h"
+
+#include "net/hopp/nam_idx.h"
+
+static inline uint16_t _tag(const compas_name_t *name)
+{
+    uint32_t hash = fnv_hash((const uint8_t *)name->name, name->name_len);
+
+    /* fold hash so the tag carries all bits; the home bucket is derived from
+     * the tag, so it never has to be recomputed from the name on deletion */
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+static inline uint16_t _home(const hopp_nam_idx_t *idx, uint16_t tag)
+{
+    return tag % idx->buckets_numof;
+}
+
+static inline uint16_t _next(const hopp_nam_idx_t *idx, uint16_t i)
+{
+    return (++i == idx->buckets_numof) ? 0 : i;
+}
+
+static inline bool _name_equal(const compas_name_t *a, const compas_name_t *b)
+{
+    return (a->name_len == b->name_len) &&
+           (memcmp(a->name, b->name, a->name_len) == 0);
+}
+
+void hopp_nam_idx_init(hopp_nam_idx_t *idx, hopp_nam_idx_bucket_t *buckets,
+                       uint16_t buckets_numof,
+                       compas_nam_cache_entry_t *cache, uint16_t cache_len)
+{
+    assert(buckets_numof > cache_len);
+    idx->buckets = buckets;
+    idx->buckets_numof = buckets_numof;
+    idx->cache = cache;
+    idx->cache_len = cache_len;
+    for (unsigned i = 0; i < buckets_numof; i++) {
+        buckets[i].slot = HOPP_NAM_IDX_EMPTY;
+    }
+}
+
+void hopp_nam_idx_rebuild(hopp_nam_idx_t *idx)
+{
+    hopp_nam_idx_init(idx, idx->buckets, idx->buckets_numof, idx->cache,
+                      idx->cache_len);
+    for (uint16_t slot = 0; slot < idx->cache_len; slot++) {
+        if (idx->cache[slot].in_use) {
+            hopp_nam_idx_add(idx, slot);
+        }
+    }
+}
+
+int hopp_nam_idx_add(hopp_nam_idx_t *idx, uint16_t slot)
+{
+    assert(slot < idx->cache_len);
+    uint16_t tag = _tag(&idx->cache[slot].name);
+    uint16_t i = _home(idx, tag);
+
+    for (unsigned probes = 0; probes < idx->buckets_numof; probes++) {
+        if (idx->buckets[i].slot == HOPP_NAM_IDX_EMPTY) {
+            idx->buckets[i].tag = tag;
+            idx->buckets[i].slot = slot;
+            return 0;
+        }
+        i = _next(idx, i);
+    }
+    return -ENOSPC;
+}
+
+void hopp_nam_idx_del(hopp_nam_idx_t *idx, uint16_t slot)
+{
+    assert(slot < idx->cache_len);
+    uint16_t i = _home(idx, _tag(&idx->cache[slot].name));
+    unsigned probes;
+
+    for (probes = 0; probes < idx->buckets_numof; probes++) {
+        if (idx->buckets[i].slot == slot) {
+            break;
+        }
+        if (idx->buckets[i].slot == HOPP_NAM_IDX_EMPTY) {
+            return;
+        }
+        i = _next(idx, i);
+    }
+    if (probes == idx->buckets_numof) {
+        return;
+    }
+    /* backward-shift deletion: move every following bucket of the cluster
+     * whose home is not between the gap and itself into the gap */
+    uint16_t j = i;
+    while (1) {
+        j = _next(idx, j);
+        if (idx->buckets[j].slot == HOPP_NAM_IDX_EMPTY) {
+            break;
+        }
+        uint16_t k = _home(idx, idx->buckets[j].tag);
+        if ((j > i) ? ((k <= i) || (k > j)) : ((k <= i) && (k > j))) {
+            idx->buckets[i] = idx->buckets[j];
+            i = j;
+        }
+    }
+    idx->buckets[i].slot = HOPP_NAM_IDX_EMPTY;
+}
+
+compas_nam_cache_entry_t *hopp_nam_idx_find(const hopp_nam_idx_t *idx,
+                                            const compas_name_t *name)
+{
+    uint16_t tag = _tag(name);
+    uint16_t i = _home(idx, tag);
+
+    for (unsigned probes = 0; probes < idx->buckets_numof; probes++) {
+        const hopp_nam_idx_bucket_t *b = &idx->buckets[i];
+
+        if (b->slot == HOPP_NAM_IDX_EMPTY) {
+            break;
+        }
+        if (b->tag == tag) {
+            compas_nam_cache_entry_t *nce = &idx->cache[b->slot];
+            if (nce->in_use && _name_equal(&nce->name, name)) {
+                return nce;
+            }
+        }
+        i = _next(idx, i);
+    }
+    return NULL;
+}
+
+/** @} */
@@ -1,6 +1,8 @@
 
 
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "div.h"
 #include "fmt.h"
@@ -47,12 +49,13 @@ uint32_t tx_data;
 uint32_t rx_interest;
 uint32_t rx_data;
 uint32_t netdev_evt_tx_noack;
-uint32_t tx_pam;
-uint32_t tx_nam;
-uint32_t tx_sol;
-uint32_t rx_nam;
-uint32_t rx_pam;
-uint32_t rx_sol;
+atomic_uint_least32_t tx_pam;
+atomic_uint_least32_t tx_nam;
+atomic_uint_least32_t tx_nam_names;
+atomic_uint_least32_t tx_sol;
+atomic_uint_least32_t rx_nam;
+atomic_uint_least32_t rx_pam;
+atomic_uint_least32_t rx_sol;
 
 #ifdef MODULE_GNRC_IPV6
 char pktcnt_addr_str[17];
@@ -76,7 +79,8 @@ void pktcnt_fast_print(void)
                     sizeof(&stats));
     printf("STATS;%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";"
       "%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";"
-      "%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32"\n",
+      "%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";%" PRIu32";"
+      "%" PRIu32"\n",
         retransmissions,
         tx_interest,
         tx_data,
@@ -90,12 +94,13 @@ void pktcnt_fast_print(void)
         stats->tx_success,
         stats->tx_failed,
         netdev_evt_tx_noack,
-        tx_pam,
-        tx_nam,
-        tx_sol,
-        rx_nam,
-        rx_pam,
-        rx_sol);
+        (uint32_t)atomic_load(&tx_pam),
+        (uint32_t)atomic_load(&tx_nam),
+        (uint32_t)atomic_load(&tx_sol),
+        (uint32_t)atomic_load(&rx_nam),
+        (uint32_t)atomic_load(&rx_pam),
+        (uint32_t)atomic_load(&rx_sol),
+        (uint32_t)atomic_load(&tx_nam_names));
 }
 
 void pktcnt_timer_init(void)
@@ -145,6 +150,65 @@ static void log_event(int type)
 
 static void _log_tx(gnrc_pktsnip_t *pkt);
 
+#ifdef MODULE_PKTCNT_BIN
+/* record of the packet currently logged by the pktcnt thread */
+static pktcnt_bin_rec_t rec;
+
+static void bin_start(uint8_t type, uint16_t size)
+{
+    memset(&rec, 0, offsetof(pktcnt_bin_rec_t, data));
+    rec.type = type;
+    rec.time = xtimer_now_usec64();
+    rec.size = size;
+}
+
+static void bin_add_addr(uint8_t *len, const uint8_t *addr, size_t addr_len)
+{
+    if (addr_len > PKTCNT_BIN_ADDR_MAX) {
+        addr_len = PKTCNT_BIN_ADDR_MAX;
+    }
+    memcpy(&rec.data[rec.src_len + rec.dst_len], addr, addr_len);
+    *len = addr_len;
+}
+
+static void bin_add_name(const char *name, size_t name_len)
+{
+    size_t free = PKTCNT_BIN_NAME_MAX - rec.name_len;
+
+    if (name_len > free) {
+        name_len = free;
+    }
+    memcpy(&rec.data[rec.src_len + rec.dst_len + rec.name_len], name, name_len);
+    rec.name_len += name_len;
+}
+
+static void bin_proto(uint8_t proto)
+{
+    rec.proto = proto;
+    pktcnt_bin_write(&rec);
+}
+#endif
+
+static void log_unknown(void)
+{
+#ifdef MODULE_PKTCNT_BIN
+    bin_proto(PKTCNT_BIN_PROTO_UNKNOWN);
+#else
+    puts("UNKNOWN");
+#endif
+}
+
+#ifdef MODULE_GNRC_SIXLOWPAN
+static void log_nfrag(void)
+{
+#ifdef MODULE_PKTCNT_BIN
+    bin_proto(PKTCNT_BIN_PROTO_NFRAG);
+#else
+    puts("6Lo n-frag");
+#endif
+}
+#endif
+
 static void *pktcnt_thread(void *args)
 {
     (void)args;
@@ -187,6 +251,11 @@ int pktcnt_init(void)
         log_event(TYPE_STARTUP);
         puts("");
 
+#ifdef MODULE_PKTCNT_BIN
+        if (pktcnt_bin_init() != PKTCNT_OK) {
+            return PKTCNT_ERR_INIT;
+        }
+#endif
         if ((pktcnt_pid = thread_create(pktcnt_stack, sizeof(pktcnt_stack),
                                         PKTCNT_PRIO, THREAD_CREATE_STACKTEST,
                                         pktcnt_thread, NULL, "pktcnt")) < 0) {
@@ -208,8 +277,16 @@ void pktcnt_timer_init(void)
 
 static void log_l2_rx(gnrc_pktsnip_t *pkt)
 {
-    char addr_str[24];
     gnrc_netif_hdr_t *netif_hdr = pkt->next->data;
+#ifdef MODULE_PKTCNT_BIN
+    bin_start(PKTCNT_BIN_PKT_RX, pkt->size);
+    bin_add_addr(&rec.src_len, gnrc_netif_hdr_get_src_addr(netif_hdr),
+                 netif_hdr->src_l2addr_len);
+    bin_add_addr(&rec.dst_len, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                 netif_hdr->dst_l2addr_len);
+    rec.seq = netif_hdr->seq;
+#else
+    char addr_str[24];
 
     log_event(TYPE_PKT_RX);
     printf("%s ", gnrc_netif_addr_to_str(gnrc_netif_hdr_get_src_addr(netif_hdr),
@@ -218,12 +295,24 @@ static void log_l2_rx(gnrc_pktsnip_t *pkt)
                                          netif_hdr->dst_l2addr_len, addr_str));
     printf("seq=%u ", (unsigned)netif_hdr->seq);
     printf("%u ", (unsigned)pkt->size);
+#endif
 }
 
 static void log_l2_tx(gnrc_pktsnip_t *pkt)
 {
-    char addr_str[24];
     gnrc_netif_hdr_t *netif_hdr = pkt->data;
+#ifdef MODULE_PKTCNT_BIN
+    bin_start(PKTCNT_BIN_PKT_TX, gnrc_pkt_len(pkt->next));
+    if (netif_hdr->flags &
+        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
+        rec.flags |= PKTCNT_BIN_FLAG_BCAST;
+    }
+    else {
+        bin_add_addr(&rec.dst_len, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                     netif_hdr->dst_l2addr_len);
+    }
+#else
+    char addr_str[24];
 
     log_event(TYPE_PKT_TX);
     printf("%s ", ctx.id);
@@ -236,6 +325,7 @@ static void log_l2_tx(gnrc_pktsnip_t *pkt)
                                              netif_hdr->dst_l2addr_len, addr_str));
     }
     printf("%u ", (unsigned)gnrc_pkt_len(pkt->next));
+#endif
 }
 
 #ifdef MODULE_CCN_LITE
@@ -246,7 +336,12 @@ static void log_name(uint8_t *payload, unsigned len)
     while (i < len) {
         if (payload[i] == 0x08) {
             unsigned complen = payload[i+1];
+#ifdef MODULE_PKTCNT_BIN
+            bin_add_name("/", 1);
+            bin_add_name((char *)&payload[i+2], complen);
+#else
             printf("/%.*s", complen, (char *)&payload[i+2]);
+#endif
             i += complen + 2;
         }
         else {
@@ -260,7 +355,11 @@ static void log_name(uint8_t *payload, unsigned len)
 static void log_ndn(uint8_t *payload)
 {
     /* print type */
+#ifdef MODULE_PKTCNT_BIN
+    rec.code = payload[0];
+#else
     printf("NDN %02x ", payload[0]);
+#endif
 
     unsigned pkttype = payload[0];
     (void) pkttype;
@@ -292,7 +391,11 @@ static void log_ndn(uint8_t *payload)
         }
     }
 
+#ifdef MODULE_PKTCNT_BIN
+    bin_proto(PKTCNT_BIN_PROTO_NDN);
+#else
     printf("\n");
+#endif
 }
 
 static void log_hopp(uint8_t *payload)
@@ -302,6 +405,19 @@ static void log_hopp(uint8_t *payload)
      * 0xC1: NAM
      * 0xC2: SOL
      */
+#ifdef MODULE_PKTCNT_BIN
+    rec.code = payload[2];
+    if (payload[2] == 0xC0) {
+        rec.id = (uint16_t)(payload[6] << 8) | (payload[5] & 0xFF);
+        rec.flags |= PKTCNT_BIN_FLAG_ID;
+    }
+    else if ((payload[2] == 0xC1) && (payload[4] == 0X00)) {
+        uint16_t nam_len = (uint16_t)(payload[6] << 8) | (payload[5] & 0xFF);
+        bin_add_name((char *)&payload[7], nam_len);
+    }
+    bin_proto(PKTCNT_BIN_PROTO_HOPP);
+    return;
+#endif
     printf("HOPP %02x ", payload[2]);
 
     /* print rank for PAM */
@@ -331,8 +447,15 @@ static unsigned _code_detail(uint8_t code)
 static void log_coap(uint8_t *payload)
 {
     uint8_t code = payload[1];
+#ifdef MODULE_PKTCNT_BIN
+    rec.code = code;
+    rec.id = (((uint16_t)payload[2]) << 8) | (payload[3]);
+    rec.flags |= PKTCNT_BIN_FLAG_ID;
+    bin_proto(PKTCNT_BIN_PROTO_COAP);
+#else
     printf("CoAP %u.%02u %u\n", _code_class(code), _code_detail(code),
            (((uint16_t)payload[2]) << 8) | (payload[3]));
+#endif
 }
 
 static void log_mqtt(uint8_t *payload)
@@ -361,10 +484,22 @@ static void log_mqtt(uint8_t *payload)
             msgid = (((uint16_t)payload[type_offset + 4]) << 8) | payload[type_offset + 5];
             break;
         default:
+#ifdef MODULE_PKTCNT_BIN
+            rec.code = type;
+            bin_proto(PKTCNT_BIN_PROTO_MQTT);
+#else
             printf("MQTT %02x\n", type);
+#endif
             return;
     }
+#ifdef MODULE_PKTCNT_BIN
+    rec.code = type;
+    rec.id = msgid;
+    rec.flags |= PKTCNT_BIN_FLAG_ID;
+    bin_proto(PKTCNT_BIN_PROTO_MQTT);
+#else
     printf("MQTT %02x %u\n", type, msgid);
+#endif
 }
 
 static bool demux_udp_port(uint8_t *payload, uint16_t port)
@@ -387,17 +522,34 @@ static void log_udp(uint8_t *payload, uint16_t src_port, uint16_t dst_port)
 {
     if (!demux_udp_port(payload, dst_port) &&
         !demux_udp_port(payload, src_port)) {
+#ifdef MODULE_PKTCNT_BIN
+        rec.id = src_port;
+        rec.id2 = dst_port;
+        bin_proto(PKTCNT_BIN_PROTO_UDP);
+#else
         printf("UDP %u:%u\n", src_port, dst_port);
+#endif
     }
 }
 
 static void log_icmpv6(icmpv6_hdr_t *hdr)
 {
+#ifdef MODULE_PKTCNT_BIN
+    rec.code = hdr->type;
+    rec.code2 = hdr->code;
+    bin_proto(PKTCNT_BIN_PROTO_ICMPV6);
+#else
     printf("ICMPv6 %u(%u)\n", hdr->type, hdr->code);
+#endif
 }
 
 static void log_flow(char *src, char *dst)
 {
+#ifdef MODULE_PKTCNT_BIN
+    /* addresses are not part of binary records */
+    src[0] = '\0';
+    dst[0] = '\0';
+#else
     if (src[0] != '\0') {
         printf("src=%s ", src);
         src[0] = '\0';
@@ -406,6 +558,7 @@ static void log_flow(char *src, char *dst)
         printf("dst=%s ", dst);
         dst[0] = '\0';
     }
+#endif
 }
 #endif
 
@@ -644,7 +797,7 @@ void pktcnt_log_rx(gnrc_pktsnip_t *pkt)
 
         if ((payload[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_N_DISP) {
             log_l2_rx(pkt);
-            puts("6Lo n-frag");
+            log_nfrag();
             return;
         }
         offset = get_from_sixlo_dispatch(payload, &protnum, src, dst,
@@ -676,7 +829,7 @@ void pktcnt_log_rx(gnrc_pktsnip_t *pkt)
             default:
                 log_l2_rx(pkt);
                 log_flow(src, dst);
-                puts("UNKNOWN");
+                log_unknown();
                 break;
         }
     }
@@ -707,7 +860,7 @@ void pktcnt_log_rx(gnrc_pktsnip_t *pkt)
             default:
                 log_l2_rx(pkt);
                 log_flow(src, dst);
-                puts("UNKNOWN");
+                log_unknown();
                 break;
 
         }
@@ -729,7 +882,7 @@ void pktcnt_log_rx(gnrc_pktsnip_t *pkt)
         }
         else {
             log_l2_rx(pkt);
-            puts("UNKNOWN");
+            log_unknown();
         }
     }
 #endif
@@ -829,7 +982,7 @@ static void _log_tx(gnrc_pktsnip_t *pkt)
                     }
 #endif
                     log_l2_tx(pkt);
-                    puts("UNKNOWN");
+                    log_unknown();
                     break;
                 }
             }
@@ -837,7 +990,7 @@ static void _log_tx(gnrc_pktsnip_t *pkt)
 #ifdef MODULE_GNRC_SIXLOWPAN
         else {
             log_l2_tx(pkt);
-            puts("6Lo n-frag");
+            log_nfrag();
         }
 #endif
     }
@@ -864,7 +1017,7 @@ static void _log_tx(gnrc_pktsnip_t *pkt)
         }
         else {
             log_l2_tx(pkt);
-            puts("UNKNOWN");
+            log_unknown();
         }
     }
 #endif
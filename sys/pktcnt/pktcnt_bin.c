@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifdef MODULE_PKTCNT_BIN
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fmt.h"
+#include "irq.h"
+#include "mutex.h"
+#include "pktcnt.h"
+#include "thread.h"
+#include "tsrb.h"
+
+#define LINE_PREFIX     "PKTB "
+
+uint32_t pktcnt_bin_lost;
+
+static char _buf[PKTCNT_BIN_BUFSIZE];
+static tsrb_t _rb = TSRB_INIT(_buf);
+/* binary semaphore signalling the drain thread */
+static mutex_t _ready = MUTEX_INIT_LOCKED;
+static char _stack[PKTCNT_BIN_STACKSIZE];
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+
+void pktcnt_bin_write(pktcnt_bin_rec_t *rec)
+{
+    unsigned state;
+
+    rec->len = offsetof(pktcnt_bin_rec_t, data) + rec->src_len +
+               rec->dst_len + rec->name_len;
+    /* several threads log, so add the whole record at once */
+    state = irq_disable();
+    if (tsrb_free(&_rb) >= rec->len) {
+        tsrb_add(&_rb, (char *)rec, rec->len);
+    }
+    else {
+        pktcnt_bin_lost++;
+    }
+    irq_restore(state);
+    mutex_unlock(&_ready);
+}
+
+static void *_drain_thread(void *args)
+{
+    uint8_t rec[sizeof(pktcnt_bin_rec_t)];
+    char line[sizeof(LINE_PREFIX) + (2 * sizeof(rec))];
+    uint32_t lost = 0;
+    int len;
+
+    (void)args;
+    memcpy(line, LINE_PREFIX, sizeof(LINE_PREFIX) - 1);
+    while (1) {
+        mutex_lock(&_ready);
+        while ((len = tsrb_get_one(&_rb)) > 0) {
+            size_t line_len = sizeof(LINE_PREFIX) - 1;
+
+            rec[0] = len;
+            tsrb_get(&_rb, (char *)&rec[1], len - 1);
+            line_len += fmt_bytes_hex(&line[line_len], rec, len);
+            line[line_len++] = '\n';
+            print(line, line_len);
+        }
+        if (lost != pktcnt_bin_lost) {
+            lost = pktcnt_bin_lost;
+            print_str("PKTB-LOST ");
+            print_u32_dec(lost);
+            print_str("\n");
+        }
+    }
+    return NULL;
+}
+
+int pktcnt_bin_init(void)
+{
+    if (_pid <= KERNEL_PID_UNDEF) {
+        _pid = thread_create(_stack, sizeof(_stack), PKTCNT_BIN_PRIO,
+                             THREAD_CREATE_STACKTEST, _drain_thread, NULL,
+                             "pktcnt_bin");
+    }
+    return (_pid > KERNEL_PID_UNDEF) ? PKTCNT_OK : PKTCNT_ERR_INIT;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif
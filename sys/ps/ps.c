@@ -15,17 +15,23 @@
  * @}
  */
 
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "thread.h"
 #include "sched.h"
 #include "thread.h"
 #include "kernel_types.h"
 
-#ifdef MODULE_SCHEDSTATISTICS
+#if defined(MODULE_SCHEDSTATISTICS) || defined(MODULE_XTIMER_TICKLESS)
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_SCHEDPROF
+#include "irq.h"
+#endif
+
 #ifdef MODULE_TLSF
 #include "tlsf.h"
 #endif
@@ -149,4 +155,77 @@ void ps(void)
     tlsf_walk_pool(NULL);
 #   endif
 #endif
+#ifdef MODULE_XTIMER_TICKLESS
+    xtimer_wakeups_t wakeups;
+
+    xtimer_get_wakeups(&wakeups);
+    printf("\nWakeups: idle %" PRIu32 ", xtimer %" PRIu32 " (timer %" PRIu32
+           ", period %" PRIu32 ", period ticks skipped %" PRIu32 ")\n",
+           sched_idle_wakeups, wakeups.timer + wakeups.period, wakeups.timer,
+           wakeups.period, wakeups.skipped);
+#endif
 }
+
+#ifdef MODULE_SCHEDPROF
+static void _print_hist(const char *title, bool latency)
+{
+    printf("\n%s (us)\n\tpid | "
+#ifdef DEVELHELP
+           "%-21s| "
+#endif
+           "  <16   <64  <256   <1k   <4k  <16k  <64k  more |        max"
+#ifdef DEVELHELP
+           " | stack used"
+#endif
+           "\n", title
+#ifdef DEVELHELP
+           , "name"
+#endif
+          );
+    for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+        thread_t *p = (thread_t *)sched_threads[i];
+        const schedprof_t *prof = &sched_pidlist[i].prof;
+        const uint16_t *hist = (latency) ? prof->latency : prof->slice;
+
+        if (p == NULL) {
+            continue;
+        }
+        printf("\t%3" PRIkernel_pid " | ", p->pid);
+#ifdef DEVELHELP
+        printf("%-20s | ", p->name);
+#endif
+        for (unsigned b = 0; b < SCHEDPROF_BUCKETS; b++) {
+            printf("%5u ", (unsigned)hist[b]);
+        }
+        printf("| %10" PRIu32, (latency) ? prof->latency_max : prof->slice_max);
+#ifdef DEVELHELP
+        /* high-water mark of the stack since the thread was created */
+        printf(" | %10i", p->stack_size -
+               (int)thread_measure_stack_free(p->stack_start));
+#endif
+        puts("");
+    }
+}
+
+void ps_profile(void)
+{
+    _print_hist("wakeup-to-run latency", true);
+    _print_hist("uninterrupted runs", false);
+}
+
+void ps_profile_reset(void)
+{
+    unsigned state = irq_disable();
+
+    for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+        schedprof_t *prof = &sched_pidlist[i].prof;
+
+        /* a thread waiting to run right now still has its latency recorded */
+        memset(prof->latency, 0, sizeof(prof->latency));
+        memset(prof->slice, 0, sizeof(prof->slice));
+        prof->latency_max = 0;
+        prof->slice_max = 0;
+    }
+    irq_restore(state);
+}
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/pkttrace.h"
+
+int _gnrc_pkttrace(int argc, char **argv)
+{
+    if (argc < 2) {
+        gnrc_pkttrace_print();
+        return 0;
+    }
+    else if (strcmp(argv[1], "reset") == 0) {
+        gnrc_pkttrace_reset();
+        return 0;
+    }
+    printf("usage: %s [reset]\n", argv[0]);
+    return 1;
+}
+
+/** @} */
@@ -18,12 +18,31 @@
  * @}
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include "ps.h"
 
 int _ps_handler(int argc, char **argv)
 {
+#ifdef MODULE_SCHEDPROF
+    if (argc > 1) {
+        if (strcmp(argv[1], "-l") == 0) {
+            ps_profile();
+        }
+        else if (strcmp(argv[1], "-c") == 0) {
+            ps_profile_reset();
+        }
+        else {
+            printf("usage: %s [-l|-c]\n", argv[0]);
+            return 1;
+        }
+        return 0;
+    }
+#else
     (void) argc;
     (void) argv;
+#endif
 
     ps();
 
@@ -91,6 +91,10 @@ extern int _gnrc_netif_send(int argc, char **argv);
 #endif
 #endif
 
+#ifdef MODULE_GNRC_PKTTRACE
+extern int _gnrc_pkttrace(int argc, char **argv);
+#endif
+
 #ifdef MODULE_FIB
 extern int _fib_route_handler(int argc, char **argv);
 #endif
@@ -190,6 +194,9 @@ const shell_command_t _shell_command_list[] = {
     {"txtsnd", "Sends a custom string as is over the link layer", _gnrc_netif_send },
 #endif
 #endif
+#ifdef MODULE_GNRC_PKTTRACE
+    {"pkttrace", "Show packet latency per layer ('pkttrace [reset]')", _gnrc_pkttrace },
+#endif
 #ifdef MODULE_FIB
     {"fibroute", "Manipulate the FIB (info: 'fibroute [add|del]')", _fib_route_handler},
 #endif
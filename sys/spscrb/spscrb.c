@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_spscrb
+ * @{
+ *
+ * @file
+ * @brief       Single-producer single-consumer ringbuffer implementation
+ *
+ * The counters run freely and are only masked when indexing the buffer, so
+ * a full buffer can be told apart from an empty one without wasting an
+ * element. Data is accessed before the counter of the own side is stored
+ * with release semantics, the counter of the other side is loaded with
+ * acquire semantics.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "spscrb.h"
+
+static inline uint8_t *_elem(const spscrb_t *rb, unsigned cnt)
+{
+    return (uint8_t *)rb->buf + ((cnt & (rb->size - 1)) * rb->elem_size);
+}
+
+/* number of elements from cnt up to the end of the buffer */
+static inline unsigned _to_end(const spscrb_t *rb, unsigned cnt)
+{
+    return rb->size - (cnt & (rb->size - 1));
+}
+
+/* single bytes are the common case of an UART, these avoid memcpy() and
+ * function calls for them */
+int spscrb_add_one(spscrb_t *rb, const void *elem)
+{
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_relaxed);
+    unsigned reads = atomic_load_explicit(&rb->reads, memory_order_acquire);
+    size_t size = rb->elem_size;
+    uint8_t *dst;
+
+    if ((writes - reads) == rb->size) {
+        return -1;
+    }
+    dst = (uint8_t *)rb->buf + ((writes & (rb->size - 1)) * size);
+    if (size == 1) {
+        *dst = *(const uint8_t *)elem;
+    }
+    else {
+        memcpy(dst, elem, size);
+    }
+    atomic_store_explicit(&rb->writes, writes + 1, memory_order_release);
+    return 0;
+}
+
+int spscrb_get_one(spscrb_t *rb, void *elem)
+{
+    unsigned reads = atomic_load_explicit(&rb->reads, memory_order_relaxed);
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_acquire);
+    size_t size = rb->elem_size;
+    const uint8_t *src;
+
+    if (writes == reads) {
+        return -1;
+    }
+    src = (const uint8_t *)rb->buf + ((reads & (rb->size - 1)) * size);
+    if (size == 1) {
+        *(uint8_t *)elem = *src;
+    }
+    else {
+        memcpy(elem, src, size);
+    }
+    atomic_store_explicit(&rb->reads, reads + 1, memory_order_release);
+    return 0;
+}
+
+unsigned spscrb_add(spscrb_t *rb, const void *src, unsigned n)
+{
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_relaxed);
+    unsigned free = spscrb_free(rb);
+    unsigned first;
+
+    if (n > free) {
+        n = free;
+    }
+    first = _to_end(rb, writes);
+    if (first > n) {
+        first = n;
+    }
+    memcpy(_elem(rb, writes), src, first * rb->elem_size);
+    if (n > first) {
+        memcpy(rb->buf, (const uint8_t *)src + (first * rb->elem_size),
+               (n - first) * rb->elem_size);
+    }
+    atomic_store_explicit(&rb->writes, writes + n, memory_order_release);
+    return n;
+}
+
+unsigned spscrb_get(spscrb_t *rb, void *dst, unsigned n)
+{
+    unsigned reads = atomic_load_explicit(&rb->reads, memory_order_relaxed);
+    unsigned avail = spscrb_avail(rb);
+    unsigned first;
+
+    if (n > avail) {
+        n = avail;
+    }
+    first = _to_end(rb, reads);
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, _elem(rb, reads), first * rb->elem_size);
+    if (n > first) {
+        memcpy((uint8_t *)dst + (first * rb->elem_size), rb->buf,
+               (n - first) * rb->elem_size);
+    }
+    atomic_store_explicit(&rb->reads, reads + n, memory_order_release);
+    return n;
+}
+
+void *spscrb_reserve(spscrb_t *rb, unsigned *n)
+{
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_relaxed);
+    unsigned free = spscrb_free(rb);
+
+    *n = _to_end(rb, writes);
+    if (*n > free) {
+        *n = free;
+    }
+    return (*n) ? _elem(rb, writes) : NULL;
+}
+
+void spscrb_commit(spscrb_t *rb, unsigned n)
+{
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_relaxed);
+
+    assert(n <= spscrb_free(rb));
+    atomic_store_explicit(&rb->writes, writes + n, memory_order_release);
+}
+
+const void *spscrb_peek(spscrb_t *rb, unsigned *n)
+{
+    unsigned reads = atomic_load_explicit(&rb->reads, memory_order_relaxed);
+    unsigned avail = spscrb_avail(rb);
+
+    *n = _to_end(rb, reads);
+    if (*n > avail) {
+        *n = avail;
+    }
+    return (*n) ? _elem(rb, reads) : NULL;
+}
+
+void spscrb_consume(spscrb_t *rb, unsigned n)
+{
+    unsigned reads = atomic_load_explicit(&rb->reads, memory_order_relaxed);
+
+    assert(n <= spscrb_avail(rb));
+    atomic_store_explicit(&rb->reads, reads + n, memory_order_release);
+}
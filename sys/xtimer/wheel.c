@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_xtimer
+ * @{
+ *
+ * @file
+ * @brief       xtimer backend based on a hierarchical timer wheel
+ *
+ * Level 0 of the wheel has one slot per tick, the slots of every level above
+ * are as wide as all slots of the level below together. A timer is put into
+ * the lowest level that reaches its target. Once the wheel arrives at the
+ * slot of a timer in an upper level, the timer is moved down. Setting a
+ * timer thus doesn't depend on the number of timers set, removing one only
+ * walks the timers that share its slot.
+ *
+ * A timer only records the index of its slot. Whether it is set is decided by
+ * finding it in that slot, so the fields of a timer that was never set may
+ * hold anything.
+ *
+ * The time is kept as 64 bit tick count. Periods of the low-level timer are
+ * counted by comparing each reading with the previous one, the low-level
+ * timer is set to the end of the period at the latest to not miss one.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include "board.h"
+#include "periph/timer.h"
+#include "periph_conf.h"
+
+#include "bitarithm.h"
+#include "irq.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#ifdef MODULE_XTIMER_TICKLESS
+#error "xtimer_tickless is not supported by xtimer_wheel"
+#endif
+
+#if XTIMER_WHEEL_SLOT_BITS > 4
+#error "XTIMER_WHEEL_SLOT_BITS must not exceed 4"
+#endif
+
+#define SLOTS           (1U << XTIMER_WHEEL_SLOT_BITS)
+#define SLOT_MASK       (SLOTS - 1)
+
+/* slot index of the timers in the list of expired timers */
+#define SLOT_EXPIRED    (XTIMER_WHEEL_LEVELS * SLOTS)
+
+/* number of ticks in one period of the low-level timer */
+#define PERIOD          ((uint64_t)(uint32_t)~XTIMER_MASK + 1)
+
+/* minimum distance to the current time when setting the low-level timer */
+#if XTIMER_ISR_BACKOFF > 0
+#define MIN_AHEAD       (XTIMER_ISR_BACKOFF)
+#else
+#define MIN_AHEAD       (1)
+#endif
+
+#if XTIMER_MASK
+volatile uint32_t _xtimer_high_cnt = 0;
+#endif
+
+static volatile int _in_handler = 0;
+
+static xtimer_t *_wheel[XTIMER_WHEEL_LEVELS][SLOTS];
+static uint16_t _bitmap[XTIMER_WHEEL_LEVELS];
+/* expired timers that are about to be fired */
+static xtimer_t *_expired = NULL;
+
+/* the slots before this time are processed */
+static uint64_t _wheel_time = 0;
+static uint64_t _period_start = 0;
+static uint32_t _last = 0;
+
+static void _periph_timer_callback(void *arg, int chan);
+
+static inline uint64_t _target(xtimer_t *timer)
+{
+    return ((uint64_t)timer->long_target << 32) | timer->target;
+}
+
+static inline unsigned _shift(unsigned level)
+{
+    return level * XTIMER_WHEEL_SLOT_BITS;
+}
+
+static inline void xtimer_spin_until(uint32_t target) {
+#if XTIMER_MASK
+    target = _xtimer_lltimer_mask(target);
+#endif
+    while (_xtimer_lltimer_now() > target);
+    while (_xtimer_lltimer_now() < target);
+}
+
+/**
+ * @brief   get the current time, advancing the period if the low-level timer
+ *          wrapped
+ *
+ * Must be called with interrupts disabled.
+ */
+static uint64_t _now(void)
+{
+    uint32_t now = _xtimer_lltimer_now();
+
+    if (now < _last) {
+        _period_start += PERIOD;
+#if XTIMER_MASK
+        _xtimer_high_cnt = (uint32_t)_period_start;
+#endif
+    }
+    _last = now;
+    return _period_start + now;
+}
+
+/**
+ * @brief   find the link pointing to a timer
+ *
+ * Only the slot index of the timer is read, and only to pick the list to
+ * search, so the timer may be uninitialized.
+ *
+ * @return  NULL if the timer is not set
+ */
+static xtimer_t **_find(xtimer_t *timer)
+{
+    unsigned idx = timer->slot;
+    xtimer_t **link;
+
+    if (idx == SLOT_EXPIRED) {
+        link = &_expired;
+    }
+    else if (idx < SLOT_EXPIRED) {
+        link = &_wheel[0][0] + idx;
+    }
+    else {
+        return NULL;
+    }
+    while (*link && (*link != timer)) {
+        link = &(*link)->next;
+    }
+    return *link ? link : NULL;
+}
+
+/**
+ * @brief   unlink a timer from its slot
+ *
+ * @return  0 if the timer was not set
+ */
+static int _unlink(xtimer_t *timer)
+{
+    xtimer_t **link = _find(timer);
+    unsigned idx = timer->slot;
+
+    if (!link) {
+        return 0;
+    }
+    *link = timer->next;
+    if ((idx != SLOT_EXPIRED) && !(&_wheel[0][0])[idx]) {
+        /* the slot ran empty */
+        _bitmap[idx / SLOTS] &= ~(1U << (idx & SLOT_MASK));
+    }
+    return 1;
+}
+
+/**
+ * @brief   put a timer into the lowest level of the wheel that reaches its
+ *          target
+ */
+static void _place(xtimer_t *timer)
+{
+    uint64_t target = _target(timer);
+    unsigned level = 0;
+    unsigned slot;
+
+    if (target < _wheel_time) {
+        target = _wheel_time;
+    }
+    while (((target >> _shift(level)) - (_wheel_time >> _shift(level))) >= SLOTS) {
+        if (++level == XTIMER_WHEEL_LEVELS) {
+            /* beyond the wheel: park in the last slot of the top level and
+             * place again from there */
+            level--;
+            target = ((_wheel_time >> _shift(level)) + SLOT_MASK) << _shift(level);
+            break;
+        }
+    }
+    slot = (target >> _shift(level)) & SLOT_MASK;
+    timer->next = _wheel[level][slot];
+    timer->slot = (level * SLOTS) + slot;
+    _wheel[level][slot] = timer;
+    _bitmap[level] |= (1U << slot);
+}
+
+/**
+ * @brief   get the start of the next slot with timers in it
+ *
+ * @return  UINT64_MAX if no timer is set
+ */
+static uint64_t _next_event(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (unsigned level = 0; level < XTIMER_WHEEL_LEVELS; level++) {
+        uint64_t cur, event;
+        uint32_t map;
+
+        if (!_bitmap[level]) {
+            continue;
+        }
+        cur = _wheel_time >> _shift(level);
+        /* rotate the bitmap, so the current slot is the lowest bit */
+        map = _bitmap[level] | ((uint32_t)_bitmap[level] << SLOTS);
+        map >>= (cur & SLOT_MASK);
+        map &= (1UL << SLOTS) - 1;
+        event = (cur + bitarithm_lsb((unsigned)map)) << _shift(level);
+        if (event < _wheel_time) {
+            /* the current slot of an upper level, which started before */
+            event = _wheel_time;
+        }
+        if (event < next) {
+            next = event;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief   move the timers of the current slots of the upper levels down and
+ *          fire the timers of the current slot of level 0
+ */
+static void _expire(void)
+{
+    unsigned slot;
+
+    for (unsigned level = XTIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        xtimer_t *timer;
+
+        slot = (_wheel_time >> _shift(level)) & SLOT_MASK;
+        timer = _wheel[level][slot];
+        _wheel[level][slot] = NULL;
+        _bitmap[level] &= ~(1U << slot);
+        while (timer) {
+            xtimer_t *next = timer->next;
+
+            _place(timer);
+            timer = next;
+        }
+    }
+
+    slot = _wheel_time & SLOT_MASK;
+    if (!_wheel[0][slot]) {
+        return;
+    }
+    /* keep the expired timers linked, so callbacks can remove them */
+    _expired = _wheel[0][slot];
+    _wheel[0][slot] = NULL;
+    _bitmap[0] &= ~(1U << slot);
+    for (xtimer_t *timer = _expired; timer; timer = timer->next) {
+        timer->slot = SLOT_EXPIRED;
+    }
+    while (_expired) {
+        xtimer_t *timer = _expired;
+
+        _expired = timer->next;
+        /* make sure timer is recognized as being already fired */
+        timer->target = 0;
+        timer->long_target = 0;
+        timer->callback(timer->arg);
+    }
+}
+
+/**
+ * @brief   set the low-level timer to the next slot with timers in it, or to
+ *          the end of the current period if that comes first
+ */
+static void _lltimer_set(void)
+{
+    uint64_t now, target, end;
+
+    if (_in_handler) {
+        return;
+    }
+    now = _now();
+    target = _next_event();
+    end = _period_start + PERIOD - 1;
+    if ((target - now) > XTIMER_OVERHEAD) {
+        target -= XTIMER_OVERHEAD;
+    }
+    if (target > end) {
+        target = end;
+    }
+    if (target < (now + MIN_AHEAD)) {
+        target = now + MIN_AHEAD;
+    }
+    DEBUG("_lltimer_set(): setting %" PRIu32 "\n",
+          _xtimer_lltimer_mask((uint32_t)target));
+    timer_set_absolute(XTIMER_DEV, XTIMER_CHAN,
+                       _xtimer_lltimer_mask((uint32_t)target));
+}
+
+static void _add(xtimer_t *timer, uint64_t now)
+{
+    if (!_in_handler && (_next_event() > now)) {
+        /* nothing expired in between, catch up with the current time to not
+         * place the timer too high */
+        _wheel_time = now;
+    }
+    _place(timer);
+    _lltimer_set();
+}
+
+static void _remove(xtimer_t *timer)
+{
+    if (_unlink(timer)) {
+        timer->target = 0;
+        timer->long_target = 0;
+    }
+}
+
+void xtimer_init(void)
+{
+    /* initialize low-level timer */
+    timer_init(XTIMER_DEV, XTIMER_HZ, _periph_timer_callback, NULL);
+
+    unsigned state = irq_disable();
+    _lltimer_set();
+    irq_restore(state);
+}
+
+uint64_t _xtimer_now64(void)
+{
+    unsigned state = irq_disable();
+    uint64_t now = _now();
+
+    irq_restore(state);
+    return now;
+}
+
+void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
+{
+    DEBUG(" _xtimer_set64() offset=%" PRIu32 " long_offset=%" PRIu32 "\n", offset, long_offset);
+    if (!long_offset) {
+        /* timer fits into the short timer */
+        _xtimer_set(timer, (uint32_t) offset);
+    }
+    else {
+        unsigned state = irq_disable();
+        uint64_t now = _now();
+        uint64_t target = now + (((uint64_t)long_offset << 32) | offset);
+
+        _remove(timer);
+        timer->target = (uint32_t)target;
+        timer->long_target = target >> 32;
+        _add(timer, now);
+        irq_restore(state);
+    }
+}
+
+void _xtimer_set(xtimer_t *timer, uint32_t offset)
+{
+    DEBUG("timer_set(): offset=%" PRIu32 " now=%" PRIu32 " (%" PRIu32 ")\n",
+          offset, xtimer_now().ticks32, _xtimer_lltimer_now());
+    if (!timer->callback) {
+        DEBUG("timer_set(): timer has no callback.\n");
+        return;
+    }
+
+    xtimer_remove(timer);
+
+    if (offset < XTIMER_BACKOFF) {
+        _xtimer_spin(offset);
+        timer->callback(timer->arg);
+    }
+    else {
+        uint32_t target = _xtimer_now() + offset;
+        _xtimer_set_absolute(timer, target);
+    }
+}
+
+int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
+{
+    uint32_t now = _xtimer_now();
+
+    DEBUG("timer_set_absolute(): now=%" PRIu32 " target=%" PRIu32 "\n", now, target);
+
+    if ((target >= now) && ((target - XTIMER_BACKOFF) < now)) {
+        /* backoff */
+        xtimer_spin_until(target + XTIMER_BACKOFF);
+        timer->callback(timer->arg);
+        return 0;
+    }
+
+    unsigned state = irq_disable();
+    uint64_t now64 = _now();
+    /* targets before now are in the next 32 bit period */
+    uint64_t target64 = now64 + (uint32_t)(target - (uint32_t)now64);
+
+    _remove(timer);
+    timer->target = (uint32_t)target64;
+    timer->long_target = target64 >> 32;
+    _add(timer, now64);
+    irq_restore(state);
+
+    return 0;
+}
+
+void xtimer_remove(xtimer_t *timer)
+{
+    unsigned state = irq_disable();
+
+    /* the low-level timer is left as it is, the slot will just be found
+     * empty */
+    _remove(timer);
+    irq_restore(state);
+}
+
+static void _periph_timer_callback(void *arg, int chan)
+{
+    uint64_t now, next;
+
+    (void)arg;
+    (void)chan;
+
+    _in_handler = 1;
+    while (1) {
+        now = _now();
+        next = _next_event();
+        if (next <= now) {
+            _wheel_time = next;
+            _expire();
+        }
+        else if ((next - now) < XTIMER_ISR_BACKOFF) {
+            /* too close to set the low-level timer, wait for it */
+            while (_now() < next) {}
+        }
+        else {
+            /* no slot starts before next */
+            _wheel_time = now;
+            break;
+        }
+    }
+    _in_handler = 0;
+
+    _lltimer_set();
+}
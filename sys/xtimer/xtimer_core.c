@@ -24,6 +24,14 @@
 #include "xtimer.h"
 #include "irq.h"
 
+/* Skipping the period tick relies on the full 32 bit of the time being kept
+ * in hardware, see _next_wakeup(). Narrow timers keep ticking. */
+#if defined(MODULE_XTIMER_TICKLESS) && !XTIMER_MASK
+#define XTIMER_TICKLESS     (1)
+#else
+#define XTIMER_TICKLESS     (0)
+#endif
+
 /* WARNING! enabling this will have side effects and can lead to timer underflows. */
 #define ENABLE_DEBUG 0
 #include "debug.h"
@@ -41,6 +49,17 @@ static xtimer_t *timer_list_head = NULL;
 static xtimer_t *overflow_list_head = NULL;
 static xtimer_t *long_list_head = NULL;
 
+#if XTIMER_TICKLESS
+/* highest low-level timer value seen in the current period. A lower value
+ * means the timer wrapped without the period having been advanced yet. */
+static uint32_t _period_ref = 0;
+/* set while the low-level timer is programmed to the end of the period */
+static int _tick_armed = 1;
+#endif
+#ifdef MODULE_XTIMER_TICKLESS
+static xtimer_wakeups_t _wakeups;
+#endif
+
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer);
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer);
 static void _shoot(xtimer_t *timer);
@@ -52,6 +71,12 @@ static void _timer_callback(void);
 static void _periph_timer_callback(void *arg, int chan);
 
 static inline int _this_high_period(uint32_t target);
+static uint32_t _idle_target(void);
+#if XTIMER_TICKLESS
+static int _next_wakeup(uint32_t *target);
+static void _sync_period(void);
+static void _rearm(void);
+#endif
 
 static inline int _is_set(xtimer_t *timer)
 {
@@ -77,6 +102,17 @@ void xtimer_init(void)
 
 static void _xtimer_now_internal(uint32_t *short_term, uint32_t *long_term)
 {
+#if XTIMER_TICKLESS
+    unsigned state = irq_disable();
+
+    *short_term = _xtimer_now();
+    *long_term = _long_cnt;
+    if (*short_term < _period_ref) {
+        /* the period tick was skipped and is not caught up on yet */
+        (*long_term)++;
+    }
+    irq_restore(state);
+#else
     uint32_t before, after, long_value;
 
     /* loop to cope with possible overflow of _xtimer_now() */
@@ -89,6 +125,7 @@ static void _xtimer_now_internal(uint32_t *short_term, uint32_t *long_term)
 
     *short_term = after;
     *long_term = long_value;
+#endif
 }
 
 uint64_t _xtimer_now64(void)
@@ -108,6 +145,9 @@ void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
     }
     else {
         int state = irq_disable();
+#if XTIMER_TICKLESS
+        _sync_period();
+#endif
         if (_is_set(timer)) {
             _remove(timer);
         }
@@ -120,6 +160,9 @@ void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
         }
 
         _add_timer_to_long_list(&long_list_head, timer);
+#if XTIMER_TICKLESS
+        _rearm();
+#endif
         irq_restore(state);
         DEBUG("xtimer_set64(): added longterm timer (long_target=%" PRIu32 " target=%" PRIu32 ")\n",
                 timer->long_target, timer->target);
@@ -184,6 +227,9 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
     }
 
     unsigned state = irq_disable();
+#if XTIMER_TICKLESS
+    _sync_period();
+#endif
     if (_is_set(timer)) {
         _remove(timer);
     }
@@ -197,11 +243,17 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
     if ( (timer->long_target > _long_cnt) || !_this_high_period(target) ) {
         DEBUG("xtimer_set_absolute(): the timer doesn't fit into the low-level timer's mask.\n");
         _add_timer_to_long_list(&long_list_head, timer);
+#if XTIMER_TICKLESS
+        _rearm();
+#endif
     }
     else {
         if (_xtimer_lltimer_mask(now) >= target) {
             DEBUG("xtimer_set_absolute(): the timer will expire in the next timer period\n");
             _add_timer_to_list(&overflow_list_head, timer);
+#if XTIMER_TICKLESS
+            _rearm();
+#endif
         }
         else {
             DEBUG("timer_set_absolute(): timer will expire in this timer period.\n");
@@ -264,7 +316,7 @@ static void _remove(xtimer_t *timer)
             next = timer_list_head->target - XTIMER_OVERHEAD;
         }
         else {
-            next = _xtimer_lltimer_mask(0xFFFFFFFF);
+            next = _idle_target();
         }
         _lltimer_set(next);
     }
@@ -417,6 +469,9 @@ static void _next_period(void)
     /* advance >32bit counter */
     _long_cnt++;
 #endif
+#if XTIMER_TICKLESS
+    _period_ref = 0;
+#endif
 
     /* swap overflow list to current timer list */
     timer_list_head = overflow_list_head;
@@ -432,6 +487,9 @@ static void _timer_callback(void)
 {
     uint32_t next_target;
     uint32_t reference;
+#ifdef MODULE_XTIMER_TICKLESS
+    unsigned fired = 0;
+#endif
 
     _in_handler = 1;
 
@@ -439,6 +497,32 @@ static void _timer_callback(void)
           xtimer_now().ticks32, _xtimer_lltimer_mask(xtimer_now().ticks32),
           _xtimer_lltimer_mask(0xffffffff - xtimer_now().ticks32));
 
+#if XTIMER_TICKLESS
+    reference = _xtimer_lltimer_now();
+    if (reference < _period_ref) {
+        DEBUG("_timer_callback(): catching up on skipped tick\n");
+        /* either the period tick was skipped or we were late for it */
+#ifdef MODULE_XTIMER_TICKLESS
+        if (!_tick_armed) {
+            _wakeups.skipped++;
+        }
+#endif
+        _next_period();
+        reference = 0;
+    }
+    else if (!timer_list_head && _tick_armed) {
+        DEBUG("_timer_callback(): tick\n");
+        _next_period();
+        reference = 0;
+        while (_xtimer_lltimer_now() == 0xFFFFFFFF) {}
+    }
+    else {
+        /* a timer is waiting, or there is nothing to do as the period was
+         * already advanced by _sync_period() */
+        _period_ref = reference;
+    }
+    _tick_armed = 0;
+#else
     if (!timer_list_head) {
         DEBUG("_timer_callback(): tick\n");
         /* there's no timer for this timer period,
@@ -461,6 +545,7 @@ static void _timer_callback(void)
         /* set our period reference to the current time. */
         reference = _xtimer_lltimer_now();
     }
+#endif
 
 overflow:
     /* check if next timers are close to expiring */
@@ -480,6 +565,9 @@ overflow:
 
         /* fire timer */
         _shoot(timer);
+#ifdef MODULE_XTIMER_TICKLESS
+        fired++;
+#endif
     }
 
     /* possibly executing all callbacks took enough
@@ -505,8 +593,6 @@ overflow:
     }
     else {
         /* there's no timer planned for this timer period */
-        /* schedule callback on next overflow */
-        next_target = _xtimer_lltimer_mask(0xFFFFFFFF);
         uint32_t now = _xtimer_lltimer_now();
 
         /* check for overflow again */
@@ -525,10 +611,127 @@ overflow:
                 goto overflow;
             }
         }
+#if XTIMER_TICKLESS
+        _period_ref = now;
+#endif
+        /* schedule callback on next overflow, or on the first timer of the
+         * next period if the overflow tick can be skipped */
+        next_target = _idle_target();
     }
 
+#ifdef MODULE_XTIMER_TICKLESS
+    if (fired) {
+        _wakeups.timer++;
+    }
+    else {
+        _wakeups.period++;
+    }
+#endif
+
     _in_handler = 0;
 
     /* set low level timer */
     _lltimer_set(next_target);
 }
+
+/**
+ * @brief   low-level timer target to use once the current timer list is empty
+ */
+static uint32_t _idle_target(void)
+{
+#if XTIMER_TICKLESS
+    uint32_t target;
+
+    if (_next_wakeup(&target)) {
+        _tick_armed = 0;
+        return target;
+    }
+    _tick_armed = 1;
+#endif
+    return _xtimer_lltimer_mask(0xFFFFFFFF);
+}
+
+
+#if XTIMER_TICKLESS
+/**
+ * @brief   find the first timer of the next period and check whether the
+ *          period tick can be merged into its callback
+ *
+ * The low-level timer keeps counting across the end of the period, so it is
+ * enough to advance the period when that timer fires. The target must be
+ * below _period_ref, as that is what tells a wrapped counter apart from
+ * one still in the current period until then.
+ */
+static int _next_wakeup(uint32_t *target)
+{
+    xtimer_t *next = overflow_list_head;
+    uint32_t wakeup;
+
+    if (long_list_head && (long_list_head->long_target <= (_long_cnt + 1)) &&
+        (!next || (long_list_head->target < next->target))) {
+        next = long_list_head;
+    }
+    if (!next) {
+        return 0;
+    }
+    wakeup = next->target - XTIMER_OVERHEAD;
+    if ((wakeup > next->target) || (wakeup >= _period_ref)) {
+        return 0;
+    }
+    *target = wakeup;
+    return 1;
+}
+
+/**
+ * @brief   catch up on a skipped period tick before the timer lists are used
+ *          outside of the callback
+ */
+static void _sync_period(void)
+{
+    uint32_t now;
+
+    if (_in_handler) {
+        return;
+    }
+    now = _xtimer_lltimer_now();
+    if (now < _period_ref) {
+        if (!_tick_armed) {
+            _wakeups.skipped++;
+        }
+        /* the low-level timer is pending or set to a target not later than
+         * the first timer of the new period, no need to reprogram it */
+        _next_period();
+        _tick_armed = 0;
+    }
+    if (now > _period_ref) {
+        _period_ref = now;
+    }
+}
+
+/**
+ * @brief   reprogram the low-level timer after a timer was added to the
+ *          overflow or long list
+ */
+static void _rearm(void)
+{
+    uint32_t target;
+
+    if (_in_handler || timer_list_head) {
+        return;
+    }
+    if (_next_wakeup(&target)) {
+        _tick_armed = 0;
+        _lltimer_set(target);
+    }
+}
+#endif
+
+#ifdef MODULE_XTIMER_TICKLESS
+void xtimer_get_wakeups(xtimer_wakeups_t *wakeups)
+{
+    unsigned state = irq_disable();
+
+    *wakeups = _wakeups;
+    irq_restore(state);
+}
+#endif
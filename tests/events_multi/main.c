@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for serving multiple event queues
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "event.h"
+
+#define HIGH_NUMOF      (5U)
+#define LOW_NUMOF       (2U)
+
+static void high_handler(event_t *event);
+static void low_handler(event_t *event);
+static void done_handler(event_t *event);
+
+static event_queue_t queues[2];
+/* the high priority queue may hand two events in a row, the low priority
+ * queue is not limited */
+static const unsigned budgets[2] = { 2, 0 };
+
+static event_t high[HIGH_NUMOF];
+static event_t low[LOW_NUMOF];
+static event_t done = { .handler = done_handler };
+
+static char order[HIGH_NUMOF + LOW_NUMOF + 1];
+static unsigned order_len;
+
+static void high_handler(event_t *event)
+{
+    (void)event;
+    order[order_len++] = 'H';
+}
+
+static void low_handler(event_t *event)
+{
+    (void)event;
+    order[order_len++] = 'L';
+}
+
+static void done_handler(event_t *event)
+{
+    (void)event;
+    printf("order: %s\n", order);
+    if (strcmp(order, "HHLHHLH") == 0) {
+        puts("[SUCCESS]");
+    }
+    else {
+        puts("[FAILED]");
+    }
+}
+
+int main(void)
+{
+    puts("[START] multi-queue event test application.\n");
+
+    event_queue_init(&queues[0]);
+    event_queue_init(&queues[1]);
+
+    for (unsigned i = 0; i < HIGH_NUMOF; i++) {
+        high[i].handler = high_handler;
+        event_post(&queues[0], &high[i]);
+    }
+    /* posting a queued event again must not queue it twice */
+    event_post(&queues[0], &high[0]);
+    printf("coalesced posts: %u\n", queues[0].coalesced);
+
+    for (unsigned i = 0; i < LOW_NUMOF; i++) {
+        low[i].handler = low_handler;
+        event_post(&queues[1], &low[i]);
+    }
+    event_post(&queues[1], &done);
+
+    event_loop_multi(queues, 2, budgets);
+
+    return 0;
+}
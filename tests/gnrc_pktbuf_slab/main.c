@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the size class specific behavior of gnrc_pktbuf_slab
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gnrc/pktbuf.h"
+
+#define TEST_STRING4    "test"
+#define TEST_STRING16   "0123456789abcdef"
+#define TEST_LARGE      (256U)
+#define TEST_MEDIUM     (128U)
+#define TEST_CHUNK      (200U)
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+}
+
+static void test_pktbuf_slab__pool_overflow(void)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+
+    /* more snips than the pool holds fall back to the arena */
+    for (unsigned i = 0; i < (GNRC_PKTBUF_SLAB_SNIP_NUMOF + 4); i++) {
+        gnrc_pktsnip_t *tmp = gnrc_pktbuf_add(pkt, NULL, 0, GNRC_NETTYPE_UNDEF);
+
+        TEST_ASSERT_NOT_NULL(tmp);
+        pkt = tmp;
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__mark_small(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, TEST_STRING16,
+                                          sizeof(TEST_STRING16),
+                                          GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *hdr;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    hdr = gnrc_pktbuf_mark(pkt, 4, GNRC_NETTYPE_TEST);
+    TEST_ASSERT_NOT_NULL(hdr);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT_EQUAL_INT(4, hdr->size);
+    TEST_ASSERT_EQUAL_INT(sizeof(TEST_STRING16) - 4, pkt->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16, hdr->data, 4));
+    TEST_ASSERT_EQUAL_STRING(&TEST_STRING16[4], pkt->data);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__realloc_in_block(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, TEST_STRING4,
+                                          sizeof(TEST_STRING4),
+                                          GNRC_NETTYPE_UNDEF);
+    void *data;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    data = pkt->data;
+    /* growing within a block of the small pool keeps the data in place */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt,
+                                                      GNRC_PKTBUF_SLAB_SMALL_SIZE));
+    TEST_ASSERT(data == pkt->data);
+    TEST_ASSERT_EQUAL_STRING(TEST_STRING4, pkt->data);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, 2));
+    TEST_ASSERT(data == pkt->data);
+    /* growing beyond moves the data to the arena */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt, TEST_LARGE));
+    TEST_ASSERT(data != pkt->data);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING4, pkt->data, 2));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__best_fit(void)
+{
+    gnrc_pktsnip_t *a = gnrc_pktbuf_add(NULL, NULL, TEST_LARGE, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *b = gnrc_pktbuf_add(NULL, NULL, TEST_LARGE, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *c = gnrc_pktbuf_add(NULL, NULL, TEST_MEDIUM, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *d = gnrc_pktbuf_add(NULL, NULL, TEST_LARGE, GNRC_NETTYPE_UNDEF);
+    void *hole = c->data;
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_NOT_NULL(d);
+    gnrc_pktbuf_release(a);
+    gnrc_pktbuf_release(c);
+    /* first fit would take the hole left by a */
+    c = gnrc_pktbuf_add(NULL, NULL, TEST_MEDIUM, GNRC_NETTYPE_UNDEF);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT(hole == c->data);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    gnrc_pktbuf_release(b);
+    gnrc_pktbuf_release(c);
+    gnrc_pktbuf_release(d);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__coalesce(void)
+{
+    gnrc_pktsnip_t *chunks[GNRC_PKTBUF_SIZE / TEST_CHUNK];
+    gnrc_pktsnip_t *pkt;
+    unsigned numof = 0;
+
+    while ((numof < (sizeof(chunks) / sizeof(chunks[0]))) &&
+           (chunks[numof] = gnrc_pktbuf_add(NULL, NULL, TEST_CHUNK,
+                                            GNRC_NETTYPE_UNDEF)) != NULL) {
+        numof++;
+    }
+    TEST_ASSERT(numof > 2);
+    /* free every other chunk first, so the holes are merged from both sides */
+    for (unsigned i = 0; i < numof; i += 2) {
+        gnrc_pktbuf_release(chunks[i]);
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    for (unsigned i = 1; i < numof; i += 2) {
+        gnrc_pktbuf_release(chunks[i]);
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+    pkt = gnrc_pktbuf_add(NULL, NULL, numof * TEST_CHUNK, GNRC_NETTYPE_UNDEF);
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static Test *tests_gnrc_pktbuf_slab(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_pktbuf_slab__pool_overflow),
+        new_TestFixture(test_pktbuf_slab__mark_small),
+        new_TestFixture(test_pktbuf_slab__realloc_in_block),
+        new_TestFixture(test_pktbuf_slab__best_fit),
+        new_TestFixture(test_pktbuf_slab__coalesce),
+    };
+
+    EMB_UNIT_TESTCALLER(pktbuf_slab_tests, set_up, NULL, fixtures);
+
+    return (Test *)&pktbuf_slab_tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_pktbuf_slab());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests forwarding of fragments through the virtual reassembly
+ *              buffer
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "msg.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+#include "net/netdev_test.h"
+#include "net/protnum.h"
+#include "net/sixlowpan.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MSG_QUEUE_SIZE      (4)
+#define MSG_TYPE_SENT       (0x4711)
+#define RECV_TIMEOUT        (100U * US_PER_MS)
+
+#define MAX_PACKET_SIZE     (100U)
+#define DATAGRAM_SIZE       (176U)
+#define IN_TAG              (0x1234U)
+#define FRAG_N_SIZE         (64U)
+
+#define LOCAL_L2ADDR        { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+#define PREV_HOP_L2ADDR     { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+#define NEXT_HOP_L2ADDR     { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }
+#define SRC_ADDR            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+#define DST_ADDR            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02
+
+static uint8_t _local_l2addr[] = LOCAL_L2ADDR;
+static uint8_t _prev_hop[] = PREV_HOP_L2ADDR;
+static const uint8_t _next_hop[] = NEXT_HOP_L2ADDR;
+static const ipv6_addr_t _dst = { .u8 = { DST_ADDR } };
+
+/* first fragment: IPHC with traffic class and flow label elided, next header
+ * (No Next Header) and both addresses inline and a hop limit of 64, followed
+ * by 8 bytes of payload. It carries 48 bytes of the uncompressed datagram. */
+static const uint8_t _frag_1[] = {
+    SIXLOWPAN_FRAG_1_DISP | (DATAGRAM_SIZE >> 8), DATAGRAM_SIZE & 0xff,
+    IN_TAG >> 8, IN_TAG & 0xff,
+    0x7a, 0x00, PROTNUM_IPV6_NONXT, SRC_ADDR, DST_ADDR,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+};
+#define FRAG_1_UNCOMP_SIZE  (48U)
+
+static netdev_test_t _dev;
+static gnrc_netif_t *_netif;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static uint8_t _frag_n[sizeof(sixlowpan_frag_n_t) + FRAG_N_SIZE];
+
+static void _set_up(void)
+{
+    msg_t msg;
+
+    /* empty the queue from earlier tests */
+    while (msg_try_receive(&msg) > 0) {
+        gnrc_pktbuf_release(msg.content.ptr);
+    }
+}
+
+static void _tear_down(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    if ((entry = gnrc_sixlowpan_frag_vrb_get(_prev_hop, sizeof(_prev_hop),
+                                             DATAGRAM_SIZE, IN_TAG)) != NULL) {
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+    }
+}
+
+static void _recv(const uint8_t *data, size_t data_len)
+{
+    gnrc_pktsnip_t *netif, *frag;
+
+    netif = gnrc_netif_hdr_build(_prev_hop, sizeof(_prev_hop), _local_l2addr,
+                                 sizeof(_local_l2addr));
+    TEST_ASSERT_NOT_NULL(netif);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _netif->pid;
+    frag = gnrc_pktbuf_add(netif, data, data_len, GNRC_NETTYPE_SIXLOWPAN);
+    TEST_ASSERT_NOT_NULL(frag);
+    gnrc_sixlowpan_frag_handle_pkt(frag);
+}
+
+/* receives _frag_1 with its datagram size replaced by size */
+static void _recv_frag_1(size_t size)
+{
+    uint8_t frag_1[sizeof(_frag_1)];
+    sixlowpan_frag_t *hdr = (sixlowpan_frag_t *)frag_1;
+
+    memcpy(frag_1, _frag_1, sizeof(_frag_1));
+    hdr->disp_size = byteorder_htons(size);
+    hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+    _recv(frag_1, sizeof(frag_1));
+}
+
+static void _recv_frag_n(size_t offset)
+{
+    sixlowpan_frag_n_t *hdr = (sixlowpan_frag_n_t *)_frag_n;
+
+    hdr->disp_size = byteorder_htons(DATAGRAM_SIZE);
+    hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+    hdr->tag = byteorder_htons(IN_TAG);
+    hdr->offset = offset / 8;
+    for (unsigned i = 0; i < FRAG_N_SIZE; i++) {
+        _frag_n[sizeof(sixlowpan_frag_n_t) + i] = offset + i;
+    }
+    _recv(_frag_n, sizeof(_frag_n));
+}
+
+/* returns the next fragment sent over _netif, NULL on timeout */
+static gnrc_pktsnip_t *_sent(void)
+{
+    msg_t msg;
+
+    if ((xtimer_msg_receive_timeout(&msg, RECV_TIMEOUT) < 0) ||
+        (msg.type != MSG_TYPE_SENT)) {
+        return NULL;
+    }
+    return msg.content.ptr;
+}
+
+/* checks the link-layer header of a forwarded fragment and stores its tag in
+ * tag */
+static void _check_sent(gnrc_pktsnip_t *pkt, uint16_t *tag)
+{
+    gnrc_netif_hdr_t *hdr;
+    sixlowpan_frag_t *frag;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_NETIF, pkt->type);
+    hdr = pkt->data;
+    TEST_ASSERT_EQUAL_INT(_netif->pid, hdr->if_pid);
+    TEST_ASSERT_EQUAL_INT(sizeof(_next_hop), hdr->dst_l2addr_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_next_hop,
+                                    gnrc_netif_hdr_get_dst_addr(hdr),
+                                    sizeof(_next_hop)));
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    frag = pkt->next->data;
+    TEST_ASSERT(sixlowpan_frag_is(frag));
+    TEST_ASSERT_EQUAL_INT(DATAGRAM_SIZE, byteorder_ntohs(frag->disp_size) &
+                                         SIXLOWPAN_FRAG_SIZE_MASK);
+    /* the datagram tag is rewritten for the next hop */
+    TEST_ASSERT(byteorder_ntohs(frag->tag) != IN_TAG);
+    *tag = byteorder_ntohs(frag->tag);
+}
+
+static void _check_sent_frag_n(gnrc_pktsnip_t *pkt, uint16_t tag,
+                               size_t offset)
+{
+    sixlowpan_frag_n_t *frag;
+    uint16_t sent_tag = IN_TAG;
+
+    _check_sent(pkt, &sent_tag);
+    TEST_ASSERT_EQUAL_INT(tag, sent_tag);
+    TEST_ASSERT_EQUAL_INT(sizeof(sixlowpan_frag_n_t) + FRAG_N_SIZE,
+                          pkt->next->size);
+    frag = pkt->next->data;
+    TEST_ASSERT_EQUAL_INT(SIXLOWPAN_FRAG_N_DISP,
+                          frag->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK);
+    TEST_ASSERT_EQUAL_INT(offset / 8, frag->offset);
+    for (unsigned i = 0; i < FRAG_N_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT((uint8_t)(offset + i),
+                              ((uint8_t *)(frag + 1))[i]);
+    }
+    gnrc_pktbuf_release(pkt);
+}
+
+/* forwards _frag_1 and stores the tag it was sent with in tag */
+static void _forward_frag_1(uint16_t *tag)
+{
+    gnrc_pktsnip_t *pkt;
+    sixlowpan_frag_t *frag;
+
+    *tag = IN_TAG;
+    _recv(_frag_1, sizeof(_frag_1));
+    pkt = _sent();
+    _check_sent(pkt, tag);
+    TEST_ASSERT(*tag != IN_TAG);
+    frag = pkt->next->data;
+    TEST_ASSERT_EQUAL_INT(SIXLOWPAN_FRAG_1_DISP,
+                          frag->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK);
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_vrb_forward(void)
+{
+    uint16_t tag;
+
+    _forward_frag_1(&tag);
+    TEST_ASSERT(tag != IN_TAG);
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop,
+                                                     sizeof(_prev_hop),
+                                                     DATAGRAM_SIZE, IN_TAG));
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE);
+    _check_sent_frag_n(_sent(), tag, FRAG_1_UNCOMP_SIZE);
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop,
+                                                     sizeof(_prev_hop),
+                                                     DATAGRAM_SIZE, IN_TAG));
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE + FRAG_N_SIZE);
+    _check_sent_frag_n(_sent(), tag, FRAG_1_UNCOMP_SIZE + FRAG_N_SIZE);
+    /* the whole datagram was forwarded */
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop, sizeof(_prev_hop),
+                                                 DATAGRAM_SIZE, IN_TAG));
+}
+
+static void test_vrb_forward_duplicate(void)
+{
+    uint16_t tag;
+
+    _forward_frag_1(&tag);
+    TEST_ASSERT(tag != IN_TAG);
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE + FRAG_N_SIZE);
+    _check_sent_frag_n(_sent(), tag, FRAG_1_UNCOMP_SIZE + FRAG_N_SIZE);
+    /* a duplicate is dropped and does not complete the datagram */
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE + FRAG_N_SIZE);
+    TEST_ASSERT_NULL(_sent());
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop,
+                                                     sizeof(_prev_hop),
+                                                     DATAGRAM_SIZE, IN_TAG));
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE);
+    _check_sent_frag_n(_sent(), tag, FRAG_1_UNCOMP_SIZE);
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop, sizeof(_prev_hop),
+                                                 DATAGRAM_SIZE, IN_TAG));
+}
+
+static void test_vrb_forward_beyond_datagram(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+    uint16_t tag;
+    unsigned forwarded;
+
+    _forward_frag_1(&tag);
+    TEST_ASSERT(tag != IN_TAG);
+    entry = gnrc_sixlowpan_frag_vrb_get(_prev_hop, sizeof(_prev_hop),
+                                        DATAGRAM_SIZE, IN_TAG);
+    TEST_ASSERT_NOT_NULL(entry);
+    forwarded = entry->forwarded_numof;
+    /* the fragment ends behind the datagram, so it is dropped */
+    _recv_frag_n(DATAGRAM_SIZE - FRAG_N_SIZE + 8);
+    TEST_ASSERT_NULL(_sent());
+    TEST_ASSERT_EQUAL_INT(forwarded, entry->forwarded_numof);
+    _recv_frag_n(FRAG_1_UNCOMP_SIZE);
+    _check_sent_frag_n(_sent(), tag, FRAG_1_UNCOMP_SIZE);
+}
+
+static void test_vrb_forward_1st_invalid_size(void)
+{
+    static const size_t sizes[] = { 0, FRAG_1_UNCOMP_SIZE - 8 };
+
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        _recv_frag_1(sizes[i]);
+        /* the fragment is dropped, not forwarded or reassembled */
+        TEST_ASSERT_NULL(_sent());
+        TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_prev_hop,
+                                                     sizeof(_prev_hop),
+                                                     sizes[i], IN_TAG));
+    }
+}
+
+static Test *tests_gnrc_sixlowpan_frag_vrb(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vrb_forward),
+        new_TestFixture(test_vrb_forward_duplicate),
+        new_TestFixture(test_vrb_forward_beyond_datagram),
+        new_TestFixture(test_vrb_forward_1st_invalid_size),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, _set_up, _tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+static int _mock_netif_send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    msg_t msg = { .type = MSG_TYPE_SENT, .content = { .ptr = pkt } };
+
+    (void)netif;
+    /* only hand forwarded fragments to the test, not e.g. router
+     * advertisements */
+    if ((pkt->next == NULL) || (pkt->next->type != GNRC_NETTYPE_SIXLOWPAN) ||
+        !sixlowpan_frag_is(pkt->next->data) ||
+        (msg_try_send(&msg, _main_pid) < 1)) {
+        gnrc_pktbuf_release(pkt);
+    }
+    return 0;
+}
+
+static gnrc_pktsnip_t *_mock_netif_recv(gnrc_netif_t *netif)
+{
+    (void)netif;
+    return NULL;
+}
+
+static const gnrc_netif_ops_t _mock_netif_ops = {
+    .send = _mock_netif_send,
+    .recv = _mock_netif_recv,
+    .get = gnrc_netif_get_from_netdev,
+    .set = gnrc_netif_set_from_netdev,
+};
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_IEEE802154;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = MAX_PACKET_SIZE;
+    return sizeof(uint16_t);
+}
+
+static int _get_src_len(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = sizeof(_local_l2addr);
+    return sizeof(uint16_t);
+}
+
+static int _get_address_long(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len >= sizeof(_local_l2addr));
+    memcpy(value, _local_l2addr, sizeof(_local_l2addr));
+    return sizeof(_local_l2addr);
+}
+
+static void _tests_init(void)
+{
+    _main_pid = sched_active_pid;
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+    netdev_test_setup(&_dev, 0);
+    netdev_test_set_get_cb(&_dev, NETOPT_DEVICE_TYPE, _get_device_type);
+    netdev_test_set_get_cb(&_dev, NETOPT_MAX_PACKET_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_dev, NETOPT_SRC_LEN, _get_src_len);
+    netdev_test_set_get_cb(&_dev, NETOPT_ADDRESS_LONG, _get_address_long);
+    _netif = gnrc_netif_create(_netif_stack, sizeof(_netif_stack),
+                               GNRC_NETIF_PRIO, "mockup_wpan", (netdev_t *)&_dev,
+                               &_mock_netif_ops);
+    assert(_netif != NULL);
+    gnrc_netif_acquire(_netif);
+    _netif->flags |= GNRC_NETIF_FLAGS_IPV6_FORWARDING;
+    gnrc_netif_release(_netif);
+    /* the destination is a neighbor on the same interface, so the node
+     * forwards the datagram back out of the interface it came from */
+    gnrc_ipv6_nib_nc_set(&_dst, _netif->pid, _next_hop, sizeof(_next_hop));
+}
+
+int main(void)
+{
+    _tests_init();
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_sixlowpan_frag_vrb());
+    TESTS_END();
+    return 0;
+}
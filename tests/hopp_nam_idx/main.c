@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares NAM cache lookups by linear scan and by hashed index
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "compas/routing/dodag.h"
+#include "compas/routing/nam.h"
+#include "net/hopp/nam_idx.h"
+#include "xtimer.h"
+
+#define LOOKUP_ROUNDS   (16U)
+
+static const uint16_t cache_sizes[] = { 8, 16, 32, 64, 128, 256 };
+
+static compas_dodag_t dodag;
+static compas_name_t names[COMPAS_NAM_CACHE_LEN];
+static hopp_nam_idx_bucket_t buckets[HOPP_NAM_IDX_LEN];
+static hopp_nam_idx_t idx;
+
+static void fill(uint16_t size)
+{
+    memset(&dodag, 0, sizeof(dodag));
+    hopp_nam_idx_init(&idx, buckets, HOPP_NAM_IDX_LEN, dodag.nam_cache, size);
+    for (uint16_t i = 0; i < size; i++) {
+        char name[COMPAS_NAME_LEN];
+        int len = snprintf(name, sizeof(name), "/hopp/bench/%u", i);
+        compas_name_init(&names[i], name, len);
+        compas_nam_cache_entry_t *nce = compas_nam_cache_add(&dodag, &names[i],
+                                                             NULL);
+        if ((nce == NULL) ||
+            (hopp_nam_idx_add(&idx, nce - dodag.nam_cache) < 0)) {
+            printf("error: unable to add %s\n", name);
+        }
+    }
+}
+
+static uint32_t bench_linear(uint16_t size)
+{
+    uint32_t start = xtimer_now_usec();
+    for (unsigned r = 0; r < LOOKUP_ROUNDS; r++) {
+        for (uint16_t i = 0; i < size; i++) {
+            if (compas_nam_cache_find(&dodag, &names[i]) == NULL) {
+                printf("error: linear lookup %u failed\n", i);
+            }
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+static uint32_t bench_idx(uint16_t size)
+{
+    uint32_t start = xtimer_now_usec();
+    for (unsigned r = 0; r < LOOKUP_ROUNDS; r++) {
+        for (uint16_t i = 0; i < size; i++) {
+            if (hopp_nam_idx_find(&idx, &names[i]) == NULL) {
+                printf("error: index lookup %u failed\n", i);
+            }
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    puts("Start.");
+    for (unsigned i = 0; i < sizeof(cache_sizes) / sizeof(cache_sizes[0]); i++) {
+        uint16_t size = cache_sizes[i];
+        unsigned lookups = size * LOOKUP_ROUNDS;
+
+        fill(size);
+        uint32_t linear = bench_linear(size);
+        uint32_t hashed = bench_idx(size);
+        printf("+ size %3u: linear %lu ns/lookup, hashed %lu ns/lookup\n",
+               size, (unsigned long)((linear * 1000) / lookups),
+               (unsigned long)((hashed * 1000) / lookups));
+    }
+    puts("Done.");
+    return 0;
+}
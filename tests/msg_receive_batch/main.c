@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   msg_receive_batch test and benchmark application
+ *
+ * Checks that batched receiving keeps the order of queued messages and of
+ * messages of blocked senders and compares the per-message overhead of
+ * msg_try_receive() and msg_try_receive_batch() on a full queue.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define QUEUE_SIZE      (16U)
+#define ROUNDS          (1000U)
+
+static msg_t _queue[QUEUE_SIZE];
+static msg_t _batch[QUEUE_SIZE + 2];
+static kernel_pid_t _main_pid;
+static char _stack[THREAD_STACKSIZE_MAIN];
+
+static void *_sender(void *arg)
+{
+    (void)arg;
+    /* the last two block, since main is not receiving yet */
+    for (unsigned i = 0; i < (QUEUE_SIZE + 2); i++) {
+        msg_t msg = { .content = { .value = i } };
+
+        msg_send(&msg, _main_pid);
+    }
+    return NULL;
+}
+
+static bool _test_order(void)
+{
+    unsigned expected = 0;
+    int numof;
+
+    thread_create(_stack, sizeof(_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _sender, NULL, "sender");
+    while ((numof = msg_try_receive_batch(_batch, QUEUE_SIZE + 2)) > 0) {
+        for (int i = 0; i < numof; i++) {
+            if (_batch[i].content.value != expected++) {
+                printf("order: expected %u, got %" PRIu32 "\n",
+                       expected - 1, _batch[i].content.value);
+                return false;
+            }
+        }
+    }
+    if (expected != (QUEUE_SIZE + 2)) {
+        printf("order: got %u of %u messages\n", expected, QUEUE_SIZE + 2);
+        return false;
+    }
+    puts("order: ok");
+    return true;
+}
+
+static void _fill(void)
+{
+    msg_t msg = { .type = 0 };
+
+    for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+        msg_send_to_self(&msg);
+    }
+}
+
+static uint32_t _bench(bool batch)
+{
+    uint32_t total = 0;
+
+    for (unsigned r = 0; r < ROUNDS; r++) {
+        uint32_t start;
+
+        _fill();
+        start = xtimer_now_usec();
+        if (batch) {
+            while (msg_try_receive_batch(_batch, QUEUE_SIZE) > 0) {}
+        }
+        else {
+            while (msg_try_receive(_batch) > 0) {}
+        }
+        total += xtimer_now_usec() - start;
+    }
+    /* in ns per message */
+    return (uint32_t)(((uint64_t)total * 1000U) / (ROUNDS * QUEUE_SIZE));
+}
+
+int main(void)
+{
+    uint32_t single, batch;
+
+    _main_pid = thread_getpid();
+    msg_init_queue(_queue, QUEUE_SIZE);
+
+    puts("msg_receive_batch test");
+    if (!_test_order()) {
+        puts("[FAILED]");
+        return 1;
+    }
+    single = _bench(false);
+    batch = _bench(true);
+    printf("msg_try_receive():       %" PRIu32 " ns per message\n", single);
+    printf("msg_try_receive_batch(): %" PRIu32 " ns per message\n", batch);
+    puts("[SUCCESS]");
+    return 0;
+}
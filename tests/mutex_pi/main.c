@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for priority inheriting mutexes
+ *
+ * A low priority thread holds a mutex for @ref HOLD_US. A high priority
+ * thread blocks on the mutex while it is held and a medium priority thread
+ * becomes ready shortly after and never yields for @ref MID_SPIN_US. Without
+ * priority inheritance the high priority thread would wait for the medium
+ * priority thread as well; with it, its blocking time is bounded by
+ * @ref HOLD_US.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "msg.h"
+#include "mutex_pi.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define HOLD_US         (100U * US_PER_MS)
+#define HIGH_DELAY_US   (10U * US_PER_MS)
+#define MID_DELAY_US    (20U * US_PER_MS)
+#define MID_SPIN_US     (300U * US_PER_MS)
+
+#define PRIO_HIGH       (THREAD_PRIORITY_MAIN - 3)
+#define PRIO_MID        (THREAD_PRIORITY_MAIN - 2)
+#define PRIO_LOW        (THREAD_PRIORITY_MAIN - 1)
+
+static char stack_high[THREAD_STACKSIZE_DEFAULT];
+static char stack_mid[THREAD_STACKSIZE_DEFAULT];
+static char stack_low[THREAD_STACKSIZE_DEFAULT];
+
+static mutex_pi_t _mutex = MUTEX_PI_INIT;
+static rmutex_pi_t _rmutex = RMUTEX_PI_INIT;
+static kernel_pid_t _main_pid;
+static bool _recursive;
+static bool _boosted;
+static bool _restored;
+
+static void _spin(uint32_t usec)
+{
+    uint32_t start = xtimer_now_usec();
+
+    while ((xtimer_now_usec() - start) < usec) {}
+}
+
+static void _lock(void)
+{
+    if (_recursive) {
+        rmutex_pi_lock(&_rmutex);
+    }
+    else {
+        mutex_pi_lock(&_mutex);
+    }
+}
+
+static void _unlock(void)
+{
+    if (_recursive) {
+        rmutex_pi_unlock(&_rmutex);
+    }
+    else {
+        mutex_pi_unlock(&_mutex);
+    }
+}
+
+static uint8_t _my_priority(void)
+{
+    return thread_get(thread_getpid())->priority;
+}
+
+static void *_low(void *arg)
+{
+    (void)arg;
+    _lock();
+    if (_recursive) {
+        _lock();
+    }
+    _spin(HOLD_US);
+    if (_recursive) {
+        _unlock();
+    }
+    /* the high priority thread is waiting by now */
+    _boosted = (_my_priority() == PRIO_HIGH);
+    _unlock();
+    _restored = (_my_priority() == PRIO_LOW);
+    return NULL;
+}
+
+static void *_mid(void *arg)
+{
+    (void)arg;
+    xtimer_usleep(MID_DELAY_US);
+    _spin(MID_SPIN_US);
+    return NULL;
+}
+
+static void *_high(void *arg)
+{
+    msg_t msg;
+    uint32_t start;
+
+    (void)arg;
+    xtimer_usleep(HIGH_DELAY_US);
+    start = xtimer_now_usec();
+    _lock();
+    msg.content.value = xtimer_now_usec() - start;
+    _unlock();
+    msg_send(&msg, _main_pid);
+    return NULL;
+}
+
+static void _run(const char *name, bool recursive)
+{
+    msg_t msg;
+
+    _recursive = recursive;
+    _boosted = false;
+    _restored = false;
+    /* high and mid go to sleep right away, low takes the mutex */
+    thread_create(stack_high, sizeof(stack_high), PRIO_HIGH,
+                  THREAD_CREATE_STACKTEST, _high, NULL, "high");
+    thread_create(stack_mid, sizeof(stack_mid), PRIO_MID,
+                  THREAD_CREATE_STACKTEST, _mid, NULL, "mid");
+    thread_create(stack_low, sizeof(stack_low), PRIO_LOW,
+                  THREAD_CREATE_STACKTEST, _low, NULL, "low");
+    /* only returns once all of them are done */
+    msg_receive(&msg);
+    printf("%s: high priority thread blocked for %" PRIu32 " us "
+           "(bound: %u us)\n", name, msg.content.value, HOLD_US);
+    if ((msg.content.value <= HOLD_US) && _boosted && _restored) {
+        printf("%s: [SUCCESS]\n", name);
+    }
+    else {
+        printf("%s: [FAILED] (boosted: %d, restored: %d)\n", name,
+               _boosted, _restored);
+    }
+}
+
+int main(void)
+{
+    puts("Test for priority inheriting mutexes");
+    _main_pid = thread_getpid();
+    _run("mutex_pi", false);
+    _run("rmutex_pi", true);
+    return 0;
+}
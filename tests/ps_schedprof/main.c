@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   ps -l scheduler profile test app
+ *
+ * A low priority thread spins for a while every time it is woken up, while
+ * a high priority thread is woken up periodically by a timer. The profile
+ * shown by `ps -l` should have long runs for the former and short latencies
+ * for the latter.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "shell.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define SPIN_US         (2U * US_PER_MS)
+#define PERIOD_US       (10U * US_PER_MS)
+
+static char _stack_low[THREAD_STACKSIZE_DEFAULT];
+static char _stack_high[THREAD_STACKSIZE_DEFAULT];
+
+static void *_low(void *arg)
+{
+    (void)arg;
+    while (1) {
+        uint32_t start = xtimer_now_usec();
+
+        while ((xtimer_now_usec() - start) < SPIN_US) {}
+        xtimer_usleep(PERIOD_US);
+    }
+    return NULL;
+}
+
+static void *_high(void *arg)
+{
+    xtimer_ticks32_t last = xtimer_now();
+
+    (void)arg;
+    while (1) {
+        xtimer_periodic_wakeup(&last, PERIOD_US);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+
+    thread_create(_stack_low, sizeof(_stack_low), THREAD_PRIORITY_MAIN + 1,
+                  THREAD_CREATE_STACKTEST, _low, NULL, "low");
+    thread_create(_stack_high, sizeof(_stack_high), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _high, NULL, "high");
+    puts("ps -l test");
+    shell_run(NULL, line_buf, SHELL_DEFAULT_BUFSIZE);
+    return 0;
+}
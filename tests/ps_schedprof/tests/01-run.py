@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 HAW Hamburg
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+HIST = r'(\s+\d+){8} \|\s+\d+ \|\s+\d+'
+
+
+def testfunc(child):
+    child.expect_exact('ps -l test')
+    child.sendline('ps -l')
+    child.expect_exact('wakeup-to-run latency (us)')
+    child.expect(r'\t  1 \| idle\s+\|' + HIST)
+    child.expect(r'\t  3 \| low\s+\|' + HIST)
+    child.expect(r'\t  4 \| high\s+\|' + HIST)
+    child.expect_exact('uninterrupted runs (us)')
+    child.expect(r'\t  3 \| low\s+\|' + HIST)
+    child.sendline('ps -c')
+    child.sendline('ps -x')
+    child.expect_exact('usage: ps [-l|-c]')
+
+
+if __name__ == "__main__":
+    sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+    from testrunner import run
+    sys.exit(run(testfunc))
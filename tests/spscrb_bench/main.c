@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   spscrb throughput benchmark
+ *
+ * Moves @ref TOTAL bytes through a tsrb and a spscrb of the same size in
+ * chunks of different sizes, checking the data on the way, and prints the
+ * throughput of each.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "spscrb.h"
+#include "tsrb.h"
+#include "xtimer.h"
+
+#define RB_SIZE         (256U)
+#define TOTAL           (256U * 1024U)
+
+static char _tsrb_buf[RB_SIZE];
+static char _spscrb_buf[RB_SIZE];
+static tsrb_t _tsrb = TSRB_INIT(_tsrb_buf);
+static spscrb_t _spscrb = SPSCRB_INIT(_spscrb_buf);
+static char _in[RB_SIZE], _out[RB_SIZE];
+
+static unsigned _move(bool spscrb, unsigned chunk)
+{
+    unsigned moved;
+
+    if (spscrb && (chunk == 1)) {
+        spscrb_add_one(&_spscrb, _in);
+        moved = (spscrb_get_one(&_spscrb, _out) == 0);
+    }
+    else if (spscrb) {
+        spscrb_add(&_spscrb, _in, chunk);
+        moved = spscrb_get(&_spscrb, _out, chunk);
+    }
+    else if (chunk == 1) {
+        tsrb_add_one(&_tsrb, _in[0]);
+        _out[0] = tsrb_get_one(&_tsrb);
+        moved = 1;
+    }
+    else {
+        tsrb_add(&_tsrb, _in, chunk);
+        moved = tsrb_get(&_tsrb, _out, chunk);
+    }
+    return moved;
+}
+
+static bool _bench(const char *name, bool spscrb, unsigned chunk)
+{
+    uint32_t start, duration;
+
+    for (unsigned i = 0; i < sizeof(_in); i++) {
+        _in[i] = (char)(i + chunk);
+    }
+    /* move by one byte, so the chunks wrap around the end of the buffer */
+    _move(spscrb, 1);
+    start = xtimer_now_usec();
+    for (unsigned done = 0; done < TOTAL; done += chunk) {
+        if (_move(spscrb, chunk) != chunk) {
+            printf("%s: lost data\n", name);
+            return false;
+        }
+    }
+    duration = xtimer_now_usec() - start;
+    if (memcmp(_in, _out, chunk) != 0) {
+        printf("%s: corrupted data\n", name);
+        return false;
+    }
+    printf("%s chunk %3u: %" PRIu32 " kB/s\n", name, chunk,
+           (uint32_t)(((uint64_t)TOTAL * US_PER_SEC) / 1024U /
+                      (duration ? duration : 1)));
+    return true;
+}
+
+int main(void)
+{
+    static const unsigned chunks[] = { 1, 16, 64 };
+
+    puts("spscrb benchmark");
+    for (unsigned i = 0; i < (sizeof(chunks) / sizeof(chunks[0])); i++) {
+        tsrb_init(&_tsrb, _tsrb_buf, sizeof(_tsrb_buf));
+        spscrb_init(&_spscrb, _spscrb_buf, sizeof(_spscrb_buf), 1);
+        if (!_bench("tsrb  ", false, chunks[i]) ||
+            !_bench("spscrb", true, chunks[i])) {
+            puts("[FAILED]");
+            return 1;
+        }
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
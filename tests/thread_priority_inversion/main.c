@@ -27,7 +27,17 @@
 #include "mutex.h"
 #include "xtimer.h"
 
+#ifdef MODULE_CORE_MUTEX_PI
+#include "mutex_pi.h"
+
+#define mutex_lock      mutex_pi_lock
+#define mutex_unlock    mutex_pi_unlock
+#define mutex_init      mutex_pi_init
+
+mutex_pi_t res_mtx;
+#else
 mutex_t res_mtx;
+#endif
 
 char stack_high[THREAD_STACKSIZE_DEFAULT];
 char stack_mid[THREAD_STACKSIZE_DEFAULT];
@@ -24,7 +24,9 @@
 #define TESTS_BLOOM_FALSE_POS_RATE_THR (0.005)
 
 static bloom_t bloom;
+static bloom_cnt_t bloom_cnt;
 BITFIELD(bf, TESTS_BLOOM_BITS);
+static uint8_t counters[TESTS_BLOOM_BITS];
 hashfp_t hashes[TESTS_BLOOM_HASHF] = {
                      (hashfp_t) fnv_hash,
                      (hashfp_t) sax_hash,
@@ -85,6 +87,77 @@ static void test_bloom_based_on_dictionary_fixture(void)
     TEST_ASSERT(false_positive_rate < TESTS_BLOOM_FALSE_POS_RATE_THR);
 }
 
+static void set_up_bloom_cnt(void)
+{
+    memset(counters, 0, sizeof(counters));
+    bloom_cnt_init(&bloom_cnt, TESTS_BLOOM_BITS, counters, hashes,
+                   TESTS_BLOOM_HASHF);
+}
+
+static void test_bloom_cnt_add_remove(void)
+{
+    const uint8_t *x = (const uint8_t *)B[0];
+    const uint8_t *y = (const uint8_t *)B[1];
+
+    TEST_ASSERT(!bloom_cnt_check(&bloom_cnt, x, strlen(B[0])));
+    bloom_cnt_add(&bloom_cnt, x, strlen(B[0]));
+    bloom_cnt_add(&bloom_cnt, y, strlen(B[1]));
+    TEST_ASSERT(bloom_cnt_check(&bloom_cnt, x, strlen(B[0])));
+    TEST_ASSERT(bloom_cnt_check(&bloom_cnt, y, strlen(B[1])));
+    bloom_cnt_remove(&bloom_cnt, x, strlen(B[0]));
+    TEST_ASSERT(bloom_cnt_check(&bloom_cnt, y, strlen(B[1])));
+    bloom_cnt_remove(&bloom_cnt, y, strlen(B[1]));
+    for (unsigned i = 0; i < TESTS_BLOOM_BITS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, counters[i]);
+    }
+}
+
+static void test_bloom_cnt_saturate(void)
+{
+    const uint8_t *x = (const uint8_t *)B[0];
+
+    for (unsigned i = 0; i <= UINT8_MAX; i++) {
+        bloom_cnt_add(&bloom_cnt, x, strlen(B[0]));
+    }
+    for (unsigned i = 0; i <= UINT8_MAX; i++) {
+        bloom_cnt_remove(&bloom_cnt, x, strlen(B[0]));
+    }
+    /* a saturated counter no longer knows how often it was incremented, so
+     * it is never decremented: x stays reported after as many removals as
+     * additions, which can only cause false positives */
+    TEST_ASSERT(bloom_cnt_check(&bloom_cnt, x, strlen(B[0])));
+}
+
+static void test_bloom_cnt_based_on_dictionary_fixture(void)
+{
+    int in = 0;
+
+    for (int i = 0; i < lenB; i++) {
+        bloom_cnt_add(&bloom_cnt, (const uint8_t *) B[i], strlen(B[i]));
+    }
+    for (int i = 0; i < lenA; i++) {
+        if (bloom_cnt_check(&bloom_cnt, (const uint8_t *) A[i], strlen(A[i]))) {
+            in++;
+        }
+    }
+
+    /* same positions as the bit-based filter, so same answers */
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_PROB_IN_FILTER, in);
+}
+
+static Test *tests_bloom_cnt_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_bloom_cnt_add_remove),
+        new_TestFixture(test_bloom_cnt_saturate),
+        new_TestFixture(test_bloom_cnt_based_on_dictionary_fixture),
+    };
+
+    EMB_UNIT_TESTCALLER(bloom_cnt_tests, set_up_bloom_cnt, NULL, fixtures);
+
+    return (Test *)&bloom_cnt_tests;
+}
+
 Test *tests_bloom_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -100,4 +173,5 @@ Test *tests_bloom_tests(void)
 void tests_bloom(void)
 {
     TESTS_RUN(tests_bloom_tests());
+    TESTS_RUN(tests_bloom_cnt_tests());
 }
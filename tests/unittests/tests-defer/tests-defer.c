@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "embUnit.h"
+
+#include "defer.h"
+
+#define TEST_FLAG   (0x1 << 3)
+
+static defer_t _defer;
+static unsigned _runs;
+static unsigned _signals;
+
+static void _handler(defer_t *defer)
+{
+    TEST_ASSERT(defer == &_defer);
+    TEST_ASSERT(defer->arg == &_runs);
+    _runs++;
+    _signals = defer->signals;
+}
+
+static void set_up(void)
+{
+    _runs = 0;
+    _signals = 0;
+    thread_flags_clear(TEST_FLAG);
+    defer_init(&_defer, _handler, &_runs, (thread_t *)sched_active_thread,
+               TEST_FLAG);
+}
+
+static void test_defer_signal_run(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, defer_run(&_defer));
+    defer_signal(&_defer);
+    TEST_ASSERT_EQUAL_INT(TEST_FLAG, thread_flags_clear(TEST_FLAG));
+    TEST_ASSERT_EQUAL_INT(1, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(1, _runs);
+    TEST_ASSERT_EQUAL_INT(1, _signals);
+    TEST_ASSERT_EQUAL_INT(0, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(1, _runs);
+}
+
+static void test_defer_coalesce(void)
+{
+    defer_signal(&_defer);
+    defer_signal(&_defer);
+    defer_signal(&_defer);
+    TEST_ASSERT_EQUAL_INT(2, _defer.coalesced);
+    TEST_ASSERT_EQUAL_INT(TEST_FLAG, thread_flags_clear(TEST_FLAG));
+    TEST_ASSERT_EQUAL_INT(1, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(0, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(1, _runs);
+    /* the one run sees all signals */
+    TEST_ASSERT_EQUAL_INT(3, _signals);
+    /* pending again after the run */
+    defer_signal(&_defer);
+    TEST_ASSERT_EQUAL_INT(2, _defer.coalesced);
+    TEST_ASSERT_EQUAL_INT(1, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(2, _runs);
+    TEST_ASSERT_EQUAL_INT(1, _signals);
+}
+
+static void test_defer_saturate(void)
+{
+    for (unsigned i = 0; i < (UINT8_MAX + 2); i++) {
+        defer_signal(&_defer);
+    }
+    TEST_ASSERT_EQUAL_INT(UINT8_MAX + 1, _defer.coalesced);
+    TEST_ASSERT_EQUAL_INT(1, defer_run(&_defer));
+    TEST_ASSERT_EQUAL_INT(UINT8_MAX, _signals);
+}
+
+static void test_defer_dropped(void)
+{
+    defer_t defer = DEFER_INIT(_handler, &_runs, TEST_FLAG);
+
+    defer_signal(&defer);
+    TEST_ASSERT_EQUAL_INT(1, defer.dropped);
+    TEST_ASSERT_EQUAL_INT(0, thread_flags_clear(TEST_FLAG));
+    TEST_ASSERT_EQUAL_INT(0, defer_run(&defer));
+    defer_set_thread(&defer, (thread_t *)sched_active_thread);
+    defer_signal(&defer);
+    TEST_ASSERT_EQUAL_INT(1, defer.dropped);
+    TEST_ASSERT_EQUAL_INT(TEST_FLAG, thread_flags_clear(TEST_FLAG));
+}
+
+Test *tests_defer_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_defer_signal_run),
+        new_TestFixture(test_defer_coalesce),
+        new_TestFixture(test_defer_saturate),
+        new_TestFixture(test_defer_dropped),
+    };
+
+    EMB_UNIT_TESTCALLER(defer_tests, set_up, NULL, fixtures);
+
+    return (Test *)&defer_tests;
+}
+
+void tests_defer(void)
+{
+    TESTS_RUN(tests_defer_tests());
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include "embUnit.h"
+#include "xtimer.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/pkttrace.h"
+
+#include "tests-gnrc_pkttrace.h"
+
+#define TEST_LATENCY    (1500U) /* in us, falls into bucket 10 */
+#define TEST_BUCKET     (10U)
+#define TEST_LAYER      (GNRC_NETTYPE_TEST)
+#define TEST_NEXT_LAYER (GNRC_NETTYPE_UNDEF)
+
+static const char data[] = "abcdefgh";
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    gnrc_pkttrace_reset();
+}
+
+static void test_gnrc_pkttrace_get__invalid(void)
+{
+    TEST_ASSERT_NULL(gnrc_pkttrace_get(GNRC_NETTYPE_IOVEC - 1));
+    TEST_ASSERT_NULL(gnrc_pkttrace_get(GNRC_NETTYPE_NUMOF));
+}
+
+static void test_gnrc_pkttrace_stamp__untraced(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, data, sizeof(data),
+                                          GNRC_NETTYPE_UNDEF);
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT(!pkt->trace.valid);
+    gnrc_pkttrace_stamp(pkt, TEST_LAYER);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pkttrace_get(TEST_LAYER)->count);
+    /* but the packet is traced from now on */
+    TEST_ASSERT(pkt->trace.valid);
+    TEST_ASSERT_EQUAL_INT(TEST_LAYER, pkt->trace.layer);
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_gnrc_pkttrace_stamp__latency(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, data, sizeof(data),
+                                          GNRC_NETTYPE_UNDEF);
+    const gnrc_pkttrace_stats_t *stats = gnrc_pkttrace_get(TEST_LAYER);
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_pkttrace_start(pkt, xtimer_now_usec() - TEST_LATENCY, TEST_LAYER);
+    gnrc_pkttrace_stamp(pkt, TEST_NEXT_LAYER);
+    /* accounted to the layer that held the packet */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pkttrace_get(TEST_NEXT_LAYER)->count);
+    TEST_ASSERT_EQUAL_INT(TEST_NEXT_LAYER, pkt->trace.layer);
+    TEST_ASSERT_EQUAL_INT(1, stats->count);
+    TEST_ASSERT(stats->max >= TEST_LATENCY);
+    TEST_ASSERT_EQUAL_INT(stats->max, stats->sum);
+    TEST_ASSERT_EQUAL_INT(1, stats->hist[TEST_BUCKET]);
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_gnrc_pkttrace_stamp__moved(void)
+{
+    gnrc_pktsnip_t *hdr = gnrc_pktbuf_add(NULL, data, sizeof(data),
+                                          GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *pkt;
+    const gnrc_pkttrace_stats_t *stats = gnrc_pkttrace_get(TEST_LAYER);
+
+    TEST_ASSERT_NOT_NULL(hdr);
+    gnrc_pkttrace_start(hdr, xtimer_now_usec(), TEST_LAYER);
+    pkt = gnrc_pktbuf_add(hdr, data, sizeof(data), GNRC_NETTYPE_UNDEF);
+    TEST_ASSERT_NOT_NULL(pkt);
+    /* the stamp moves from the header to the new first snip */
+    gnrc_pkttrace_stamp(pkt, TEST_LAYER);
+    TEST_ASSERT_EQUAL_INT(1, stats->count);
+    TEST_ASSERT(pkt->trace.valid);
+    TEST_ASSERT(!hdr->trace.valid);
+    gnrc_pkttrace_stamp(pkt, TEST_LAYER);
+    TEST_ASSERT_EQUAL_INT(2, stats->count);
+    gnrc_pkttrace_reset();
+    TEST_ASSERT_EQUAL_INT(0, stats->count);
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_gnrc_pkttrace_stamp__shared(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, data, sizeof(data),
+                                          GNRC_NETTYPE_UNDEF);
+    const gnrc_pkttrace_stats_t *stats = gnrc_pkttrace_get(TEST_LAYER);
+    uint32_t time = xtimer_now_usec() - TEST_LATENCY;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_pkttrace_start(pkt, time, TEST_LAYER);
+    /* dispatched to two receivers */
+    gnrc_pktbuf_hold(pkt, 1);
+    /* the first one passes it on, the second one still sees the stamp */
+    gnrc_pkttrace_stamp(pkt, TEST_NEXT_LAYER);
+    TEST_ASSERT_EQUAL_INT(1, stats->count);
+    TEST_ASSERT(pkt->trace.valid);
+    TEST_ASSERT_EQUAL_INT(time, pkt->trace.time);
+    TEST_ASSERT_EQUAL_INT(TEST_LAYER, pkt->trace.layer);
+    gnrc_pktbuf_release(pkt);
+    /* the second one owns it now */
+    gnrc_pkttrace_stamp(pkt, TEST_NEXT_LAYER);
+    TEST_ASSERT_EQUAL_INT(2, stats->count);
+    TEST_ASSERT_EQUAL_INT(TEST_NEXT_LAYER, pkt->trace.layer);
+    gnrc_pktbuf_release(pkt);
+}
+
+Test *tests_gnrc_pkttrace_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_pkttrace_get__invalid),
+        new_TestFixture(test_gnrc_pkttrace_stamp__untraced),
+        new_TestFixture(test_gnrc_pkttrace_stamp__latency),
+        new_TestFixture(test_gnrc_pkttrace_stamp__moved),
+        new_TestFixture(test_gnrc_pkttrace_stamp__shared),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_pkttrace_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_pkttrace_tests;
+}
+
+void tests_gnrc_pkttrace(void)
+{
+    TESTS_RUN(tests_gnrc_pkttrace_tests());
+}
+/** @} */
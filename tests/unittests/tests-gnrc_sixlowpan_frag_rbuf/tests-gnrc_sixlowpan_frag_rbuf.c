@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "msg.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/frag/stats.h"
+#include "net/sixlowpan.h"
+#include "xtimer.h"
+
+#include "rbuf.h"
+
+#define TEST_SRC        { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+#define TEST_DST        { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+#define TEST_SIZE       (96U)   /**< datagram size */
+#define TEST_FRAG_SIZE  (48U)   /**< payload of a full fragment */
+#define TEST_TAG        (0x1234U)
+
+static uint8_t _src[] = TEST_SRC;
+static uint8_t _dst[] = TEST_DST;
+
+/* adds the payload bytes [offset, offset + size) of datagram tag to the
+ * reassembly buffer, as FRAG1 with an uncompressed IPv6 dispatch for offset
+ * 0 and as FRAGN otherwise */
+static void _add(uint16_t tag, size_t datagram_size, size_t offset,
+                 size_t size)
+{
+    gnrc_pktsnip_t *netif, *frag;
+    sixlowpan_frag_n_t *hdr;
+    size_t hdr_size = (offset == 0) ? (sizeof(sixlowpan_frag_t) + 1)
+                                    : sizeof(sixlowpan_frag_n_t);
+    uint8_t *data;
+
+    netif = gnrc_netif_hdr_build(_src, sizeof(_src), _dst, sizeof(_dst));
+    TEST_ASSERT_NOT_NULL(netif);
+    frag = gnrc_pktbuf_add(netif, NULL, hdr_size + size,
+                           GNRC_NETTYPE_SIXLOWPAN);
+    TEST_ASSERT_NOT_NULL(frag);
+    hdr = frag->data;
+    data = ((uint8_t *)frag->data) + hdr_size;
+    hdr->disp_size = byteorder_htons(datagram_size);
+    hdr->tag = byteorder_htons(tag);
+    if (offset == 0) {
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+        data[-1] = SIXLOWPAN_UNCOMP;
+    }
+    else {
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+        hdr->offset = offset / 8;
+    }
+    for (unsigned i = 0; i < size; i++) {
+        data[i] = (uint8_t)(offset + i);
+    }
+    /* like gnrc_sixlowpan_frag, count the dispatch of FRAG1 to its size */
+    rbuf_add(netif->data, frag, (offset == 0) ? (size + 1) : size, offset);
+    gnrc_pktbuf_release(frag);
+}
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    memset(gnrc_sixlowpan_frag_stats_get(), 0,
+           sizeof(gnrc_sixlowpan_frag_stats_t));
+}
+
+static void tear_down(void)
+{
+    /* let all remaining datagrams time out */
+    xtimer_usleep(RBUF_TIMEOUT + 1);
+    rbuf_gc();
+}
+
+static void test_rbuf_interleaved(void)
+{
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    _add(TEST_TAG + 1, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    _add(TEST_TAG + 1, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(2, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->evictions);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->overlaps);
+}
+
+static void test_rbuf_evict_slot(void)
+{
+    for (unsigned i = 0; i <= RBUF_SIZE; i++) {
+        _add(TEST_TAG + i, TEST_SIZE, 0, TEST_FRAG_SIZE);
+        /* give every datagram its own arrival time */
+        xtimer_usleep(1000);
+    }
+    /* the first datagram made room for the last */
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->evictions);
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    TEST_ASSERT_EQUAL_INT(2, gnrc_sixlowpan_frag_stats_get()->evictions);
+    _add(TEST_TAG + RBUF_SIZE, TEST_SIZE, TEST_FRAG_SIZE,
+         TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+}
+
+static void test_rbuf_evict_budget(void)
+{
+    const unsigned numof = RBUF_BUDGET / IPV6_MIN_MTU;
+
+    for (unsigned i = 0; i <= numof; i++) {
+        _add(TEST_TAG + i, IPV6_MIN_MTU, 0, TEST_FRAG_SIZE);
+        xtimer_usleep(1000);
+    }
+    /* the first datagram made room for the last */
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->evictions);
+}
+
+static void test_rbuf_timeout(void)
+{
+    msg_t msg;
+
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, xtimer_msg_receive_timeout(&msg,
+                                                        2 * RBUF_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, msg.type);
+    rbuf_gc();
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->timeouts);
+    /* the rest of the datagram does not complete it anymore */
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->datagrams);
+}
+
+static void test_rbuf_timeout_msg_lost(void)
+{
+    msg_t msg;
+
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    /* the thread neither receives nor has a message queue, so the message of
+     * the garbage collection timer is dropped */
+    xtimer_usleep(2 * RBUF_TIMEOUT);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->timeouts);
+    /* the next datagram collects the expired one and restarts the timer */
+    _add(TEST_TAG + 1, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->timeouts);
+    TEST_ASSERT_EQUAL_INT(0, xtimer_msg_receive_timeout(&msg,
+                                                        2 * RBUF_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, msg.type);
+    rbuf_gc();
+    TEST_ASSERT_EQUAL_INT(2, gnrc_sixlowpan_frag_stats_get()->timeouts);
+}
+
+static void test_rbuf_overlap(void)
+{
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    /* partially overlaps the first fragment: restart with this fragment */
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE - 8, TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->overlaps);
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE - 8);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    _add(TEST_TAG, TEST_SIZE, (2 * TEST_FRAG_SIZE) - 8, TEST_SIZE -
+         ((2 * TEST_FRAG_SIZE) - 8));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->overlaps);
+}
+
+static void test_rbuf_out_of_order(void)
+{
+    const unsigned frag_size = TEST_SIZE / 3;
+
+    _add(TEST_TAG, TEST_SIZE, 2 * frag_size, frag_size);
+    _add(TEST_TAG, TEST_SIZE, 0, frag_size);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    _add(TEST_TAG, TEST_SIZE, frag_size, frag_size);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->overlaps);
+}
+
+static void test_rbuf_duplicate(void)
+{
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    _add(TEST_TAG + 1, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    _add(TEST_TAG + 1, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    _add(TEST_TAG + 1, TEST_SIZE, TEST_FRAG_SIZE, TEST_SIZE - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(2, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    /* the duplicate neither restarted the datagram nor was counted twice */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->overlaps);
+}
+
+static void test_rbuf_covered_offset(void)
+{
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    /* only covers received units, but starts within the first fragment */
+    _add(TEST_TAG, TEST_SIZE, 8, 16);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->overlaps);
+    /* the datagram restarted with that fragment */
+    _add(TEST_TAG, TEST_SIZE, 0, 8);
+    _add(TEST_TAG, TEST_SIZE, 24, TEST_SIZE - 24);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+}
+
+static void test_rbuf_covered_size(void)
+{
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE);
+    /* same offset as the first fragment, but shorter */
+    _add(TEST_TAG, TEST_SIZE, 0, TEST_FRAG_SIZE - 8);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->overlaps);
+    _add(TEST_TAG, TEST_SIZE, TEST_FRAG_SIZE - 8, TEST_SIZE -
+         (TEST_FRAG_SIZE - 8));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+}
+
+static void test_rbuf_last_mid_unit(void)
+{
+    /* the last fragment ends 3 bytes into its last unit */
+    const unsigned size = TEST_SIZE - 3;
+
+    _add(TEST_TAG, size, TEST_FRAG_SIZE, size - TEST_FRAG_SIZE);
+    _add(TEST_TAG, size, TEST_FRAG_SIZE, size - TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->overlaps);
+    _add(TEST_TAG, size, 0, TEST_FRAG_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_sixlowpan_frag_stats_get()->datagrams);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_stats_get()->overlaps);
+}
+
+static Test *tests_gnrc_sixlowpan_frag_rbuf_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_rbuf_interleaved),
+        new_TestFixture(test_rbuf_evict_slot),
+        new_TestFixture(test_rbuf_evict_budget),
+        new_TestFixture(test_rbuf_timeout),
+        new_TestFixture(test_rbuf_timeout_msg_lost),
+        new_TestFixture(test_rbuf_overlap),
+        new_TestFixture(test_rbuf_out_of_order),
+        new_TestFixture(test_rbuf_duplicate),
+        new_TestFixture(test_rbuf_covered_offset),
+        new_TestFixture(test_rbuf_covered_size),
+        new_TestFixture(test_rbuf_last_mid_unit),
+    };
+
+    EMB_UNIT_TESTCALLER(rbuf_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&rbuf_tests;
+}
+
+void tests_gnrc_sixlowpan_frag_rbuf(void)
+{
+    TESTS_RUN(tests_gnrc_sixlowpan_frag_rbuf_tests());
+}
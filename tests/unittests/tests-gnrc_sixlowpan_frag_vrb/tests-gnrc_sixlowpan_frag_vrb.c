@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+
+#define TEST_SRC        { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+#define TEST_OUT_DST    { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+#define TEST_SIZE       (1232U)
+#define TEST_TAG        (0x1234U)
+#define TEST_OUT_TAG    (0x0042U)
+#define TEST_OUT_NETIF  (6)
+
+static const gnrc_sixlowpan_frag_vrb_t _entry = {
+    .src = TEST_SRC,
+    .src_len = 8,
+    .out_dst = TEST_OUT_DST,
+    .out_dst_len = 8,
+    .out_netif = TEST_OUT_NETIF,
+    .datagram_size = TEST_SIZE,
+    .in_tag = TEST_TAG,
+    .out_tag = TEST_OUT_TAG,
+};
+
+static void tear_down(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    for (unsigned tag = 0; tag < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; tag++) {
+        if ((entry = gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                                 TEST_SIZE, tag)) != NULL) {
+            gnrc_sixlowpan_frag_vrb_rm(entry);
+        }
+    }
+    if ((entry = gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                             TEST_SIZE, TEST_TAG)) != NULL) {
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+    }
+}
+
+static void test_vrb_add_get(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                                 TEST_SIZE, TEST_TAG));
+    TEST_ASSERT_NOT_NULL((entry = gnrc_sixlowpan_frag_vrb_add(&_entry)));
+    TEST_ASSERT(entry == gnrc_sixlowpan_frag_vrb_get(_entry.src,
+                                                     _entry.src_len,
+                                                     TEST_SIZE, TEST_TAG));
+    TEST_ASSERT_EQUAL_INT(TEST_OUT_NETIF, entry->out_netif);
+    TEST_ASSERT_EQUAL_INT(TEST_OUT_TAG, entry->out_tag);
+    TEST_ASSERT_EQUAL_INT(8, entry->out_dst_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_entry.out_dst, entry->out_dst, 8));
+    /* the datagram is identified by source, size and tag */
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src, 2,
+                                                 TEST_SIZE, TEST_TAG));
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                                 TEST_SIZE - 8, TEST_TAG));
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                                 TEST_SIZE, TEST_TAG + 1));
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.out_dst,
+                                                 _entry.src_len,
+                                                 TEST_SIZE, TEST_TAG));
+}
+
+static void test_vrb_add_replace(void)
+{
+    gnrc_sixlowpan_frag_vrb_t entry = _entry, *res1, *res2;
+
+    TEST_ASSERT_NOT_NULL((res1 = gnrc_sixlowpan_frag_vrb_add(&_entry)));
+    entry.out_tag = TEST_OUT_TAG + 1;
+    TEST_ASSERT_NOT_NULL((res2 = gnrc_sixlowpan_frag_vrb_add(&entry)));
+    TEST_ASSERT(res1 == res2);
+    TEST_ASSERT_EQUAL_INT(TEST_OUT_TAG + 1, res2->out_tag);
+}
+
+static void test_vrb_add_full(void)
+{
+    gnrc_sixlowpan_frag_vrb_t entry = _entry;
+
+    for (unsigned tag = 0; tag < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; tag++) {
+        entry.in_tag = tag;
+        TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_add(&entry));
+    }
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_add(&_entry));
+}
+
+static void test_vrb_rm(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    TEST_ASSERT_NOT_NULL((entry = gnrc_sixlowpan_frag_vrb_add(&_entry)));
+    gnrc_sixlowpan_frag_vrb_rm(entry);
+    TEST_ASSERT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src, _entry.src_len,
+                                                 TEST_SIZE, TEST_TAG));
+}
+
+static void test_vrb_mark(void)
+{
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    TEST_ASSERT_NOT_NULL((entry = gnrc_sixlowpan_frag_vrb_add(&_entry)));
+    TEST_ASSERT(!gnrc_sixlowpan_frag_vrb_complete(entry));
+    TEST_ASSERT_EQUAL_INT(6, gnrc_sixlowpan_frag_vrb_mark(entry, 0, 48));
+    /* a duplicate is not counted again */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_vrb_mark(entry, 0, 48));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_sixlowpan_frag_vrb_mark(entry, 8, 40));
+    /* out of order, the last fragment ends in the middle of a unit */
+    TEST_ASSERT_EQUAL_INT(2, gnrc_sixlowpan_frag_vrb_mark(entry,
+                                                          TEST_SIZE - 12, 12));
+    TEST_ASSERT(!gnrc_sixlowpan_frag_vrb_complete(entry));
+    /* partial overlap only counts the new units */
+    TEST_ASSERT_EQUAL_INT(146, gnrc_sixlowpan_frag_vrb_mark(entry, 40,
+                                                            TEST_SIZE - 44));
+    TEST_ASSERT(gnrc_sixlowpan_frag_vrb_complete(entry));
+    /* re-adding resets the forwarded units */
+    TEST_ASSERT_NOT_NULL((entry = gnrc_sixlowpan_frag_vrb_add(&_entry)));
+    TEST_ASSERT_EQUAL_INT(0, entry->forwarded_numof);
+    TEST_ASSERT(!gnrc_sixlowpan_frag_vrb_complete(entry));
+}
+
+static void test_vrb_gc(void)
+{
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_add(&_entry));
+    /* a fresh entry must not time out */
+    gnrc_sixlowpan_frag_vrb_gc();
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_frag_vrb_get(_entry.src,
+                                                     _entry.src_len,
+                                                     TEST_SIZE, TEST_TAG));
+}
+
+Test *tests_gnrc_sixlowpan_frag_vrb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vrb_add_get),
+        new_TestFixture(test_vrb_add_replace),
+        new_TestFixture(test_vrb_add_full),
+        new_TestFixture(test_vrb_rm),
+        new_TestFixture(test_vrb_mark),
+        new_TestFixture(test_vrb_gc),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_sixlowpan_frag_vrb_tests, NULL, tear_down,
+                        fixtures);
+
+    return (Test *)&gnrc_sixlowpan_frag_vrb_tests;
+}
+
+void tests_gnrc_sixlowpan_frag_vrb(void)
+{
+    TESTS_RUN(tests_gnrc_sixlowpan_frag_vrb_tests());
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "xtimer.h"
+
+#define TEST_SRC_L2     { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 }
+#define TEST_DST_L2     { 0x02, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01 }
+/* link-local addresses with IIDs derived from TEST_SRC_L2 and TEST_DST_L2 */
+#define TEST_LL_SRC     { { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 } }
+#define TEST_LL_DST     { { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01 } }
+#define TEST_CTX0_SRC   { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 } }
+#define TEST_CTX0_DST   { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                            0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01 } }
+#define TEST_CTX3_SRC   { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x01, \
+                            0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 } }
+#define TEST_CTX3_DST   { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x01, \
+                            0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01 } }
+/* unicast-prefix-based multicast address (RFC 3306) of context 3 */
+#define TEST_UCP_MCAST  { { 0xff, 0x3e, 0x00, 0x40, 0x20, 0x01, 0x0d, 0xb8, \
+                            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x12, 0x34 } }
+#define TEST_PREFIX_LEN (64U)
+#define TEST_LTIME      (60U)
+#define TEST_PAYLOAD    { 0xde, 0xad, 0xbe, 0xef }
+
+/* IPHC1 with elided traffic class and flow label, inline next header and a
+ * hop limit of 64 */
+#define TEST_IPHC1      (SIXLOWPAN_IPHC1_DISP | 0x18 | 0x02)
+
+#define TEST_BENCH_PACKETS  (10000U)
+#define TEST_BENCH_FLOWS    (GNRC_SIXLOWPAN_IPHC_FLOW_NUMOF + 1)
+
+static uint8_t _src_l2[] = TEST_SRC_L2;
+static uint8_t _dst_l2[] = TEST_DST_L2;
+static const ipv6_addr_t _ll_src = TEST_LL_SRC;
+static const ipv6_addr_t _ll_dst = TEST_LL_DST;
+static const ipv6_addr_t _ctx0_src = TEST_CTX0_SRC;
+static const ipv6_addr_t _ctx0_dst = TEST_CTX0_DST;
+static const ipv6_addr_t _ctx3_src = TEST_CTX3_SRC;
+static const ipv6_addr_t _ctx3_dst = TEST_CTX3_DST;
+
+static gnrc_pktsnip_t *_build(const ipv6_addr_t *src, const ipv6_addr_t *dst)
+{
+    static const uint8_t payload[] = TEST_PAYLOAD;
+    gnrc_pktsnip_t *pkt, *netif;
+    ipv6_hdr_t *ipv6;
+
+    pkt = gnrc_pktbuf_add(NULL, payload, sizeof(payload), GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        return NULL;
+    }
+    pkt = gnrc_pktbuf_add(pkt, NULL, sizeof(ipv6_hdr_t), GNRC_NETTYPE_IPV6);
+    if (pkt == NULL) {
+        return NULL;
+    }
+    ipv6 = pkt->data;
+    memset(ipv6, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ipv6);
+    ipv6->len = byteorder_htons(sizeof(payload));
+    ipv6->nh = PROTNUM_IPV6_NONXT;
+    ipv6->hl = 64;
+    ipv6->src = *src;
+    ipv6->dst = *dst;
+    netif = gnrc_netif_hdr_build(_src_l2, sizeof(_src_l2),
+                                 _dst_l2, sizeof(_dst_l2));
+    if (netif == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    netif->next = pkt;
+    return netif;
+}
+
+/* encodes a datagram from src to dst and compares its IPHC header with exp */
+static void _test_encode(const ipv6_addr_t *src, const ipv6_addr_t *dst,
+                         const uint8_t *exp, size_t exp_len)
+{
+    gnrc_pktsnip_t *pkt;
+
+    TEST_ASSERT_NOT_NULL((pkt = _build(src, dst)));
+    TEST_ASSERT(gnrc_sixlowpan_iphc_encode(pkt));
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_SIXLOWPAN, pkt->next->type);
+    TEST_ASSERT_EQUAL_INT(exp_len, pkt->next->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, pkt->next->data, exp_len));
+    TEST_ASSERT_NOT_NULL(pkt->next->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_UNDEF, pkt->next->next->type);
+    gnrc_pktbuf_release(pkt);
+}
+
+/* the first datagram of a flow is compressed from scratch, the following ones
+ * reuse its compression if the flow is cached: both must be equal */
+static void _test_encode_flow(const ipv6_addr_t *src, const ipv6_addr_t *dst,
+                              const uint8_t *exp, size_t exp_len)
+{
+    for (unsigned i = 0; i < 3; i++) {
+        _test_encode(src, dst, exp, exp_len);
+    }
+}
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    gnrc_sixlowpan_ctx_reset();
+}
+
+static void test_iphc_encode__link_local(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, 0x33, PROTNUM_IPV6_NONXT };
+
+    _test_encode_flow(&_ll_src, &_ll_dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__ctx0(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, 0x77, PROTNUM_IPV6_NONXT };
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &_ctx0_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _test_encode_flow(&_ctx0_src, &_ctx0_dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__ctx3(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, 0xf7, 0x33,
+                                   PROTNUM_IPV6_NONXT };
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(3, &_ctx3_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _test_encode_flow(&_ctx3_src, &_ctx3_dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__mcast(void)
+{
+    static const ipv6_addr_t dst = IPV6_ADDR_ALL_NODES_LINK_LOCAL;
+    static const uint8_t exp[] = { TEST_IPHC1, 0x3b, PROTNUM_IPV6_NONXT,
+                                   0x01 };
+
+    _test_encode_flow(&_ll_src, &dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__mcast_unicast_prefix(void)
+{
+    static const ipv6_addr_t dst = TEST_UCP_MCAST;
+    /* the context ID of the destination goes into the CID extension, the
+     * next header follows it */
+    static const uint8_t exp[] = { TEST_IPHC1, 0xbc, 0x03,
+                                   PROTNUM_IPV6_NONXT,
+                                   0x3e, 0x00, 0x00, 0x00, 0x12, 0x34 };
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(3, &_ctx3_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _test_encode_flow(&_ll_src, &dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__mcast_unicast_prefix_ctx0(void)
+{
+    static const ipv6_addr_t dst = TEST_UCP_MCAST;
+    /* context 0 needs no CID extension */
+    static const uint8_t exp[] = { TEST_IPHC1, 0x3c, PROTNUM_IPV6_NONXT,
+                                   0x3e, 0x00, 0x00, 0x00, 0x12, 0x34 };
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &_ctx3_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _test_encode_flow(&_ll_src, &dst, exp, sizeof(exp));
+}
+
+/* the addresses carried inline when no context can be used */
+#define TEST_CTX0_INLINE \
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, \
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+    0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01
+
+static void test_iphc_encode__ctx_update(void)
+{
+    static const uint8_t exp_ctx[] = { TEST_IPHC1, 0x77, PROTNUM_IPV6_NONXT };
+    static const uint8_t exp_no_ctx[] = { TEST_IPHC1, 0x00,
+                                          PROTNUM_IPV6_NONXT,
+                                          TEST_CTX0_INLINE };
+
+    test_iphc_encode__ctx0();
+    /* context must not be used for compression anymore */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &_ctx0_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, false));
+    _test_encode_flow(&_ctx0_src, &_ctx0_dst, exp_no_ctx,
+                      sizeof(exp_no_ctx));
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &_ctx0_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _test_encode_flow(&_ctx0_src, &_ctx0_dst, exp_ctx, sizeof(exp_ctx));
+}
+
+static void test_iphc_encode__ctx_expired(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, 0x00, PROTNUM_IPV6_NONXT,
+                                   TEST_CTX0_INLINE };
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    test_iphc_encode__ctx0();
+    /* an expiring context loses its compression flag on its next look-up,
+     * without an update of the context buffer */
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_id(0)));
+    ctx->ltime = 0;
+    _test_encode_flow(&_ctx0_src, &_ctx0_dst, exp, sizeof(exp));
+}
+
+static void test_iphc_encode__ctx_removed(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, 0x00, PROTNUM_IPV6_NONXT,
+                                   TEST_CTX0_INLINE };
+
+    test_iphc_encode__ctx0();
+    gnrc_sixlowpan_ctx_remove(0);
+    _test_encode_flow(&_ctx0_src, &_ctx0_dst, exp, sizeof(exp));
+}
+
+/* returns the time in microseconds to build, encode and release datagrams
+ * for a round-robin of dsts_numof flows */
+static uint32_t _bench(const ipv6_addr_t *dsts, unsigned dsts_numof,
+                       bool encode)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < TEST_BENCH_PACKETS; i++) {
+        gnrc_pktsnip_t *pkt = _build(&_ctx0_src, &dsts[i % dsts_numof]);
+
+        if ((pkt == NULL) || (encode && !gnrc_sixlowpan_iphc_encode(pkt))) {
+            gnrc_pktbuf_release(pkt);
+            return UINT32_MAX;
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+    return xtimer_now_usec() - start;
+}
+
+static void test_iphc_encode__bench(void)
+{
+    ipv6_addr_t dsts[TEST_BENCH_FLOWS];
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &_ctx0_src,
+                                                   TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    for (unsigned i = 0; i < TEST_BENCH_FLOWS; i++) {
+        dsts[i] = _ctx0_dst;
+        dsts[i].u8[15] += i;
+    }
+    /* first a steady flow, then one flow more than are cached in turn, so
+     * each of them is compressed from scratch with the
+     * gnrc_sixlowpan_iphc_flow module */
+    for (unsigned flows = 1; flows <= TEST_BENCH_FLOWS;
+         flows += TEST_BENCH_FLOWS - 1) {
+        uint32_t build = _bench(dsts, flows, false);
+        uint32_t total = _bench(dsts, flows, true);
+
+        TEST_ASSERT(build != UINT32_MAX);
+        TEST_ASSERT(total != UINT32_MAX);
+        printf("\nIPHC encoding of %u datagrams in %u flows: %" PRIu32
+               " ns/datagram\n", TEST_BENCH_PACKETS, flows,
+               (uint32_t)(((uint64_t)(total - build) * 1000U) /
+                          TEST_BENCH_PACKETS));
+    }
+}
+
+static Test *tests_gnrc_sixlowpan_iphc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_iphc_encode__link_local),
+        new_TestFixture(test_iphc_encode__ctx0),
+        new_TestFixture(test_iphc_encode__ctx3),
+        new_TestFixture(test_iphc_encode__mcast),
+        new_TestFixture(test_iphc_encode__mcast_unicast_prefix),
+        new_TestFixture(test_iphc_encode__mcast_unicast_prefix_ctx0),
+        new_TestFixture(test_iphc_encode__ctx_update),
+        new_TestFixture(test_iphc_encode__ctx_expired),
+        new_TestFixture(test_iphc_encode__ctx_removed),
+        new_TestFixture(test_iphc_encode__bench),
+    };
+
+    EMB_UNIT_TESTCALLER(iphc_tests, set_up, NULL, fixtures);
+
+    return (Test *)&iphc_tests;
+}
+
+void tests_gnrc_sixlowpan_iphc(void)
+{
+    TESTS_RUN(tests_gnrc_sixlowpan_iphc_tests());
+}
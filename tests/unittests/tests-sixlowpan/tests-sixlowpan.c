@@ -147,6 +147,34 @@ static void test_sixlowpan_nalp_is_6lowpan_frame_12(void)
     TEST_ASSERT(!sixlowpan_nalp(FRAGN_DISP));
 }
 
+static void test_sixlowpan_sfr_rfrag(void)
+{
+    sixlowpan_sfr_rfrag_t hdr;
+    static const uint8_t exp[] = { 0xe8, 0x2a, 0xf4, 0x55, 0x01, 0x10 };
+
+    sixlowpan_sfr_rfrag_set(&hdr, 0x2a, 29, 0x55, 0x110, true);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, &hdr, sizeof(exp)));
+    TEST_ASSERT(sixlowpan_sfr_is(&hdr.base));
+    TEST_ASSERT(sixlowpan_sfr_rfrag_is(&hdr.base));
+    TEST_ASSERT(!sixlowpan_sfr_ack_is(&hdr.base));
+    TEST_ASSERT(!sixlowpan_frag_is((sixlowpan_frag_t *)&hdr));
+    TEST_ASSERT(sixlowpan_sfr_rfrag_ack_req(&hdr));
+    TEST_ASSERT_EQUAL_INT(29, sixlowpan_sfr_rfrag_get_seq(&hdr));
+    TEST_ASSERT_EQUAL_INT(0x55, sixlowpan_sfr_rfrag_get_frag_size(&hdr));
+    sixlowpan_sfr_rfrag_set(&hdr, 0x2a, 29, 0x55, 0x110, false);
+    TEST_ASSERT(!sixlowpan_sfr_rfrag_ack_req(&hdr));
+}
+
+static void test_sixlowpan_sfr_ack(void)
+{
+    sixlowpan_sfr_t hdr = { .disp_ecn = SIXLOWPAN_SFR_ACK_DISP |
+                                        SIXLOWPAN_SFR_ECN };
+
+    TEST_ASSERT(sixlowpan_sfr_is(&hdr));
+    TEST_ASSERT(sixlowpan_sfr_ack_is(&hdr));
+    TEST_ASSERT(!sixlowpan_sfr_rfrag_is(&hdr));
+}
+
 Test *test_sixlowpan_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -170,6 +198,8 @@ Test *test_sixlowpan_tests(void)
         new_TestFixture(test_sixlowpan_nalp_is_6lowpan_frame_10),
         new_TestFixture(test_sixlowpan_nalp_is_6lowpan_frame_11),
         new_TestFixture(test_sixlowpan_nalp_is_6lowpan_frame_12),
+        new_TestFixture(test_sixlowpan_sfr_rfrag),
+        new_TestFixture(test_sixlowpan_sfr_ack),
     };
 
     EMB_UNIT_TESTCALLER(test_sixlowpan_tests_caller, NULL, NULL, fixtures);
@@ -156,6 +156,38 @@ static void test_sixlowpan_ctx_lookup_addr__other_addr_other_prefix(void)
     TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&addr));
 }
 
+static void test_sixlowpan_ctx_lookup_addr__cached_then_update(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    uint32_t version = gnrc_sixlowpan_ctx_version();
+
+    /* cache that there is no context for addr */
+    TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&addr));
+    TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&addr));
+    /* add context DEFAULT_TEST_PREFIX to DEFAULT_TEST_ID */
+    test_sixlowpan_ctx_update__success();
+    TEST_ASSERT(version != gnrc_sixlowpan_ctx_version());
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&addr));
+}
+
+static void test_sixlowpan_ctx_lookup_addr__cached_then_remove(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    /* add context DEFAULT_TEST_PREFIX to DEFAULT_TEST_ID */
+    test_sixlowpan_ctx_update__success();
+    /* and a more specific one for the same address */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(OTHER_TEST_ID, &addr,
+                                                   DEFAULT_TEST_PREFIX_LEN + 1,
+                                                   TEST_UINT16, true));
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&addr)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | OTHER_TEST_ID, ctx->flags_id);
+    gnrc_sixlowpan_ctx_remove(OTHER_TEST_ID);
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&addr)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | DEFAULT_TEST_ID, ctx->flags_id);
+}
+
 static void test_sixlowpan_ctx_lookup_id__empty(void)
 {
     TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_id(DEFAULT_TEST_ID));
@@ -207,6 +239,8 @@ Test *tests_sixlowpan_ctx_tests(void)
         new_TestFixture(test_sixlowpan_ctx_lookup_addr__same_addr),
         new_TestFixture(test_sixlowpan_ctx_lookup_addr__other_addr_same_prefix),
         new_TestFixture(test_sixlowpan_ctx_lookup_addr__other_addr_other_prefix),
+        new_TestFixture(test_sixlowpan_ctx_lookup_addr__cached_then_update),
+        new_TestFixture(test_sixlowpan_ctx_lookup_addr__cached_then_remove),
         new_TestFixture(test_sixlowpan_ctx_lookup_id__empty),
         new_TestFixture(test_sixlowpan_ctx_lookup_id__wrong_id),
         new_TestFixture(test_sixlowpan_ctx_lookup_id__success),
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "spscrb.h"
+
+#define RB_SIZE     (8U)
+
+static uint32_t _buf[RB_SIZE];
+static spscrb_t _rb;
+
+static void set_up(void)
+{
+    memset(_buf, 0, sizeof(_buf));
+    spscrb_init(&_rb, _buf, RB_SIZE, sizeof(_buf[0]));
+}
+
+static void test_spscrb_init(void)
+{
+    spscrb_t rb = SPSCRB_INIT(_buf);
+
+    TEST_ASSERT(rb.buf == _buf);
+    TEST_ASSERT_EQUAL_INT(RB_SIZE, rb.size);
+    TEST_ASSERT_EQUAL_INT(sizeof(uint32_t), rb.elem_size);
+    TEST_ASSERT_EQUAL_INT(0, spscrb_avail(&rb));
+    TEST_ASSERT_EQUAL_INT(RB_SIZE, spscrb_free(&rb));
+}
+
+static void test_spscrb_add_get(void)
+{
+    uint32_t in[RB_SIZE + 2], out[RB_SIZE + 2];
+
+    for (unsigned i = 0; i < (RB_SIZE + 2); i++) {
+        in[i] = 0x01020304 * (i + 1);
+    }
+    TEST_ASSERT_EQUAL_INT(3, spscrb_add(&_rb, in, 3));
+    TEST_ASSERT_EQUAL_INT(3, spscrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT(RB_SIZE - 3, spscrb_free(&_rb));
+    /* only fills up the ringbuffer */
+    TEST_ASSERT_EQUAL_INT(RB_SIZE - 3, spscrb_add(&_rb, &in[3], RB_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, spscrb_free(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, spscrb_add(&_rb, in, 1));
+    TEST_ASSERT_EQUAL_INT(RB_SIZE, spscrb_get(&_rb, out, RB_SIZE + 2));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(in, out, RB_SIZE * sizeof(in[0])));
+    TEST_ASSERT_EQUAL_INT(0, spscrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, spscrb_get(&_rb, out, 1));
+}
+
+static void test_spscrb_wrap_around(void)
+{
+    uint32_t in[RB_SIZE], out[RB_SIZE];
+
+    for (unsigned i = 0; i < RB_SIZE; i++) {
+        in[i] = i + 1;
+    }
+    /* start close to the end of the buffer and of the counters */
+    atomic_store(&_rb.reads, UINT_MAX - 2);
+    atomic_store(&_rb.writes, UINT_MAX - 2);
+    for (unsigned n = 1; n <= RB_SIZE; n++) {
+        memset(out, 0, sizeof(out));
+        TEST_ASSERT_EQUAL_INT(n, spscrb_add(&_rb, in, n));
+        TEST_ASSERT_EQUAL_INT(n, spscrb_avail(&_rb));
+        TEST_ASSERT_EQUAL_INT(n, spscrb_get(&_rb, out, RB_SIZE));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(in, out, n * sizeof(in[0])));
+    }
+}
+
+static void test_spscrb_reserve_commit(void)
+{
+    uint32_t out[RB_SIZE];
+    uint32_t *window;
+    unsigned n;
+
+    spscrb_add(&_rb, out, RB_SIZE - 2);
+    spscrb_get(&_rb, out, RB_SIZE - 2);
+    /* the window ends with the buffer */
+    window = spscrb_reserve(&_rb, &n);
+    TEST_ASSERT(window == &_buf[RB_SIZE - 2]);
+    TEST_ASSERT_EQUAL_INT(2, n);
+    window[0] = 17;
+    spscrb_commit(&_rb, 1);
+    TEST_ASSERT_EQUAL_INT(1, spscrb_avail(&_rb));
+    window = spscrb_reserve(&_rb, &n);
+    TEST_ASSERT(window == &_buf[RB_SIZE - 1]);
+    TEST_ASSERT_EQUAL_INT(1, n);
+    window[0] = 42;
+    spscrb_commit(&_rb, 1);
+    window = spscrb_reserve(&_rb, &n);
+    TEST_ASSERT(window == &_buf[0]);
+    TEST_ASSERT_EQUAL_INT(RB_SIZE - 2, n);
+    spscrb_commit(&_rb, n);
+    TEST_ASSERT_NULL(spscrb_reserve(&_rb, &n));
+    TEST_ASSERT_EQUAL_INT(0, n);
+    TEST_ASSERT_EQUAL_INT(2, spscrb_get(&_rb, out, 2));
+    TEST_ASSERT_EQUAL_INT(17, out[0]);
+    TEST_ASSERT_EQUAL_INT(42, out[1]);
+}
+
+static void test_spscrb_peek_consume(void)
+{
+    uint32_t in[RB_SIZE];
+    const uint32_t *window;
+    unsigned n;
+
+    for (unsigned i = 0; i < RB_SIZE; i++) {
+        in[i] = i + 1;
+    }
+    TEST_ASSERT_NULL(spscrb_peek(&_rb, &n));
+    TEST_ASSERT_EQUAL_INT(0, n);
+    spscrb_add(&_rb, in, RB_SIZE - 1);
+    spscrb_get(&_rb, in, RB_SIZE - 1);
+    spscrb_add(&_rb, in, 3);
+    /* the window ends with the buffer */
+    window = spscrb_peek(&_rb, &n);
+    TEST_ASSERT(window == &_buf[RB_SIZE - 1]);
+    TEST_ASSERT_EQUAL_INT(1, n);
+    TEST_ASSERT_EQUAL_INT(in[0], window[0]);
+    /* nothing consumed yet */
+    TEST_ASSERT(spscrb_peek(&_rb, &n) == window);
+    spscrb_consume(&_rb, 1);
+    window = spscrb_peek(&_rb, &n);
+    TEST_ASSERT(window == &_buf[0]);
+    TEST_ASSERT_EQUAL_INT(2, n);
+    TEST_ASSERT_EQUAL_INT(in[1], window[0]);
+    TEST_ASSERT_EQUAL_INT(in[2], window[1]);
+    spscrb_consume(&_rb, 2);
+    TEST_ASSERT_EQUAL_INT(0, spscrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT(RB_SIZE, spscrb_free(&_rb));
+}
+
+Test *tests_spscrb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_spscrb_init),
+        new_TestFixture(test_spscrb_add_get),
+        new_TestFixture(test_spscrb_wrap_around),
+        new_TestFixture(test_spscrb_reserve_commit),
+        new_TestFixture(test_spscrb_peek_consume),
+    };
+
+    EMB_UNIT_TESTCALLER(spscrb_tests, set_up, NULL, fixtures);
+
+    return (Test *)&spscrb_tests;
+}
+
+void tests_spscrb(void)
+{
+    TESTS_RUN(tests_spscrb_tests());
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   xtimer and evtimer benchmark
+ *
+ * Arms @ref TIMERS_NUMOF timers with pseudo random offsets and cancels them
+ * in pseudo random order again. Then queues @ref EVENTS_NUMOF events with
+ * pseudo random offsets, looks up the remaining time of each and deletes them
+ * in pseudo random order again. All of these run with interrupts disabled, so
+ * the worst case duration of a single call bounds the interrupt latency xtimer
+ * and the event timer add.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "evtimer.h"
+#include "xtimer.h"
+
+#ifndef TIMERS_NUMOF
+#define TIMERS_NUMOF    (1000U)
+#endif
+#ifndef EVENTS_NUMOF
+#define EVENTS_NUMOF    (256U)
+#endif
+#define ROUNDS          (4U)
+/* keep all timers and events well in the future, so none is due during the
+ * test */
+#define OFFSET_MIN      (10U * US_PER_SEC)
+#define OFFSET_RANGE    (100U * US_PER_SEC)
+#define EV_OFFSET_MIN   (10U * MS_PER_SEC)
+#define EV_OFFSET_RANGE (100U * MS_PER_SEC)
+
+static xtimer_t _timers[TIMERS_NUMOF];
+static evtimer_t _evtimer;
+static evtimer_event_t _events[EVENTS_NUMOF];
+static uint16_t _order[EVENTS_NUMOF];
+static uint32_t _seed = 1;
+
+typedef struct {
+    uint32_t worst;
+    uint32_t total;
+} stat_t;
+
+static void _cb(void *arg)
+{
+    (void)arg;
+    puts("timer fired unexpectedly");
+}
+
+static void _ev_cb(evtimer_event_t *event)
+{
+    (void)event;
+    puts("event due unexpectedly");
+}
+
+/* small linear congruential generator, no need for the random module */
+static uint32_t _rand(void)
+{
+    _seed = (_seed * 1103515245U) + 12345U;
+    return _seed >> 8;
+}
+
+static void _measure(stat_t *stat, uint32_t start)
+{
+    uint32_t duration = xtimer_now_usec() - start;
+
+    stat->total += duration;
+    if (duration > stat->worst) {
+        stat->worst = duration;
+    }
+}
+
+static void _print(const char *name, const stat_t *stat, unsigned numof)
+{
+    printf("%s: worst %" PRIu32 " us, average %" PRIu32 " ns\n", name,
+           stat->worst, (uint32_t)(((uint64_t)stat->total * 1000U) /
+                                   (ROUNDS * numof)));
+}
+
+static void _bench_xtimer(void)
+{
+    stat_t set = { 0, 0 };
+    stat_t remove = { 0, 0 };
+
+    printf("xtimer benchmark with %u timers\n", TIMERS_NUMOF);
+    for (unsigned i = 0; i < TIMERS_NUMOF; i++) {
+        _timers[i].callback = _cb;
+    }
+    for (unsigned r = 0; r < ROUNDS; r++) {
+        for (unsigned i = 0; i < TIMERS_NUMOF; i++) {
+            uint32_t offset = OFFSET_MIN + (_rand() % OFFSET_RANGE);
+            uint32_t start = xtimer_now_usec();
+
+            xtimer_set(&_timers[i], offset);
+            _measure(&set, start);
+        }
+        for (unsigned i = 0; i < TIMERS_NUMOF; i++) {
+            /* a timer may be removed more than once */
+            xtimer_t *timer = &_timers[_rand() % TIMERS_NUMOF];
+            uint32_t start = xtimer_now_usec();
+
+            xtimer_remove(timer);
+            _measure(&remove, start);
+        }
+        for (unsigned i = 0; i < TIMERS_NUMOF; i++) {
+            xtimer_remove(&_timers[i]);
+        }
+    }
+    _print("xtimer_set()", &set, TIMERS_NUMOF);
+    _print("xtimer_remove()", &remove, TIMERS_NUMOF);
+}
+
+static int _bench_evtimer(void)
+{
+    stat_t add = { 0, 0 };
+    stat_t lookup = { 0, 0 };
+    stat_t del = { 0, 0 };
+
+    printf("evtimer benchmark with %u events\n", EVENTS_NUMOF);
+    evtimer_init(&_evtimer, _ev_cb);
+    for (unsigned r = 0; r < ROUNDS; r++) {
+        for (unsigned i = 0; i < EVENTS_NUMOF; i++) {
+            uint32_t start = xtimer_now_usec();
+
+            _events[i].offset = EV_OFFSET_MIN + (_rand() % EV_OFFSET_RANGE);
+            evtimer_add(&_evtimer, &_events[i]);
+            _measure(&add, start);
+        }
+        for (unsigned i = 0; i < EVENTS_NUMOF; i++) {
+            uint32_t start = xtimer_now_usec();
+            uint32_t remaining = evtimer_get_remaining(&_evtimer, &_events[i]);
+
+            _measure(&lookup, start);
+            if (remaining > (EV_OFFSET_MIN + EV_OFFSET_RANGE)) {
+                printf("event %u: unexpected remaining time %" PRIu32 "\n",
+                       i, remaining);
+                return 1;
+            }
+        }
+        for (unsigned i = 0; i < EVENTS_NUMOF; i++) {
+            _order[i] = i;
+        }
+        for (unsigned i = 0; i < EVENTS_NUMOF; i++) {
+            /* shuffle the order on the go */
+            unsigned j = i + (_rand() % (EVENTS_NUMOF - i));
+            uint16_t idx = _order[j];
+            uint32_t start = xtimer_now_usec();
+
+            evtimer_del(&_evtimer, &_events[idx]);
+            _measure(&del, start);
+            _order[j] = _order[i];
+            _order[i] = idx;
+        }
+        if (_evtimer.events != NULL) {
+            puts("events left in queue");
+            return 1;
+        }
+    }
+    _print("evtimer_add()", &add, EVENTS_NUMOF);
+    _print("evtimer_get_remaining()", &lookup, EVENTS_NUMOF);
+    _print("evtimer_del()", &del, EVENTS_NUMOF);
+    return 0;
+}
+
+int main(void)
+{
+    _bench_xtimer();
+    if (_bench_evtimer() != 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 HAW Hamburg
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+
+def testfunc(child):
+    child.expect(r"xtimer_set\(\): worst \d+ us, average \d+ ns", timeout=120)
+    child.expect(r"xtimer_remove\(\): worst \d+ us, average \d+ ns")
+    child.expect(r"evtimer_add\(\): worst \d+ us, average \d+ ns", timeout=120)
+    child.expect(r"evtimer_get_remaining\(\): worst \d+ us, average \d+ ns")
+    child.expect(r"evtimer_del\(\): worst \d+ us, average \d+ ns")
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+    from testrunner import run
+    sys.exit(run(testfunc))
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   xtimer_tickless test application
+ *
+ * Sleeps a couple of times and checks that each sleep took exactly one
+ * low-level timer interrupt. With a 32 bit wide low-level timer, there must be
+ * no other interrupts. If the counter wraps during the test, the period tick
+ * must have been merged into the interrupt of the sleep that crossed the
+ * wrap. On native the counter starts shortly before its wrap, see the
+ * Makefile.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "ps.h"
+#include "sched.h"
+#include "xtimer.h"
+
+#define SLEEPS      (20U)
+#define SLEEP_US    (10U * US_PER_MS)
+
+int main(void)
+{
+    xtimer_wakeups_t before, after;
+    uint32_t idle_before = sched_idle_wakeups;
+    uint64_t start, last;
+    uint32_t to_wrap;
+    int res = 1;
+
+    puts("xtimer_tickless test");
+    xtimer_get_wakeups(&before);
+    start = last = xtimer_now64().ticks64;
+    to_wrap = UINT32_MAX - (uint32_t)start;
+    for (unsigned i = 0; i < SLEEPS; i++) {
+        xtimer_usleep(SLEEP_US);
+
+        uint64_t now = xtimer_now64().ticks64;
+        if ((now - last) < xtimer_ticks_from_usec(SLEEP_US).ticks32) {
+            printf("sleep %u woke up early\n", i);
+            res = 0;
+        }
+        last = now;
+    }
+    xtimer_get_wakeups(&after);
+
+    unsigned wraps = (unsigned)((last >> 32) - (start >> 32));
+    printf("timer wakeups: %" PRIu32 ", period wakeups: %" PRIu32
+           ", skipped ticks: %" PRIu32 ", idle wakeups: %" PRIu32
+           ", counter wraps: %u\n", after.timer - before.timer,
+           after.period - before.period, after.skipped - before.skipped,
+           sched_idle_wakeups - idle_before, wraps);
+    if ((after.timer - before.timer) != SLEEPS) {
+        res = 0;
+    }
+    if ((to_wrap < xtimer_ticks_from_usec(SLEEPS * SLEEP_US).ticks32) && (wraps != 1)) {
+        /* the sleeps lasted longer than the time up to the wrap */
+        res = 0;
+    }
+#if XTIMER_WIDTH == 32
+    if ((after.period != before.period) ||
+        ((after.skipped - before.skipped) != wraps)) {
+        res = 0;
+    }
+#endif
+    ps();
+    puts(res ? "[SUCCESS]" : "[FAILED]");
+    return 0;
+}